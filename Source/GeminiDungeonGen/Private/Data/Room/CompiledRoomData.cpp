@@ -0,0 +1,624 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Data/Room/CompiledRoomData.h"
+#include "Data/Room/RoomData.h"
+#include "Data/Room/FloorData.h"
+#include "Data/Room/WallData.h"
+#include "Data/Room/DoorData.h"
+#include "Data/Room/CeilingData.h"
+#include "DungeonGen/Doors/Doorway.h"
+#include "Engine/StaticMesh.h"
+#include "Algo/StableSort.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace CompiledRoomData
+{
+	static uint32 ToIntegerWeight(float Weight)
+	{
+		return (uint32)FMath::RoundToInt(FMath::Clamp(Weight, 0.0f, 10.0f) * FCompiledRoomData::WeightScale);
+	}
+
+	// Stop a load at the first corrupt value: every later read is a no-op, so nothing past it is misread
+	static bool Reject(FArchive& Ar)
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	// Weight tables are stored as their cumulative sums; a loaded table must be non-decreasing and match its pool
+	static bool SerializeWeights(FArchive& Ar, FCompiledWeightTable& Table, int32 ExpectedNum)
+	{
+		Ar << Table.Cumulative;
+		if (Ar.IsLoading())
+		{
+			if (Table.Cumulative.Num() != ExpectedNum) return Reject(Ar);
+			for (int32 i = 1; i < Table.Cumulative.Num(); ++i)
+			{
+				if (Table.Cumulative[i] < Table.Cumulative[i - 1]) return Reject(Ar);
+			}
+		}
+		return true;
+	}
+
+	static void SerializePath(FArchive& Ar, FSoftObjectPath& Path)
+	{
+		FString PathString = Path.ToString();
+		Ar << PathString;
+		if (Ar.IsLoading())
+		{
+			Path.SetPath(PathString);
+		}
+	}
+
+	// Per-instance custom data: up to 255 floats
+	static void SerializeCustomData(FArchive& Ar, TArray<float>& CustomData)
+	{
+		uint8 NumCustomData = (uint8)FMath::Min(CustomData.Num(), (int32)MAX_uint8);
+		Ar << NumCustomData;
+		if (Ar.IsLoading())
+		{
+			CustomData.SetNum(NumCustomData);
+		}
+		for (int32 i = 0; i < NumCustomData; ++i)
+		{
+			Ar << CustomData[i];
+		}
+	}
+}
+
+FCompiledDoorFrame FCompiledDoorFrame::FromDoorData(UDoorData* DoorData)
+{
+	FCompiledDoorFrame Frame;
+	if (!DoorData) return Frame;
+
+	Frame.FrameMesh = DoorData->FrameSideMesh.LoadSynchronous();
+	Frame.DoorwayClass = DoorData->DoorwayClass.Get();
+	Frame.DoorData = DoorData;
+	Frame.Footprint = FMath::Clamp(DoorData->FrameFootprintY, 1, (int32)MAX_uint8);
+	Frame.RotationOffset = DoorData->FrameRotationOffset;
+	Frame.ConnectionBoxExtent = DoorData->ConnectionBoxExtent;
+	return Frame;
+}
+
+// ==================================================================================
+// SELECTION
+// ==================================================================================
+
+int32 FCompiledWeightTable::Select(FRandomStream& Stream, int32 NumEntries) const
+{
+	const int32 Count = NumEntries == INDEX_NONE ? Cumulative.Num() : FMath::Min(NumEntries, Cumulative.Num());
+	if (Count <= 0) return INDEX_NONE;
+
+	const uint32 Total = Cumulative[Count - 1];
+	if (Total == 0)
+	{
+		return Stream.RandRange(0, Count - 1);	// All weights zero - uniform
+	}
+
+	// First entry whose running sum exceeds the roll (zero-weight entries can never be picked)
+	const uint32 Roll = (uint32)Stream.RandRange(0, (int32)Total - 1);
+	return Algo::UpperBound(TConstArrayView<uint32>(Cumulative.GetData(), Count), Roll);
+}
+
+// ==================================================================================
+// COMPILE
+// ==================================================================================
+
+void FCompiledRoomData::Reset()
+{
+	GridSize = FIntPoint::ZeroValue;
+	Meshes.Reset();
+	FloorTiles = FCompiledMeshPool();
+	Clutter = FCompiledMeshPool();
+	ClutterPlacementChance = 0.0f;
+	ClutterMinSpacing = 0.0f;
+	ClutterCullDistance = 0.0f;
+	FillerMeshIndex = INDEX_NONE;
+	Interior = FCompiledMeshPool();
+	InteriorFillRatio = 0.0f;
+	InteriorDoorClearance = 1;
+	InteriorMaxAttempts = 0;
+	WallModules.Reset();
+	WallFillOrder.Reset();
+	WallFillFootprints.Reset();
+	WallHeight = 0.0f;
+	NorthWallOffset = 0.0f;
+	SouthWallOffset = 0.0f;
+	EastWallOffset = 0.0f;
+	WestWallOffset = 0.0f;
+	CornerMeshIndex = INDEX_NONE;
+	for (FVector& Offset : CornerOffsets)
+	{
+		Offset = FVector::ZeroVector;
+	}
+	DoorPoolIndices.Reset();
+	DoorFootprints.Reset();
+	DoorFrames.Reset();
+	DoorWeights = FCompiledWeightTable();
+	LargeCeilingTiles = FCompiledTilePool();
+	SmallCeilingTiles = FCompiledTilePool();
+	CeilingHeight = 0.0f;
+	CeilingRotation = FRotator::ZeroRotator;
+	MeshLookup.Reset();
+}
+
+uint16 FCompiledRoomData::AddMesh(const FSoftObjectPath& Path)
+{
+	if (const uint16* Existing = MeshLookup.Find(Path))
+	{
+		return *Existing;
+	}
+
+	check(Meshes.Num() < MAX_uint16);
+	const uint16 Index = (uint16)Meshes.Add(Path);
+	MeshLookup.Add(Path, Index);
+	return Index;
+}
+
+int32 FCompiledRoomData::AddOptionalMesh(const TSoftObjectPtr<UStaticMesh>& Mesh)
+{
+	return Mesh.IsNull() ? INDEX_NONE : AddMesh(Mesh.ToSoftObjectPath());
+}
+
+void FCompiledRoomData::CompileMeshPool(const TArray<FMeshPlacementInfo>& Source, const TCHAR* PoolName, FCompiledMeshPool& OutPool, TArray<FString>& OutErrors)
+{
+	for (int32 i = 0; i < Source.Num(); ++i)
+	{
+		const FMeshPlacementInfo& Info = Source[i];
+
+		if (Info.MeshAsset.IsNull())
+		{
+			OutErrors.Add(FString::Printf(TEXT("%s[%d]: no mesh assigned"), PoolName, i));
+			continue;
+		}
+		if (Info.GridFootprint.X < 1 || Info.GridFootprint.Y < 1 || Info.GridFootprint.X > MAX_uint8 || Info.GridFootprint.Y > MAX_uint8)
+		{
+			OutErrors.Add(FString::Printf(TEXT("%s[%d]: footprint %s is out of range (1-255 cells)"), PoolName, i, *Info.GridFootprint.ToString()));
+			continue;
+		}
+		if (Info.AllowedRotations.Num() == 0)
+		{
+			OutErrors.Add(FString::Printf(TEXT("%s[%d]: AllowedRotations is empty"), PoolName, i));
+			continue;
+		}
+
+		FCompiledMeshEntry Entry;
+		Entry.MeshIndex = AddMesh(Info.MeshAsset.ToSoftObjectPath());
+		Entry.FootprintX = (uint8)Info.GridFootprint.X;
+		Entry.FootprintY = (uint8)Info.GridFootprint.Y;
+		Entry.NumQuadrants = 0;
+		Entry.CustomData = Info.CustomData;
+
+		// Rotations become a list of unique yaw quadrants (the layout can only store multiples of 90 anyway)
+		bool bValidRotations = true;
+		for (int32 Rotation : Info.AllowedRotations)
+		{
+			const int32 Normalized = ((Rotation % 360) + 360) % 360;
+			if (Normalized % 90 != 0)
+			{
+				OutErrors.Add(FString::Printf(TEXT("%s[%d]: rotation %d is not a multiple of 90"), PoolName, i, Rotation));
+				bValidRotations = false;
+				break;
+			}
+
+			const uint8 Quadrant = (uint8)(Normalized / 90);
+			bool bKnown = false;
+			for (int32 q = 0; q < Entry.NumQuadrants; ++q)
+			{
+				bKnown |= Entry.Quadrants[q] == Quadrant;
+			}
+			if (!bKnown)
+			{
+				Entry.Quadrants[Entry.NumQuadrants++] = Quadrant;
+			}
+		}
+		if (!bValidRotations) continue;
+
+		OutPool.Entries.Add(MoveTemp(Entry));
+		OutPool.Weights.Add(CompiledRoomData::ToIntegerWeight(Info.PlacementWeight));
+	}
+}
+
+void FCompiledRoomData::CompileTilePool(const TArray<FCeilingTile>& Source, const TCHAR* PoolName, FCompiledTilePool& OutPool, TArray<FString>& OutErrors)
+{
+	for (int32 i = 0; i < Source.Num(); ++i)
+	{
+		const FCeilingTile& Tile = Source[i];
+		if (Tile.Mesh.IsNull())
+		{
+			OutErrors.Add(FString::Printf(TEXT("%s[%d]: no mesh assigned"), PoolName, i));
+			continue;
+		}
+
+		OutPool.MeshIndices.Add(AddMesh(Tile.Mesh.ToSoftObjectPath()));
+		OutPool.Weights.Add(CompiledRoomData::ToIntegerWeight(Tile.PlacementWeight));
+	}
+}
+
+void FCompiledRoomData::Compile(const URoomData* RoomData, TArray<FString>& OutErrors)
+{
+	Reset();
+	if (!RoomData) return;
+
+	GridSize = RoomData->GridSize;
+	if (GridSize.X < 1 || GridSize.Y < 1 || GridSize.X > MAX_uint16 || GridSize.Y > MAX_uint16)
+	{
+		OutErrors.Add(FString::Printf(TEXT("GridSize %s is out of range"), *GridSize.ToString()));
+	}
+
+	// --- Floor ---
+	if (const UFloorData* FloorData = RoomData->FloorStyleData.LoadSynchronous())
+	{
+		CompileMeshPool(FloorData->FloorTilePool, TEXT("FloorTilePool"), FloorTiles, OutErrors);
+		CompileMeshPool(FloorData->ClutterMeshPool, TEXT("ClutterMeshPool"), Clutter, OutErrors);
+		ClutterPlacementChance = FMath::Clamp(FloorData->ClutterPlacementChance, 0.0f, 1.0f);
+		ClutterMinSpacing = FMath::Max(FloorData->ClutterMinSpacing, 0.0f);
+		ClutterCullDistance = FMath::Max(FloorData->ClutterCullDistance, 0.0f);
+		if (!FloorData->DefaultFillerTile.IsNull())
+		{
+			FillerMeshIndex = AddMesh(FloorData->DefaultFillerTile.ToSoftObjectPath());
+		}
+	}
+	else
+	{
+		OutErrors.Add(TEXT("FloorStyleData is not set"));
+	}
+
+	// --- Interior ---
+	CompileMeshPool(RoomData->InteriorMeshPool, TEXT("InteriorMeshPool"), Interior, OutErrors);
+	InteriorFillRatio = FMath::Clamp(RoomData->InteriorFillRatio, 0.0f, 1.0f);
+	InteriorDoorClearance = FMath::Clamp(RoomData->InteriorDoorClearance, 1, 16);
+	InteriorMaxAttempts = FMath::Max(RoomData->MaxInteriorPlacementAttempts, 0);
+
+	// --- Walls (largest footprint first, so the greedy filler takes the first module that fits) ---
+	// Rejected modules keep their slot without a BaseMesh, so layout wall records still index the asset order
+	if (const UWallData* WallData = RoomData->WallStyleData.LoadSynchronous())
+	{
+		for (int32 i = 0; i < WallData->AvailableWallModules.Num(); ++i)
+		{
+			const FWallModule& Module = WallData->AvailableWallModules[i];
+			FCompiledWallModuleData& Data = WallModules.AddDefaulted_GetRef();
+			if (Module.Y_AxisFootprint < 1 || Module.Y_AxisFootprint > MAX_uint8)
+			{
+				OutErrors.Add(FString::Printf(TEXT("AvailableWallModules[%d]: footprint %d is out of range (1-255 cells)"), i, Module.Y_AxisFootprint));
+				continue;
+			}
+			Data.Footprint = (uint8)Module.Y_AxisFootprint;
+			if (Module.BaseMesh.IsNull())
+			{
+				OutErrors.Add(FString::Printf(TEXT("AvailableWallModules[%d]: no BaseMesh assigned"), i));
+				continue;
+			}
+			Data.BaseMesh = AddMesh(Module.BaseMesh.ToSoftObjectPath());
+			Data.Middle1Mesh = AddOptionalMesh(Module.Middle1Mesh);
+			Data.Middle2Mesh = AddOptionalMesh(Module.Middle2Mesh);
+			Data.TopMesh = AddOptionalMesh(Module.TopMesh);
+			Data.CustomData = Module.CustomData;
+			WallFillOrder.Add((uint16)i);
+		}
+
+		Algo::StableSortBy(WallFillOrder, [this](uint16 Index) { return -(int32)WallModules[Index].Footprint; });
+		for (uint16 Index : WallFillOrder)
+		{
+			WallFillFootprints.Add(WallModules[Index].Footprint);
+		}
+
+		WallHeight = WallData->WallHeight;
+		NorthWallOffset = WallData->NorthWallOffsetX;
+		SouthWallOffset = WallData->SouthWallOffsetX;
+		EastWallOffset = WallData->EastWallOffsetY;
+		WestWallOffset = WallData->WestWallOffsetY;
+
+		// --- Corners ---
+		CornerMeshIndex = AddOptionalMesh(WallData->DefaultCornerMesh);
+		CornerOffsets[0] = WallData->SouthWestCornerOffset;
+		CornerOffsets[1] = WallData->SouthEastCornerOffset;
+		CornerOffsets[2] = WallData->NorthEastCornerOffset;
+		CornerOffsets[3] = WallData->NorthWestCornerOffset;
+	}
+
+	// --- Doors (smallest footprint first, so the doors fitting a gap are a prefix) ---
+	if (const UDoorData* DoorStyle = RoomData->DoorStyleData.LoadSynchronous())
+	{
+		struct FDoorEntry
+		{
+			int32 PoolIndex;
+			uint8 Footprint;
+			uint32 Weight;
+			FCompiledDoorFrameData Frame;
+		};
+		TArray<FDoorEntry> Doors;
+
+		auto CompileFrame = [this](const UDoorData& Door)
+		{
+			FCompiledDoorFrameData Frame;
+			Frame.FrameMesh = AddOptionalMesh(Door.FrameSideMesh);
+			Frame.RotationOffset = Door.FrameRotationOffset;
+			Frame.ConnectionBoxExtent = Door.ConnectionBoxExtent;
+			Frame.DoorwayClass = FSoftClassPath(Door.DoorwayClass.Get());
+			Frame.DoorData = FSoftObjectPath(&Door);
+			return Frame;
+		};
+
+		if (DoorStyle->DoorStylePool.Num() == 0)
+		{
+			// Single door mode: the door style itself is the only candidate
+			Doors.Add({ INDEX_NONE, (uint8)FMath::Clamp(DoorStyle->FrameFootprintY, 1, (int32)MAX_uint8), 1, CompileFrame(*DoorStyle) });
+		}
+		for (int32 i = 0; i < DoorStyle->DoorStylePool.Num(); ++i)
+		{
+			const UDoorData* PoolDoor = DoorStyle->DoorStylePool[i];
+			if (!PoolDoor)
+			{
+				OutErrors.Add(FString::Printf(TEXT("DoorStylePool[%d]: entry is empty"), i));
+				continue;
+			}
+			Doors.Add({ i, (uint8)FMath::Clamp(PoolDoor->FrameFootprintY, 1, (int32)MAX_uint8), CompiledRoomData::ToIntegerWeight(PoolDoor->PlacementWeight), CompileFrame(*PoolDoor) });
+		}
+
+		Algo::StableSortBy(Doors, &FDoorEntry::Footprint);
+		for (FDoorEntry& Door : Doors)
+		{
+			DoorPoolIndices.Add(Door.PoolIndex);
+			DoorFootprints.Add(Door.Footprint);
+			DoorFrames.Add(MoveTemp(Door.Frame));
+			DoorWeights.Add(Door.Weight);
+		}
+	}
+
+	// --- Ceiling ---
+	if (const UCeilingData* CeilingData = RoomData->CeilingStyleData.LoadSynchronous())
+	{
+		CompileTilePool(CeilingData->LargeTilePool, TEXT("LargeTilePool"), LargeCeilingTiles, OutErrors);
+		CompileTilePool(CeilingData->SmallTilePool, TEXT("SmallTilePool"), SmallCeilingTiles, OutErrors);
+		CeilingHeight = CeilingData->CeilingHeight;
+		CeilingRotation = CeilingData->CeilingRotation;
+	}
+
+	MeshLookup.Reset();
+}
+
+// ==================================================================================
+// SERIALIZATION
+// ==================================================================================
+
+bool FCompiledRoomData::Serialize(FArchive& Ar)
+{
+	// --- Header ---
+	uint32 FileMagic = Magic;
+	uint16 FileVersion = Version;
+	Ar << FileMagic;
+	Ar << FileVersion;
+	if (Ar.IsLoading() && (FileMagic != Magic || FileVersion != Version))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("CompiledRoomData: Rejecting blob (magic %08x, version %d, expected version %d)"),
+			FileMagic, FileVersion, Version);
+		Ar.SetError();
+		return false;
+	}
+
+	uint16 SizeX = (uint16)GridSize.X;
+	uint16 SizeY = (uint16)GridSize.Y;
+	Ar << SizeX;
+	Ar << SizeY;
+	GridSize = FIntPoint(SizeX, SizeY);
+
+	// --- Mesh Table ---
+	uint16 NumMeshes = (uint16)Meshes.Num();
+	Ar << NumMeshes;
+	if (Ar.IsLoading())
+	{
+		Meshes.SetNum(NumMeshes);
+	}
+	for (FSoftObjectPath& Mesh : Meshes)
+	{
+		CompiledRoomData::SerializePath(Ar, Mesh);
+	}
+
+	auto SerializeMeshIndex = [&Ar, NumMeshes](uint16& MeshIndex)
+	{
+		Ar << MeshIndex;
+		return !Ar.IsLoading() || MeshIndex < NumMeshes;
+	};
+
+	// Optional mesh references (INDEX_NONE = none)
+	auto SerializeOptionalMeshIndex = [&Ar, NumMeshes](int32& MeshIndex)
+	{
+		Ar << MeshIndex;
+		return !Ar.IsLoading() || MeshIndex == INDEX_NONE || (MeshIndex >= 0 && MeshIndex < NumMeshes);
+	};
+
+	// --- Grid Pools: mesh, footprint, quadrant list (count + 2 bits each), custom data ---
+	auto SerializeMeshPool = [&](FCompiledMeshPool& Pool)
+	{
+		int32 NumEntries = Pool.Entries.Num();
+		Ar << NumEntries;
+		if (Ar.IsLoading())
+		{
+			if (NumEntries < 0 || NumEntries > MAX_uint16) return CompiledRoomData::Reject(Ar);
+			Pool.Entries.SetNum(NumEntries);
+		}
+		for (FCompiledMeshEntry& Entry : Pool.Entries)
+		{
+			if (!SerializeMeshIndex(Entry.MeshIndex)) return CompiledRoomData::Reject(Ar);
+			Ar << Entry.FootprintX;
+			Ar << Entry.FootprintY;
+			if (Ar.IsLoading() && (Entry.FootprintX < 1 || Entry.FootprintY < 1)) return CompiledRoomData::Reject(Ar);
+
+			uint8 PackedQuadrants = 0;
+			for (int32 q = 0; q < Entry.NumQuadrants; ++q)
+			{
+				PackedQuadrants |= (Entry.Quadrants[q] & 0x3) << (q * 2);
+			}
+			Ar << Entry.NumQuadrants;
+			Ar << PackedQuadrants;
+			if (Ar.IsLoading() && (Entry.NumQuadrants < 1 || Entry.NumQuadrants > 4)) return CompiledRoomData::Reject(Ar);
+			for (int32 q = 0; q < Entry.NumQuadrants; ++q)
+			{
+				Entry.Quadrants[q] = (PackedQuadrants >> (q * 2)) & 0x3;
+			}
+
+			CompiledRoomData::SerializeCustomData(Ar, Entry.CustomData);
+		}
+		return CompiledRoomData::SerializeWeights(Ar, Pool.Weights, Pool.Entries.Num());
+	};
+
+	auto SerializeTilePool = [&](FCompiledTilePool& Pool)
+	{
+		Ar << Pool.MeshIndices;
+		for (uint16& MeshIndex : Pool.MeshIndices)
+		{
+			if (Ar.IsLoading() && MeshIndex >= NumMeshes) return CompiledRoomData::Reject(Ar);
+		}
+		return CompiledRoomData::SerializeWeights(Ar, Pool.Weights, Pool.MeshIndices.Num());
+	};
+
+	// --- Floor / Interior ---
+	bool bValid = SerializeMeshPool(FloorTiles) && SerializeMeshPool(Clutter) && SerializeMeshPool(Interior);
+	Ar << ClutterPlacementChance;
+	Ar << ClutterMinSpacing;
+	Ar << ClutterCullDistance;
+	Ar << InteriorFillRatio;
+	Ar << InteriorDoorClearance;
+	Ar << InteriorMaxAttempts;
+	bValid &= SerializeOptionalMeshIndex(FillerMeshIndex);
+
+	// --- Walls: module stacks, then the fill order (which must only pick modules with a base mesh) ---
+	int32 NumWallModules = WallModules.Num();
+	Ar << NumWallModules;
+	if (Ar.IsLoading())
+	{
+		if (NumWallModules < 0 || NumWallModules > MAX_uint16)
+		{
+			Ar.SetError();
+			return false;
+		}
+		WallModules.SetNum(NumWallModules);
+	}
+	for (FCompiledWallModuleData& Module : WallModules)
+	{
+		bValid &= SerializeOptionalMeshIndex(Module.BaseMesh);
+		bValid &= SerializeOptionalMeshIndex(Module.Middle1Mesh);
+		bValid &= SerializeOptionalMeshIndex(Module.Middle2Mesh);
+		bValid &= SerializeOptionalMeshIndex(Module.TopMesh);
+		Ar << Module.Footprint;
+		bValid &= Module.Footprint >= 1;
+		CompiledRoomData::SerializeCustomData(Ar, Module.CustomData);
+	}
+
+	Ar << WallFillOrder;
+	Ar << WallFillFootprints;
+	bValid &= WallFillOrder.Num() == WallFillFootprints.Num();
+	for (int32 i = 0; i < WallFillOrder.Num() && bValid; ++i)
+	{
+		bValid &= WallModules.IsValidIndex(WallFillOrder[i]) && WallModules[WallFillOrder[i]].BaseMesh != INDEX_NONE
+			&& WallModules[WallFillOrder[i]].Footprint == WallFillFootprints[i];
+	}
+	Ar << WallHeight;
+	Ar << NorthWallOffset;
+	Ar << SouthWallOffset;
+	Ar << EastWallOffset;
+	Ar << WestWallOffset;
+
+	// --- Corners ---
+	bValid &= SerializeOptionalMeshIndex(CornerMeshIndex);
+	for (FVector& Offset : CornerOffsets)
+	{
+		Ar << Offset;
+	}
+
+	// --- Doors: footprints ascending (GetNumDoorsFitting), one frame per door ---
+	Ar << DoorPoolIndices;
+	Ar << DoorFootprints;
+	bValid &= DoorPoolIndices.Num() == DoorFootprints.Num();
+	for (int32 i = 0; i < DoorPoolIndices.Num() && bValid; ++i)
+	{
+		bValid &= DoorPoolIndices[i] >= INDEX_NONE && DoorFootprints[i] >= 1 && (i == 0 || DoorFootprints[i] >= DoorFootprints[i - 1]);
+	}
+
+	int32 NumDoorFrames = DoorFrames.Num();
+	Ar << NumDoorFrames;
+	if (Ar.IsLoading())
+	{
+		if (NumDoorFrames != DoorPoolIndices.Num())
+		{
+			Ar.SetError();
+			return false;
+		}
+		DoorFrames.SetNum(NumDoorFrames);
+	}
+	for (FCompiledDoorFrameData& Frame : DoorFrames)
+	{
+		bValid &= SerializeOptionalMeshIndex(Frame.FrameMesh);
+		Ar << Frame.RotationOffset;
+		Ar << Frame.ConnectionBoxExtent;
+		CompiledRoomData::SerializePath(Ar, Frame.DoorwayClass);
+		CompiledRoomData::SerializePath(Ar, Frame.DoorData);
+	}
+	bValid &= CompiledRoomData::SerializeWeights(Ar, DoorWeights, DoorPoolIndices.Num());
+
+	// --- Ceiling ---
+	bValid &= SerializeTilePool(LargeCeilingTiles) && SerializeTilePool(SmallCeilingTiles);
+	Ar << CeilingHeight;
+	Ar << CeilingRotation;
+
+	if (!bValid)
+	{
+		Ar.SetError();
+	}
+	return !Ar.IsError();
+}
+
+void FCompiledRoomData::Encode(TArray<uint8>& OutBytes) const
+{
+	OutBytes.Reset();
+	FMemoryWriter Writer(OutBytes);
+	const_cast<FCompiledRoomData*>(this)->Serialize(Writer);
+}
+
+bool FCompiledRoomData::Decode(const TArray<uint8>& Bytes)
+{
+	FMemoryReader Reader(Bytes);
+	return Serialize(Reader) && !Reader.IsError();
+}
+
+void FCompiledRoomData::ResolveMeshes(TArray<UStaticMesh*>& OutMeshes) const
+{
+	OutMeshes.SetNum(Meshes.Num());
+	for (int32 i = 0; i < Meshes.Num(); ++i)
+	{
+		OutMeshes[i] = Cast<UStaticMesh>(Meshes[i].TryLoad());
+		if (!OutMeshes[i])
+		{
+			UE_LOG(LogTemp, Warning, TEXT("CompiledRoomData: Mesh %s failed to load - entries using it are skipped"), *Meshes[i].ToString());
+		}
+	}
+}
+
+SIZE_T FCompiledRoomData::GetAllocatedSize() const
+{
+	auto GetPoolSize = [](const FCompiledMeshPool& Pool)
+	{
+		SIZE_T Size = Pool.Entries.GetAllocatedSize() + Pool.Weights.Cumulative.GetAllocatedSize();
+		for (const FCompiledMeshEntry& Entry : Pool.Entries)
+		{
+			Size += Entry.CustomData.GetAllocatedSize();
+		}
+		return Size;
+	};
+
+	SIZE_T WallModuleSize = WallModules.GetAllocatedSize();
+	for (const FCompiledWallModuleData& Module : WallModules)
+	{
+		WallModuleSize += Module.CustomData.GetAllocatedSize();
+	}
+
+	return Meshes.GetAllocatedSize() + GetPoolSize(FloorTiles) + GetPoolSize(Clutter) + GetPoolSize(Interior)
+		+ WallModuleSize + WallFillOrder.GetAllocatedSize() + WallFillFootprints.GetAllocatedSize()
+		+ DoorPoolIndices.GetAllocatedSize() + DoorFootprints.GetAllocatedSize() + DoorFrames.GetAllocatedSize()
+		+ DoorWeights.Cumulative.GetAllocatedSize()
+		+ LargeCeilingTiles.MeshIndices.GetAllocatedSize() + LargeCeilingTiles.Weights.Cumulative.GetAllocatedSize()
+		+ SmallCeilingTiles.MeshIndices.GetAllocatedSize() + SmallCeilingTiles.Weights.Cumulative.GetAllocatedSize();
+}
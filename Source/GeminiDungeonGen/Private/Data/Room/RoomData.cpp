@@ -2,4 +2,182 @@
 
 
 #include "Data/Room/RoomData.h"
+#include "Data/Room/DoorData.h"
+#include "Engine/StaticMesh.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/UObjectGlobals.h"
+#include "Misc/DataValidation.h"
 
+const FCompiledRoomData& URoomData::GetCompiledData()
+{
+	GetCompiledTables();
+
+	// Meshes load on first use, never inside PostLoad (no blocking loads while the asset itself loads)
+	if (!bHasResolvedMeshes)
+	{
+		CompiledData.ResolveMeshes(CompiledMeshes);
+		bHasResolvedMeshes = true;
+		bHasResolvedDoorFrames = false;	// Frames resolved before the meshes have no FrameMesh yet
+	}
+	return CompiledData;
+}
+
+const FCompiledDoorFrame* URoomData::GetCompiledDoorFrame(int32 PoolIndex)
+{
+	GetCompiledTables();
+	if (!bHasResolvedDoorFrames)
+	{
+		ResolveDoorFrames();
+		bHasResolvedDoorFrames = true;
+	}
+
+	const int32 Index = CompiledData.FindDoor(PoolIndex);
+	return CompiledDoorFrames.IsValidIndex(Index) ? &CompiledDoorFrames[Index] : nullptr;
+}
+
+const FCompiledRoomData& URoomData::GetCompiledTables()
+{
+	// Packaged builds decode the cooked blob in PostLoad; otherwise compile once and keep it until invalidated
+	if (!bHasCompiledData)
+	{
+		TArray<FString> Errors;
+		CompiledData.Compile(this, Errors);
+		for (const FString& Error : Errors)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("RoomData %s: %s (entry skipped)"), *GetName(), *Error);
+		}
+		bHasCompiledData = true;
+		bHasResolvedMeshes = false;
+		bHasResolvedDoorFrames = false;
+	}
+	return CompiledData;
+}
+
+void URoomData::ResolveDoorFrames()
+{
+	CompiledDoorFrames.SetNum(CompiledData.DoorFrames.Num());
+	CompiledDoorAssets.Reset();
+	for (int32 i = 0; i < CompiledData.DoorFrames.Num(); ++i)
+	{
+		const FCompiledDoorFrameData& Source = CompiledData.DoorFrames[i];
+		FCompiledDoorFrame& Frame = CompiledDoorFrames[i];
+		Frame.FrameMesh = bHasResolvedMeshes ? GetCompiledMesh(Source.FrameMesh) : nullptr;
+		Frame.DoorwayClass = Source.DoorwayClass.IsNull() ? nullptr : Source.DoorwayClass.TryLoadClass<UObject>();
+		Frame.DoorData = Cast<UDoorData>(Source.DoorData.TryLoad());
+		Frame.Footprint = CompiledData.DoorFootprints[i];
+		Frame.RotationOffset = Source.RotationOffset;
+		Frame.ConnectionBoxExtent = Source.ConnectionBoxExtent;
+		if (!Frame.DoorData)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("RoomData %s: Door %s failed to load - doors using it are skipped"), *GetName(), *Source.DoorData.ToString());
+		}
+
+		CompiledDoorAssets.Add(Frame.DoorwayClass);
+		CompiledDoorAssets.Add(Frame.DoorData);
+	}
+}
+
+void URoomData::InvalidateCompiledData()
+{
+	// The cooked tables never change at runtime
+	if (FPlatformProperties::RequiresCookedData()) return;
+
+	bHasCompiledData = false;
+	bHasResolvedMeshes = false;
+	bHasResolvedDoorFrames = false;
+}
+
+void URoomData::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+
+	CompiledBlob.Reset();
+	if (!ObjectSaveContext.IsCooking()) return;
+
+	// Cook step: validate and flatten. Invalid entries fail the cook instead of surfacing in the shipped game.
+	FCompiledRoomData CookedData;
+	TArray<FString> Errors;
+	CookedData.Compile(this, Errors);
+	for (const FString& Error : Errors)
+	{
+		UE_LOG(LogTemp, Error, TEXT("RoomData %s: %s"), *GetPathName(), *Error);
+	}
+	if (Errors.Num() > 0)
+	{
+		UE_LOG(LogTemp, Fatal, TEXT("RoomData %s: %d compile error(s) - fix the asset (see Data Validation) before cooking"), *GetPathName(), Errors.Num());
+	}
+
+	CookedData.Encode(CompiledBlob);
+	UE_LOG(LogTemp, Log, TEXT("RoomData %s: Compiled blob %d bytes (%d meshes)"), *GetName(), CompiledBlob.Num(), CookedData.Meshes.Num());
+}
+
+void URoomData::PostLoad()
+{
+	Super::PostLoad();
+
+	if (CompiledBlob.Num() == 0) return;
+
+	if (CompiledData.Decode(CompiledBlob))
+	{
+		// Meshes are resolved by the first GetCompiledData
+		bHasCompiledData = true;
+		bHasResolvedMeshes = false;
+		bHasResolvedDoorFrames = false;
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("RoomData %s: Compiled blob is unreadable - recompiling from the style assets"), *GetName());
+		CompiledData.Reset();
+	}
+
+	// The blob is only needed until it's decoded
+	CompiledBlob.Empty();
+}
+
+#if WITH_EDITOR
+void URoomData::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &URoomData::OnObjectPropertyChanged);
+	}
+}
+
+void URoomData::BeginDestroy()
+{
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+	Super::BeginDestroy();
+}
+
+void URoomData::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	InvalidateCompiledData();
+}
+
+void URoomData::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// Only data assets feed the compiler - edits to actors (a room being dragged, its preview) keep the cache
+	if (Object != this && Object && Object->IsA<UDataAsset>())
+	{
+		InvalidateCompiledData();
+	}
+}
+
+EDataValidationResult URoomData::IsDataValid(FDataValidationContext& Context) const
+{
+	EDataValidationResult Result = Super::IsDataValid(Context);
+
+	FCompiledRoomData ValidationData;
+	TArray<FString> Errors;
+	ValidationData.Compile(this, Errors);
+	for (const FString& Error : Errors)
+	{
+		Context.AddError(FText::FromString(Error));
+	}
+
+	return Errors.Num() > 0 ? EDataValidationResult::Invalid : Result;
+}
+#endif
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Data/Room/RoomShapeMask.h"
+
+void FRoomShapeMask::Init(FIntPoint InGridSize)
+{
+	GridSize = FIntPoint(FMath::Max(InGridSize.X, 0), FMath::Max(InGridSize.Y, 0));
+	Bits.Init(false, GridSize.X * GridSize.Y);
+}
+
+void FRoomShapeMask::AddRowSpan(int32 Y, int32 MinX, int32 MaxX)
+{
+	if (Y < 0 || Y >= GridSize.Y) return;
+
+	MinX = FMath::Max(MinX, 0);
+	MaxX = FMath::Min(MaxX, GridSize.X - 1);
+	if (MinX > MaxX) return;
+
+	// Ranged set - whole words at a time
+	Bits.SetRange(Y * GridSize.X + MinX, MaxX - MinX + 1, true);
+}
+
+void FRoomShapeMask::AddRegion(const FForcedEmptyRegion& Region)
+{
+	const int32 MinX = FMath::Min(Region.StartCell.X, Region.EndCell.X);
+	const int32 MaxX = FMath::Max(Region.StartCell.X, Region.EndCell.X);
+	const int32 MinY = FMath::Max(FMath::Min(Region.StartCell.Y, Region.EndCell.Y), 0);
+	const int32 MaxY = FMath::Min(FMath::Max(Region.StartCell.Y, Region.EndCell.Y), GridSize.Y - 1);
+
+	// A region spanning full rows is one contiguous bit range
+	if (MinX <= 0 && MaxX >= GridSize.X - 1)
+	{
+		if (MinY <= MaxY)
+		{
+			Bits.SetRange(MinY * GridSize.X, (MaxY - MinY + 1) * GridSize.X, true);
+		}
+		return;
+	}
+
+	for (int32 Y = MinY; Y <= MaxY; ++Y)
+	{
+		AddRowSpan(Y, MinX, MaxX);
+	}
+}
+
+void FRoomShapeMask::AddCell(const FIntPoint& Cell)
+{
+	if (Cell.X >= 0 && Cell.X < GridSize.X && Cell.Y >= 0 && Cell.Y < GridSize.Y)
+	{
+		Bits[Cell.Y * GridSize.X + Cell.X] = true;
+	}
+}
+
+void FRoomShapeMask::Combine(const FRoomShapeMask& Other)
+{
+	if (Other.GridSize != GridSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RoomShapeMask: Cannot combine a %s mask into a %s mask"), *Other.GridSize.ToString(), *GridSize.ToString());
+		return;
+	}
+
+	Bits.CombineWithBitwiseOR(Other.Bits, EBitwiseOperatorFlags::MaintainSize);
+}
+
+void FRoomShapeMask::GetCells(TArray<FIntPoint>& OutCells) const
+{
+	if (GridSize.X <= 0) return;
+
+	OutCells.Reserve(OutCells.Num() + CountSetCells());
+	for (TConstSetBitIterator<> It(Bits); It; ++It)
+	{
+		const int32 Index = It.GetIndex();
+		OutCells.Emplace(Index % GridSize.X, Index / GridSize.X);
+	}
+}
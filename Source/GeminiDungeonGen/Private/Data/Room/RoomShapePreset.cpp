@@ -1,4 +1,106 @@
-﻿// Fill out your copyright notice in the Description page of Project Settings.
+// Fill out your copyright notice in the Description page of Project Settings.
 
 
 #include "Data/Room/RoomShapePreset.h"
+
+const FRoomShapeMask& URoomShapePreset::GetShapeMask(FIntPoint GridSize) const
+{
+	check(IsInGameThread());
+
+	if (const FRoomShapeMask* Cached = CachedMasks.Find(GridSize))
+	{
+		return *Cached;
+	}
+
+	FRoomShapeMask& Mask = CachedMasks.Add(GridSize);
+	BuildShapeMask(GridSize, Mask);
+
+	UE_LOG(LogTemp, Log, TEXT("RoomShapePreset %s: Built %s mask (%d empty cells)"),
+		*GetName(), *GridSize.ToString(), Mask.CountSetCells());
+	return Mask;
+}
+
+void URoomShapePreset::BuildShapeMask(FIntPoint GridSize, FRoomShapeMask& OutMask) const
+{
+	OutMask.Init(GridSize);
+
+	if (bAnalyticShape && IsAnalyticShapeType(ShapeType))
+	{
+		RasterizeAnalyticShape(OutMask);
+	}
+
+	for (const FForcedEmptyRegion& Region : EmptyRegions)
+	{
+		OutMask.AddRegion(Region);
+	}
+	for (const FIntPoint& Cell : EmptyCells)
+	{
+		OutMask.AddCell(Cell);
+	}
+}
+
+void URoomShapePreset::RasterizeAnalyticShape(FRoomShapeMask& OutMask) const
+{
+	const FIntPoint GridSize = OutMask.GridSize;
+	if (GridSize.X <= 0 || GridSize.Y <= 0) return;
+
+	const float Cut = FMath::Clamp(CornerCut, 0.05f, 1.0f);
+
+	// Shapes are defined in normalized room space: U along X (South 0 -> North 1), V along Y (West 0 -> East 1).
+	// For each row (fixed V) the inside is one U interval; a cell is inside if its centre is.
+	for (int32 Y = 0; Y < GridSize.Y; ++Y)
+	{
+		// Distance of the row centre from the East/West centre line (0 at the middle, 1 at the edges)
+		const float B = FMath::Abs(2.0f * (Y + 0.5f) / GridSize.Y - 1.0f);
+
+		// Inside interval in U for this row
+		float MinU = 0.0f;
+		float MaxU = 1.0f;
+		switch (ShapeType)
+		{
+		case ERoomShapeType::Triangle:
+			MaxU = 1.0f - B;	// Base on the South edge (U = 0)
+			break;
+		case ERoomShapeType::Diamond:
+			MinU = 0.5f * B;	// |2U - 1| <= 1 - B
+			MaxU = 1.0f - 0.5f * B;
+			break;
+		case ERoomShapeType::Hexagon:
+		{
+			const float A = FMath::Min(1.0f, (1.0f - B) / Cut);	// Full height until the last Cut of the half width
+			MinU = 0.5f * (1.0f - A);
+			MaxU = 0.5f * (1.0f + A);
+			break;
+		}
+		case ERoomShapeType::Octagon:
+		{
+			const float A = FMath::Min(1.0f, 2.0f - Cut - B);	// Corner cuts: |2U - 1| + B <= 2 - Cut
+			MinU = 0.5f * (1.0f - A);
+			MaxU = 0.5f * (1.0f + A);
+			break;
+		}
+		default:
+			return;
+		}
+
+		// Cells whose centre U = (X + 0.5) / GridSize.X lies in [MinU, MaxU] (epsilon keeps exact edges inside)
+		const int32 FirstX = FMath::CeilToInt(MinU * GridSize.X - 0.5f - KINDA_SMALL_NUMBER);
+		const int32 LastX = FMath::FloorToInt(MaxU * GridSize.X - 0.5f + KINDA_SMALL_NUMBER);
+
+		if (FirstX > LastX)
+		{
+			OutMask.AddRowSpan(Y, 0, GridSize.X - 1);
+			continue;
+		}
+		OutMask.AddRowSpan(Y, 0, FirstX - 1);
+		OutMask.AddRowSpan(Y, LastX + 1, GridSize.X - 1);
+	}
+}
+
+#if WITH_EDITOR
+void URoomShapePreset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	InvalidateShapeMasks();
+}
+#endif
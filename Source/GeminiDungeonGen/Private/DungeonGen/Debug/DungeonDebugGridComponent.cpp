@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Debug/DungeonDebugGridComponent.h"
+#include "Hash/CityHash.h"
+
+UDungeonDebugGridComponent::UDungeonDebugGridComponent()
+{
+	// Lines are permanent (negative lifetime), so there is nothing to age
+	PrimaryComponentTick.bCanEverTick = false;
+	
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetCanEverAffectNavigation(false);
+	SetGenerateOverlapEvents(false);
+	bHiddenInGame = true;
+	CastShadow = false;
+}
+
+void UDungeonDebugGridComponent::SetGrid(const FIntPoint& GridSize, TConstArrayView<EGridCellType> CellStates,
+	TConstArrayView<FIntPoint> RegionCells, TConstArrayView<FIntPoint> ForcedCells, TConstArrayView<FBox> WallOutlines)
+{
+	uint64 Hash = CityHash64(reinterpret_cast<const char*>(&GridSize), sizeof(GridSize));
+	Hash = CityHash64WithSeed(reinterpret_cast<const char*>(CellStates.GetData()), CellStates.Num() * sizeof(EGridCellType), Hash);
+	Hash = CityHash64WithSeed(reinterpret_cast<const char*>(RegionCells.GetData()), RegionCells.Num() * sizeof(FIntPoint), Hash);
+	Hash = CityHash64WithSeed(reinterpret_cast<const char*>(ForcedCells.GetData()), ForcedCells.Num() * sizeof(FIntPoint), Hash ^ RegionCells.Num());
+	for (const FBox& Outline : WallOutlines)
+	{
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(&Outline.Min), sizeof(FVector), Hash);
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(&Outline.Max), sizeof(FVector), Hash);
+	}
+	Hash = FMath::Max<uint64>(Hash, 1);
+	
+	if (Hash == GridHash) return;
+	GridHash = Hash;
+	
+	LocalLines.Reset();
+	
+	// 1. Grid lines (green)
+	for (int32 X = 0; X <= GridSize.X; ++X)
+	{
+		LocalLines.Emplace(FVector(X * CELL_SIZE, 0.0f, 0.0f), FVector(X * CELL_SIZE, GridSize.Y * CELL_SIZE, 0.0f),
+			FLinearColor::Green, -1.0f, 5.0f, SDPG_World);
+	}
+	for (int32 Y = 0; Y <= GridSize.Y; ++Y)
+	{
+		LocalLines.Emplace(FVector(0.0f, Y * CELL_SIZE, 0.0f), FVector(GridSize.X * CELL_SIZE, Y * CELL_SIZE, 0.0f),
+			FLinearColor::Green, -1.0f, 5.0f, SDPG_World);
+	}
+	
+	auto CellCenter = [](const FIntPoint& Cell, float Z)
+	{
+		return FVector((Cell.X + 0.5f) * CELL_SIZE, (Cell.Y + 0.5f) * CELL_SIZE, Z);
+	};
+	
+	// 2. Forced empty regions (cyan, lifted above the state boxes)
+	const FVector ForcedExtent(CELL_SIZE / 2.2f, CELL_SIZE / 2.2f, 25.0f);
+	for (const FIntPoint& Cell : RegionCells)
+	{
+		AddLocalBox(CellCenter(Cell, 40.0f), ForcedExtent, FLinearColor(FColor::Cyan), 4.0f);
+	}
+	
+	// 3. Individual forced empty cells (cyan with an orange border)
+	for (const FIntPoint& Cell : ForcedCells)
+	{
+		AddLocalBox(CellCenter(Cell, 40.0f), ForcedExtent, FLinearColor(FColor::Cyan), 4.0f);
+		AddLocalBox(CellCenter(Cell, 40.0f), FVector(CELL_SIZE / 2.0f, CELL_SIZE / 2.0f, 27.0f), FLinearColor(FColor::Orange), 2.0f);
+	}
+	
+	// 4. Cell state boxes (red = occupied, blue = empty)
+	const FVector StateExtent(CELL_SIZE / 2.0f, CELL_SIZE / 2.0f, 20.0f);
+	for (int32 Y = 0; Y < GridSize.Y; ++Y)
+	{
+		for (int32 X = 0; X < GridSize.X; ++X)
+		{
+			const int32 Index = Y * GridSize.X + X;
+			if (!CellStates.IsValidIndex(Index)) continue;
+			
+			const FLinearColor Color = CellStates[Index] != EGridCellType::ECT_Empty ? FLinearColor::Red : FLinearColor::Blue;
+			AddLocalBox(CellCenter(FIntPoint(X, Y), 20.0f), StateExtent, Color, 3.0f);
+		}
+	}
+	
+	// 5. Wall outlines (yellow)
+	for (const FBox& Outline : WallOutlines)
+	{
+		AddLocalBox(Outline.GetCenter(), Outline.GetExtent(), FLinearColor::Yellow, 3.0f);
+	}
+	
+	UploadLines();
+}
+
+void UDungeonDebugGridComponent::ClearGrid()
+{
+	LocalLines.Reset();
+	GridHash = 0;
+	Flush();
+}
+
+void UDungeonDebugGridComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(LocalLines.GetAllocatedSize() + BatchedLines.GetAllocatedSize());
+}
+
+void UDungeonDebugGridComponent::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+	UploadLines();
+}
+
+void UDungeonDebugGridComponent::AddLocalBox(const FVector& Center, const FVector& Extent, const FLinearColor& Color, float Thickness)
+{
+	const FVector Min = Center - Extent;
+	const FVector Max = Center + Extent;
+	const FVector Corners[8] =
+	{
+		FVector(Min.X, Min.Y, Min.Z), FVector(Max.X, Min.Y, Min.Z), FVector(Max.X, Max.Y, Min.Z), FVector(Min.X, Max.Y, Min.Z),
+		FVector(Min.X, Min.Y, Max.Z), FVector(Max.X, Min.Y, Max.Z), FVector(Max.X, Max.Y, Max.Z), FVector(Min.X, Max.Y, Max.Z)
+	};
+	
+	// Bottom ring, top ring, verticals
+	for (int32 i = 0; i < 4; ++i)
+	{
+		LocalLines.Emplace(Corners[i], Corners[(i + 1) % 4], Color, -1.0f, Thickness, SDPG_World);
+		LocalLines.Emplace(Corners[4 + i], Corners[4 + (i + 1) % 4], Color, -1.0f, Thickness, SDPG_World);
+		LocalLines.Emplace(Corners[i], Corners[4 + i], Color, -1.0f, Thickness, SDPG_World);
+	}
+}
+
+void UDungeonDebugGridComponent::UploadLines()
+{
+	Flush();
+	if (LocalLines.Num() == 0) return;
+	
+	const FTransform& LocalToWorld = GetComponentTransform();
+	TArray<FBatchedLine> WorldLines(LocalLines);
+	for (FBatchedLine& Line : WorldLines)
+	{
+		Line.Start = LocalToWorld.TransformPosition(Line.Start);
+		Line.End = LocalToWorld.TransformPosition(Line.End);
+	}
+	DrawLines(WorldLines);
+}
@@ -2,13 +2,30 @@
 
 
 #include "GeminiDungeonGen/Public/DungeonGen/Doors/Doorway.h"
+#include "Net/UnrealNetwork.h"
 
 
 // Sets default values
 ADoorway::ADoorway()
 {
-	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	// Ticks only while the door animates - idle doors cost nothing per frame
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	
+	// Spawned by the server from the doorway pool and replicated to clients
+	bReplicates = true;
+	
+	// Pooled doorways are moved between rooms, so the transform must follow them
+	SetReplicatingMovement(true);
+	
+	// Dormant until interacted with - SetDoorState flushes dormancy for a single update
+	NetDormancy = DORM_DormantAll;
+}
+
+void ADoorway::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(ADoorway, PackedDoorState);
 }
 
 // Called when the game starts or when spawned
@@ -16,11 +33,145 @@ void ADoorway::BeginPlay()
 {
 	Super::BeginPlay();
 	
+	// Snap to the initial state (late joiners receive the current state with the initial bunch)
+	OpenAlpha = IsDoorOpen() ? 1.0f : 0.0f;
+	OnDoorAnimationUpdate(OpenAlpha);
 }
 
-// Called every frame
+// Only enabled while animating
 void ADoorway::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+	
+	const float Target = IsDoorOpen() ? 1.0f : 0.0f;
+	const float Step = OpenDuration > 0.0f ? DeltaTime / OpenDuration : 1.0f;
+	OpenAlpha = FMath::Clamp(OpenAlpha + FMath::Sign(Target - OpenAlpha) * Step, 0.0f, 1.0f);
+	if (FMath::Abs(Target - OpenAlpha) <= Step)
+	{
+		OpenAlpha = Target;
+	}
+	
+	OnDoorAnimationUpdate(OpenAlpha);
+	
+	// Animation finished - back to tickless
+	if (OpenAlpha == Target)
+	{
+		SetDoorAnimating(false);
+	}
+}
+
+// ==================================================================================
+// DOOR STATE
+// ==================================================================================
+
+bool ADoorway::Interact(AActor* InteractionInstigator)
+{
+	if (!HasAuthority() || IsInPool()) return false;
+	
+	if (IsDoorLocked())
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("%s: Interaction by %s refused (locked)"), *GetName(), *GetNameSafe(InteractionInstigator));
+		return false;
+	}
+	
+	SetDoorOpen(!IsDoorOpen());
+	return true;
+}
+
+void ADoorway::SetDoorOpen(bool bOpen)
+{
+	EDoorwayStateFlags NewState = (EDoorwayStateFlags)PackedDoorState;
+	if (bOpen)
+	{
+		EnumAddFlags(NewState, EDoorwayStateFlags::Open);
+	}
+	else
+	{
+		EnumRemoveFlags(NewState, EDoorwayStateFlags::Open);
+	}
+	SetDoorState(NewState);
+}
+
+void ADoorway::SetDoorLocked(bool bLocked)
+{
+	EDoorwayStateFlags NewState = (EDoorwayStateFlags)PackedDoorState;
+	if (bLocked)
+	{
+		EnumAddFlags(NewState, EDoorwayStateFlags::Locked);
+	}
+	else
+	{
+		EnumRemoveFlags(NewState, EDoorwayStateFlags::Locked);
+	}
+	SetDoorState(NewState);
+}
+
+void ADoorway::SetDoorState(EDoorwayStateFlags NewState)
+{
+	if (!HasAuthority() || (uint8)NewState == PackedDoorState) return;
+	
+	// Wake for exactly one replication update - the actor drops back to dormant afterwards
+	FlushNetDormancy();
+	
+	const EDoorwayStateFlags PreviousState = (EDoorwayStateFlags)PackedDoorState;
+	PackedDoorState = (uint8)NewState;
+	ApplyDoorState(PreviousState);
+}
+
+void ADoorway::OnRep_DoorState(uint8 PreviousState)
+{
+	ApplyDoorState((EDoorwayStateFlags)PreviousState);
+}
+
+void ADoorway::ApplyDoorState(EDoorwayStateFlags PreviousState)
+{
+	const EDoorwayStateFlags State = (EDoorwayStateFlags)PackedDoorState;
+	const bool bPooled = EnumHasAnyFlags(State, EDoorwayStateFlags::Pooled);
+	const bool bWasPooled = EnumHasAnyFlags(PreviousState, EDoorwayStateFlags::Pooled);
+	
+	if (bPooled != bWasPooled)
+	{
+		// Collision isn't replicated by the engine - the pooled bit drives it on every machine
+		SetActorHiddenInGame(bPooled);
+		SetActorEnableCollision(!bPooled);
+	}
+	
+	if (bPooled)
+	{
+		SetDoorAnimating(false);
+	}
+	else if (bWasPooled)
+	{
+		// Reused from the pool - snap, don't animate from the previous room's state
+		OpenAlpha = IsDoorOpen() ? 1.0f : 0.0f;
+		OnDoorAnimationUpdate(OpenAlpha);
+	}
+	else if (EnumHasAnyFlags(State ^ PreviousState, EDoorwayStateFlags::Open))
+	{
+		SetDoorAnimating(true);
+	}
+	
+	OnDoorStateChanged(IsDoorOpen(), IsDoorLocked());
+}
+
+void ADoorway::SetDoorAnimating(bool bAnimating)
+{
+	SetActorTickEnabled(bAnimating);
 }
 
+// ==================================================================================
+// POOLING
+// ==================================================================================
+
+void ADoorway::ActivateFromPool()
+{
+	// Fresh door: closed, unlocked, active
+	SetDoorState(EDoorwayStateFlags::None);
+	OnActivatedFromPool();
+}
+
+void ADoorway::ReturnToPool()
+{
+	SetDoorState(EDoorwayStateFlags::Pooled);
+	OnReturnedToPool();
+}
@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Doors/DoorwayPool.h"
+#include "DungeonGen/Doors/Doorway.h"
+#include "DungeonGen/Stats/DungeonMemory.h"
+#include "Engine/World.h"
+
+bool UDoorwayPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDoorwayPoolSubsystem::Deinitialize()
+{
+	// The world tears its actors down itself - just drop our references
+	Buckets.Empty();
+	Super::Deinitialize();
+}
+
+void UDoorwayPoolSubsystem::AcquireDoorways(const TArray<FDoorwaySpawnRequest>& Requests, AActor* Owner, TArray<ADoorway*>& OutDoorways)
+{
+	if (Requests.Num() == 0) return;
+
+	LLM_SCOPE_BYTAG(DungeonGen);
+
+	const int32 FirstIndex = OutDoorways.Num();
+	OutDoorways.AddZeroed(Requests.Num());
+
+	// PASS 1: Reuse pooled doorways (no spawn cost - just a transform and an activation)
+	TArray<int32> SpawnIndices;
+	for (int32 i = 0; i < Requests.Num(); ++i)
+	{
+		const FDoorwaySpawnRequest& Request = Requests[i];
+		if (!Request.DoorwayClass) continue;
+
+		ADoorway* Doorway = nullptr;
+		if (FDoorwayPoolBucket* Bucket = Buckets.Find(Request.DoorwayClass))
+		{
+			while (!Doorway && Bucket->FreeDoorways.Num() > 0)
+			{
+				Doorway = Bucket->FreeDoorways.Pop(EAllowShrinking::No);
+				if (!IsValid(Doorway)) Doorway = nullptr;	// Destroyed externally while pooled
+			}
+		}
+
+		if (Doorway)
+		{
+			Doorway->SetOwner(Owner);
+			Doorway->SetActorTransform(Request.Transform, false, nullptr, ETeleportType::TeleportPhysics);
+			Doorway->ActivateFromPool();
+			OutDoorways[FirstIndex + i] = Doorway;
+		}
+		else
+		{
+			SpawnIndices.Add(i);
+		}
+	}
+
+	if (SpawnIndices.Num() == 0) return;
+
+	// PASS 2: Spawn the shortfall deferred, then finish construction for the whole batch
+	for (int32 i : SpawnIndices)
+	{
+		OutDoorways[FirstIndex + i] = SpawnDeferredDoorway(Requests[i].DoorwayClass, Requests[i].Transform, Owner);
+	}
+
+	for (int32 i : SpawnIndices)
+	{
+		if (ADoorway* Doorway = OutDoorways[FirstIndex + i])
+		{
+			Doorway->FinishSpawning(Requests[i].Transform);
+			Doorway->ActivateFromPool();
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("DoorwayPool: %d doorways acquired (%d reused, %d spawned)"),
+		Requests.Num(), Requests.Num() - SpawnIndices.Num(), SpawnIndices.Num());
+}
+
+void UDoorwayPoolSubsystem::ReleaseDoorways(TArray<ADoorway*>& Doorways)
+{
+	for (ADoorway* Doorway : Doorways)
+	{
+		if (!IsValid(Doorway)) continue;
+
+		Doorway->ReturnToPool();
+		Doorway->SetOwner(nullptr);
+		Buckets.FindOrAdd(Doorway->GetClass()).FreeDoorways.Add(Doorway);
+	}
+	Doorways.Reset();
+}
+
+void UDoorwayPoolSubsystem::PrewarmPool(TSubclassOf<ADoorway> DoorwayClass, int32 Count)
+{
+	if (!DoorwayClass || Count <= 0) return;
+
+	LLM_SCOPE_BYTAG(DungeonGen);
+
+	FDoorwayPoolBucket& Bucket = Buckets.FindOrAdd(DoorwayClass);
+	Bucket.FreeDoorways.Reserve(Bucket.FreeDoorways.Num() + Count);
+
+	const FTransform ParkingTransform = FTransform::Identity;
+	for (int32 i = 0; i < Count; ++i)
+	{
+		if (ADoorway* Doorway = SpawnDeferredDoorway(DoorwayClass, ParkingTransform, nullptr))
+		{
+			Doorway->FinishSpawning(ParkingTransform);
+			Doorway->ReturnToPool();
+			Bucket.FreeDoorways.Add(Doorway);
+		}
+	}
+}
+
+int32 UDoorwayPoolSubsystem::GetNumFreeDoorways(TSubclassOf<ADoorway> DoorwayClass) const
+{
+	const FDoorwayPoolBucket* Bucket = Buckets.Find(DoorwayClass);
+	return Bucket ? Bucket->FreeDoorways.Num() : 0;
+}
+
+ADoorway* UDoorwayPoolSubsystem::SpawnDeferredDoorway(UClass* DoorwayClass, const FTransform& Transform, AActor* Owner)
+{
+	UWorld* World = GetWorld();
+	if (!World || !DoorwayClass) return nullptr;
+
+	ADoorway* Doorway = World->SpawnActorDeferred<ADoorway>(DoorwayClass, Transform, Owner, nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!Doorway)
+	{
+		UE_LOG(LogTemp, Error, TEXT("DoorwayPool: Failed to spawn %s"), *DoorwayClass->GetName());
+	}
+	return Doorway;
+}
@@ -0,0 +1,197 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Instances/DungeonInstanceManager.h"
+#include "DungeonGen/Stats/DungeonMemory.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+
+UDungeonInstanceManager::UDungeonInstanceManager()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UDungeonInstanceManager::AddInstances(UStaticMesh* Mesh, const FDungeonInstanceSettings& Settings, TConstArrayView<FTransform> WorldTransforms,
+	TConstArrayView<float> CustomData, int32 NumCustomData, TArray<FDungeonInstanceHandle>& OutHandles)
+{
+	if (!Mesh || WorldTransforms.Num() == 0) return;
+	check(CustomData.Num() == WorldTransforms.Num() * NumCustomData);
+	
+	LLM_SCOPE_BYTAG(DungeonGen_Instances);
+	
+	// --- Group by chunk ---
+	// Input index lists per bucket, so each HISM gets one AddInstances call
+	FBucketKey Key;
+	Key.Mesh = Mesh;
+	Key.NumCustomData = NumCustomData;
+	Key.Flags = (Settings.bCollision ? 0x1 : 0x0) | (Settings.bAffectNavigation ? 0x2 : 0x0);
+	Key.CullDistance = Settings.CullDistance;
+	
+	TMap<int32, TArray<int32>> InputsPerBucket;
+	for (int32 i = 0; i < WorldTransforms.Num(); ++i)
+	{
+		const FVector Location = WorldTransforms[i].GetLocation();
+		Key.Chunk = FIntPoint(FMath::FloorToInt(Location.X / ChunkSize), FMath::FloorToInt(Location.Y / ChunkSize));
+		InputsPerBucket.FindOrAdd(FindOrAddBucket(Key, Settings)).Add(i);
+	}
+	
+	// --- Upload and hand out handles ---
+	const int32 FirstHandle = OutHandles.Num();
+	OutHandles.AddDefaulted(WorldTransforms.Num());
+	
+	TArray<FTransform> BucketTransforms;
+	for (const auto& Pair : InputsPerBucket)
+	{
+		FBucket& Bucket = Buckets[Pair.Key];
+		const TArray<int32>& Inputs = Pair.Value;
+		
+		BucketTransforms.Reset(Inputs.Num());
+		for (int32 Input : Inputs)
+		{
+			BucketTransforms.Add(WorldTransforms[Input]);
+		}
+		
+		const TArray<int32> Indices = Bucket.Component->AddInstances(BucketTransforms, true, true);
+		for (int32 i = 0; i < Indices.Num(); ++i)
+		{
+			const int32 Input = Inputs[i];
+			if (NumCustomData > 0)
+			{
+				Bucket.Component->SetCustomData(Indices[i], CustomData.Slice(Input * NumCustomData, NumCustomData));
+			}
+			
+			FSlot Slot;
+			Slot.Bucket = Pair.Key;
+			Slot.InstanceIndex = Indices[i];
+			Slot.Serial = NextSerial++;
+			const int32 SlotIndex = Slots.Add(Slot);
+			
+			Bucket.InstanceSlots.SetNum(FMath::Max(Bucket.InstanceSlots.Num(), Indices[i] + 1));
+			Bucket.InstanceSlots[Indices[i]] = SlotIndex;
+			
+			FDungeonInstanceHandle& Handle = OutHandles[FirstHandle + Input];
+			Handle.Index = SlotIndex;
+			Handle.Serial = Slot.Serial;
+		}
+		Bucket.Component->MarkRenderStateDirty();
+	}
+}
+
+void UDungeonInstanceManager::RemoveInstances(TConstArrayView<FDungeonInstanceHandle> Handles)
+{
+	// Instance indices to remove, per bucket
+	TMap<int32, TArray<int32>> RemovedPerBucket;
+	for (const FDungeonInstanceHandle& Handle : Handles)
+	{
+		if (!IsHandleValid(Handle)) continue;
+		
+		const FSlot& Slot = Slots[Handle.Index];
+		RemovedPerBucket.FindOrAdd(Slot.Bucket).Add(Slot.InstanceIndex);
+		Slots.RemoveAt(Handle.Index);
+	}
+	
+	TArray<float> MovedCustomData;
+	for (auto& Pair : RemovedPerBucket)
+	{
+		FBucket& Bucket = Buckets[Pair.Key];
+		UHierarchicalInstancedStaticMeshComponent* Component = Bucket.Component;
+		if (!IsValid(Component)) continue;
+		
+		const int32 NumInstances = Bucket.InstanceSlots.Num();
+		const int32 NewNumInstances = NumInstances - Pair.Value.Num();
+		
+		TBitArray<> Removed(false, NumInstances);
+		for (int32 Index : Pair.Value)
+		{
+			Removed[Index] = true;
+		}
+		
+		// Fill every hole below the new end with a surviving instance from the tail
+		int32 Survivor = NewNumInstances;
+		for (int32 Hole = 0; Hole < NewNumInstances; ++Hole)
+		{
+			if (!Removed[Hole]) continue;
+			while (Removed[Survivor])
+			{
+				++Survivor;
+			}
+			
+			FTransform Transform;
+			Component->GetInstanceTransform(Survivor, Transform, true);
+			Component->UpdateInstanceTransform(Hole, Transform, true, false, true);
+			if (Bucket.NumCustomData > 0)
+			{
+				MovedCustomData.Reset();
+				MovedCustomData.Append(&Component->PerInstanceSMCustomData[Survivor * Bucket.NumCustomData], Bucket.NumCustomData);
+				Component->SetCustomData(Hole, MovedCustomData);
+			}
+			
+			const int32 MovedSlot = Bucket.InstanceSlots[Survivor];
+			Bucket.InstanceSlots[Hole] = MovedSlot;
+			Slots[MovedSlot].InstanceIndex = Hole;
+			++Survivor;
+		}
+		
+		// Only the tail is removed, so no remaining instance index shifts
+		TArray<int32> Tail;
+		Tail.Reserve(NumInstances - NewNumInstances);
+		for (int32 Index = NewNumInstances; Index < NumInstances; ++Index)
+		{
+			Tail.Add(Index);
+		}
+		Component->RemoveInstances(Tail);
+		Bucket.InstanceSlots.SetNum(NewNumInstances);
+		Component->MarkRenderStateDirty();
+	}
+}
+
+void UDungeonInstanceManager::ClearInstances()
+{
+	for (FBucket& Bucket : Buckets)
+	{
+		if (IsValid(Bucket.Component))
+		{
+			Bucket.Component->ClearInstances();
+		}
+		Bucket.InstanceSlots.Reset();
+	}
+	Slots.Empty();
+}
+
+int64 UDungeonInstanceManager::GetInstanceBytes() const
+{
+	int64 Bytes = Slots.GetAllocatedSize() + BucketIndices.GetAllocatedSize();
+	for (const FBucket& Bucket : Buckets)
+	{
+		Bytes += DungeonMemory::GetComponentBytes(Bucket.Component) + Bucket.InstanceSlots.GetAllocatedSize();
+	}
+	return Bytes;
+}
+
+int32 UDungeonInstanceManager::FindOrAddBucket(const FBucketKey& Key, const FDungeonInstanceSettings& Settings)
+{
+	if (const int32* Existing = BucketIndices.Find(Key))
+	{
+		return *Existing;
+	}
+	
+	const FString ComponentName = FString::Printf(TEXT("SharedHISM_%s_%d_%d"), *Key.Mesh->GetName(), Key.Chunk.X, Key.Chunk.Y);
+	UHierarchicalInstancedStaticMeshComponent* Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(
+		GetOwner(), MakeUniqueObjectName(GetOwner(), UHierarchicalInstancedStaticMeshComponent::StaticClass(), FName(*ComponentName)));
+	Component->SetStaticMesh(Key.Mesh);
+	Component->SetNumCustomDataFloats(Key.NumCustomData);
+	Component->SetCollisionEnabled(Settings.bCollision ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
+	Component->SetCanEverAffectNavigation(Settings.bAffectNavigation);
+	Component->SetCullDistance(Settings.CullDistance);
+	Component->SetupAttachment(this);
+	Component->RegisterComponent();
+	Components.Add(Component);
+	
+	FBucket& Bucket = Buckets.AddDefaulted_GetRef();
+	Bucket.Component = Component;
+	Bucket.NumCustomData = Key.NumCustomData;
+	
+	const int32 BucketIndex = Buckets.Num() - 1;
+	BucketIndices.Add(Key, BucketIndex);
+	return BucketIndex;
+}
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Manager/DungeonConnection.h"
+
+namespace DungeonConnection
+{
+	// Hash key for a door connection point: quantized boundary position + cardinal facing
+	struct FKey
+	{
+		FIntVector Cell = FIntVector::ZeroValue;
+		uint8 Facing = 0;
+
+		bool operator==(const FKey& Other) const { return Cell == Other.Cell && Facing == Other.Facing; }
+
+		friend uint32 GetTypeHash(const FKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.Cell), ::GetTypeHash(Key.Facing));
+		}
+	};
+
+	// Facing is quantized to the 4 cardinal directions: 0 = +X, 1 = -X, 2 = +Y, 3 = -Y
+	// Opposite directions differ only in the lowest bit
+	static uint8 QuantizeFacing(const FVector& Facing)
+	{
+		if (FMath::Abs(Facing.X) >= FMath::Abs(Facing.Y))
+		{
+			return Facing.X >= 0.0f ? 0 : 1;
+		}
+		return Facing.Y >= 0.0f ? 2 : 3;
+	}
+
+	static FVector FacingVector(uint8 Facing)
+	{
+		switch (Facing)
+		{
+		case 0: return FVector(1.0f, 0.0f, 0.0f);
+		case 1: return FVector(-1.0f, 0.0f, 0.0f);
+		case 2: return FVector(0.0f, 1.0f, 0.0f);
+		default: return FVector(0.0f, -1.0f, 0.0f);
+		}
+	}
+
+	static FIntVector QuantizeLocation(const FVector& Location, float Quantum)
+	{
+		return FIntVector(
+			FMath::RoundToInt(Location.X / Quantum),
+			FMath::RoundToInt(Location.Y / Quantum),
+			FMath::RoundToInt(Location.Z / Quantum));
+	}
+
+	// Two connection points connect if their connection boxes overlap
+	// Boxes are aligned to the door facing (X = along facing, Y = across, Z = up)
+	static bool DoConnectionBoxesOverlap(const FDoorConnectionPoint& A, const FDoorConnectionPoint& B)
+	{
+		const FVector Delta = B.WorldLocation - A.WorldLocation;
+		const FVector Along = A.WorldFacing.GetSafeNormal2D();
+		const FVector Across(-Along.Y, Along.X, 0.0f);
+
+		return FMath::Abs(FVector::DotProduct(Delta, Along)) <= A.ConnectionBoxExtent.X + B.ConnectionBoxExtent.X
+			&& FMath::Abs(FVector::DotProduct(Delta, Across)) <= A.ConnectionBoxExtent.Y + B.ConnectionBoxExtent.Y
+			&& FMath::Abs(Delta.Z) <= A.ConnectionBoxExtent.Z + B.ConnectionBoxExtent.Z;
+	}
+
+	struct FEntry
+	{
+		int32 Candidate = INDEX_NONE;
+		FKey Key;
+		bool bMatched = false;
+
+		// Hashed into a bucket already taken by another door - never connects
+		bool bDuplicate = false;
+	};
+
+	void PairConnectionPoints(TConstArrayView<FCandidate> Candidates, float Quantization,
+		TArray<TPair<int32, int32>>& OutPairs, TArray<TPair<int32, int32>>* OutDuplicates)
+	{
+		OutPairs.Reset();
+		if (OutDuplicates)
+		{
+			OutDuplicates->Reset();
+		}
+
+		const float Quantum = FMath::Max(1.0f, Quantization);
+
+		// 1. Hash every connection point
+		TArray<FEntry> Entries;
+		Entries.Reserve(Candidates.Num());
+		for (int32 i = 0; i < Candidates.Num(); ++i)
+		{
+			if (!Candidates[i].Point) continue;
+
+			FEntry& Entry = Entries.AddDefaulted_GetRef();
+			Entry.Candidate = i;
+			Entry.Key.Cell = QuantizeLocation(Candidates[i].Point->WorldLocation, Quantum);
+			Entry.Key.Facing = QuantizeFacing(Candidates[i].Point->WorldFacing);
+		}
+
+		// 2. Sort by key so that pairing does not depend on room or door iteration order
+		// Doors sharing a key are ordered by owner, then by candidate index, so the kept duplicate is well defined
+		Entries.StableSort([&Candidates](const FEntry& A, const FEntry& B)
+		{
+			if (A.Key.Cell.X != B.Key.Cell.X) return A.Key.Cell.X < B.Key.Cell.X;
+			if (A.Key.Cell.Y != B.Key.Cell.Y) return A.Key.Cell.Y < B.Key.Cell.Y;
+			if (A.Key.Cell.Z != B.Key.Cell.Z) return A.Key.Cell.Z < B.Key.Cell.Z;
+			if (A.Key.Facing != B.Key.Facing) return A.Key.Facing < B.Key.Facing;
+			if (Candidates[A.Candidate].Owner != Candidates[B.Candidate].Owner) return Candidates[A.Candidate].Owner < Candidates[B.Candidate].Owner;
+			return A.Candidate < B.Candidate;
+		});
+
+		TMap<FKey, int32> KeyToEntry;
+		KeyToEntry.Reserve(Entries.Num());
+		for (int32 i = 0; i < Entries.Num(); ++i)
+		{
+			if (const int32* Existing = KeyToEntry.Find(Entries[i].Key))
+			{
+				if (OutDuplicates)
+				{
+					OutDuplicates->Emplace(Entries[*Existing].Candidate, Entries[i].Candidate);
+				}
+				Entries[i].bDuplicate = true;
+				continue;
+			}
+			KeyToEntry.Add(Entries[i].Key, i);
+		}
+
+		// 3. Pair each door with the nearest opposite-facing door in front of it
+		// Each step also probes the buckets on either side: a door a fraction of a quantum off to the side
+		// can round into the neighbouring bucket while its connection box still overlaps
+		static constexpr int32 LateralProbes[] = { 0, 1, -1 };
+
+		for (int32 i = 0; i < Entries.Num(); ++i)
+		{
+			FEntry& Entry = Entries[i];
+			if (Entry.bMatched || Entry.bDuplicate) continue;
+
+			const FCandidate& Candidate = Candidates[Entry.Candidate];
+			const FDoorConnectionPoint& Point = *Candidate.Point;
+			const FVector Facing = FacingVector(Entry.Key.Facing);
+			const FVector Across(-Facing.Y, Facing.X, 0.0f);
+			const int32 NumProbes = FMath::CeilToInt(2.0f * Point.ConnectionBoxExtent.X / Quantum);
+
+			FKey PartnerKey;
+			PartnerKey.Facing = Entry.Key.Facing ^ 1;
+
+			for (int32 Step = 0; Step <= NumProbes && !Entry.bMatched; ++Step)
+			{
+				for (const int32 Lateral : LateralProbes)
+				{
+					PartnerKey.Cell = QuantizeLocation(Point.WorldLocation + (Facing * Step + Across * Lateral) * Quantum, Quantum);
+
+					const int32* PartnerIndex = KeyToEntry.Find(PartnerKey);
+					if (!PartnerIndex || *PartnerIndex == i) continue;
+
+					FEntry& Partner = Entries[*PartnerIndex];
+					const FCandidate& PartnerCandidate = Candidates[Partner.Candidate];
+					if (Partner.bMatched || PartnerCandidate.Owner == Candidate.Owner) continue;
+					if (!DoConnectionBoxesOverlap(Point, *PartnerCandidate.Point)) continue;
+
+					Entry.bMatched = true;
+					Partner.bMatched = true;
+					OutPairs.Emplace(Entry.Candidate, Partner.Candidate);
+					break;
+				}
+			}
+		}
+	}
+}
@@ -2,6 +2,14 @@
 
 
 #include "DungeonGen/Manager/DungeonManager.h"
+#include "DungeonGen/Manager/DungeonConnection.h"
+#include "DungeonGen/Rooms/MasterRoom.h"
+#include "DungeonGen/Navigation/DungeonPathfinding.h"
+#include "DungeonGen/Visibility/DungeonVisibility.h"
+#include "DungeonGen/Instances/DungeonInstanceManager.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
 
 // Sets default values
 ADungeonManager::ADungeonManager()
@@ -9,6 +17,9 @@ ADungeonManager::ADungeonManager()
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
+	// Shared room instances are stored in world space under this component
+	InstanceManager = CreateDefaultSubobject<UDungeonInstanceManager>(TEXT("InstanceManager"));
+	RootComponent = InstanceManager;
 }
 
 // Called when the game starts or when spawned
@@ -16,6 +27,31 @@ void ADungeonManager::BeginPlay()
 {
 	Super::BeginPlay();
 	
+	// Clients bind too - they generate their rooms locally
+	BindRoomInstances(true);
+	
+	// With streaming, rooms are only built when streamed in (clients keep the replicated state until then)
+	for (AMasterRoom* Room : GatherRooms())
+	{
+		Room->SetDeferGenerationToStreaming(bEnableRoomStreaming);
+	}
+	
+	// Portals link with the same bucket size the doors connect with
+	if (UDungeonVisibilitySubsystem* Visibility = GetWorld()->GetSubsystem<UDungeonVisibilitySubsystem>())
+	{
+		Visibility->SetConnectionQuantization(ConnectionQuantization);
+	}
+	
+	if (bGenerateOnBeginPlay && HasAuthority())
+	{
+		// Door connections are resolved up front; with streaming only the layouts are solved here
+		GenerateDungeon();
+	}
+	
+	if (bEnableRoomStreaming)
+	{
+		UpdateRoomStreaming();
+	}
 }
 
 // Called every frame
@@ -23,5 +59,283 @@ void ADungeonManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (bEnableRoomStreaming)
+	{
+		TimeSinceStreamingUpdate += DeltaTime;
+		if (TimeSinceStreamingUpdate >= StreamingUpdateInterval)
+		{
+			TimeSinceStreamingUpdate = 0.0f;
+			UpdateRoomStreaming();
+		}
+	}
+	
+	// Portal culling runs every frame - it follows the camera, not the streaming cadence
+	if (bEnablePortalCulling)
+	{
+		if (UDungeonVisibilitySubsystem* Visibility = GetWorld()->GetSubsystem<UDungeonVisibilitySubsystem>())
+		{
+			Visibility->UpdateVisibility(MaxPortalDepth);
+		}
+	}
+}
+
+void ADungeonManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UDungeonVisibilitySubsystem* Visibility = GetWorld() ? GetWorld()->GetSubsystem<UDungeonVisibilitySubsystem>() : nullptr)
+	{
+		Visibility->ShowAllRooms();
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void ADungeonManager::GatherStreamingSources(TArray<TPair<FVector, FVector>>& OutSources) const
+{
+	UWorld* World = GetWorld();
+	if (!World) return;
+	
+	// On the server this visits every player, on clients only the local ones
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		const APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+		if (!Pawn) continue;
+		
+		const FVector Location = Pawn->GetActorLocation();
+		const FVector Predicted = Location + Pawn->GetVelocity() * PathPredictionTime;
+		OutSources.Emplace(Location, Predicted);
+	}
+}
+
+void ADungeonManager::UpdateRoomStreaming()
+{
+	TArray<TPair<FVector, FVector>> Sources;
+	GatherStreamingSources(Sources);
+	if (Sources.Num() == 0) return;
+	
+	// Hysteresis: a room must come inside ActivationRadius to generate, and leave ReleaseRadius to be released
+	const float ActivationDistSq = FMath::Square(ActivationRadius);
+	const float ReleaseDistSq = FMath::Square(FMath::Max(ReleaseRadius, ActivationRadius));
+	
+	TArray<TPair<float, AMasterRoom*>> RoomsToGenerate;
+	int32 RoomsReleased = 0;
+	
+	for (AMasterRoom* Room : GatherRooms())
+	{
+		// Clients wait for the server's generation state
+		if (!Room->CanGenerate()) continue;
+		
+		const FBox Bounds = Room->GetRoomBounds();
+		
+		// Distance to the closest point of any player's current-to-predicted path segment
+		float MinDistSq = TNumericLimits<float>::Max();
+		for (const TPair<FVector, FVector>& Source : Sources)
+		{
+			const FVector PathPoint = FMath::ClosestPointOnSegment(Bounds.GetCenter(), Source.Key, Source.Value);
+			MinDistSq = FMath::Min(MinDistSq, (float)Bounds.ComputeSquaredDistanceToPoint(PathPoint));
+			MinDistSq = FMath::Min(MinDistSq, (float)Bounds.ComputeSquaredDistanceToPoint(Source.Key));
+		}
+		
+		if (!Room->IsRoomGenerated() && MinDistSq <= ActivationDistSq)
+		{
+			RoomsToGenerate.Emplace(MinDistSq, Room);
+		}
+		else if (Room->IsRoomGenerated() && MinDistSq > ReleaseDistSq)
+		{
+			Room->ReleaseRoom();
+			RoomsReleased++;
+		}
+	}
+	
+	// Nearest rooms first, limited by the per-update generation budget
+	RoomsToGenerate.Sort([](const TPair<float, AMasterRoom*>& A, const TPair<float, AMasterRoom*>& B)
+	{
+		return A.Key < B.Key;
+	});
+	
+	const int32 NumToGenerate = FMath::Min(RoomsToGenerate.Num(), MaxRoomGenerationsPerUpdate);
+	for (int32 i = 0; i < NumToGenerate; ++i)
+	{
+		RoomsToGenerate[i].Value->RegenerateRoom();
+	}
+	
+	if (NumToGenerate > 0 || RoomsReleased > 0)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("DungeonManager streaming: %d generated (%d pending), %d released"),
+			NumToGenerate, RoomsToGenerate.Num() - NumToGenerate, RoomsReleased);
+	}
+}
+
+TArray<AMasterRoom*> ADungeonManager::GatherRooms() const
+{
+	TArray<AMasterRoom*> Result;
+	
+	if (Rooms.Num() > 0)
+	{
+		for (AMasterRoom* Room : Rooms)
+		{
+			if (Room)
+			{
+				Result.Add(Room);
+			}
+		}
+		return Result;
+	}
+	
+	if (UWorld* World = GetWorld())
+	{
+		for (TActorIterator<AMasterRoom> It(World); It; ++It)
+		{
+			Result.Add(*It);
+		}
+	}
+	return Result;
+}
+
+void ADungeonManager::GenerateDungeon()
+{
+	TArray<AMasterRoom*> ManagedRooms = GatherRooms();
+	
+	UE_LOG(LogTemp, Log, TEXT("DungeonManager: Generating %d rooms"), ManagedRooms.Num());
+	
+	BindRoomInstances(false);
+	for (AMasterRoom* Room : ManagedRooms)
+	{
+		// Streaming builds the rooms near players - the rest only need their door connection points
+		if (bEnableRoomStreaming)
+		{
+			Room->SolveRoom();
+		}
+		else
+		{
+			Room->RegenerateRoom();
+		}
+	}
+	
+	ConnectRoomDoors();
 }
 
+void ADungeonManager::ConnectRoomDoors()
+{
+	DoorConnections.Empty();
+	UnmatchedDoors.Empty();
+	
+	TArray<AMasterRoom*> ManagedRooms = GatherRooms();
+	
+	// 1. Collect every published connection point (the room index is the owner - a room never connects to itself)
+	TArray<AMasterRoom*> CandidateRooms;
+	TArray<DungeonConnection::FCandidate> Candidates;
+	for (int32 RoomIndex = 0; RoomIndex < ManagedRooms.Num(); ++RoomIndex)
+	{
+		for (const FDoorConnectionPoint& Point : ManagedRooms[RoomIndex]->GetDoorConnectionPoints())
+		{
+			Candidates.Add({ RoomIndex, &Point });
+			CandidateRooms.Add(ManagedRooms[RoomIndex]);
+		}
+	}
+	
+	// 2. Pair facing doors (same rule the visibility subsystem links its portals with)
+	TArray<TPair<int32, int32>> Pairs;
+	TArray<TPair<int32, int32>> Duplicates;
+	DungeonConnection::PairConnectionPoints(Candidates, ConnectionQuantization, Pairs, &Duplicates);
+	
+	for (const TPair<int32, int32>& Duplicate : Duplicates)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("DungeonManager: Overlapping doors at %s (%s and %s) - only the first can connect"),
+			*Candidates[Duplicate.Value].Point->WorldLocation.ToString(),
+			*CandidateRooms[Duplicate.Key]->GetName(),
+			*CandidateRooms[Duplicate.Value]->GetName());
+	}
+	
+	// 3. Record the connections
+	TBitArray<> Matched(false, Candidates.Num());
+	for (const TPair<int32, int32>& Pair : Pairs)
+	{
+		Matched[Pair.Key] = true;
+		Matched[Pair.Value] = true;
+		
+		FDoorConnection& Connection = DoorConnections.AddDefaulted_GetRef();
+		Connection.A.Room = CandidateRooms[Pair.Key];
+		Connection.A.Point = *Candidates[Pair.Key].Point;
+		Connection.B.Room = CandidateRooms[Pair.Value];
+		Connection.B.Point = *Candidates[Pair.Value].Point;
+	}
+	
+	// 4. Report (and optionally seal) doors without a partner
+	TSet<AMasterRoom*> RoomsToRegenerate;
+	for (int32 i = 0; i < Candidates.Num(); ++i)
+	{
+		if (Matched[i]) continue;
+		
+		AMasterRoom* Room = CandidateRooms[i];
+		const FDoorConnectionPoint& Point = *Candidates[i].Point;
+		
+		FDoorConnectionRef& Unmatched = UnmatchedDoors.AddDefaulted_GetRef();
+		Unmatched.Room = Room;
+		Unmatched.Point = Point;
+		
+		UE_LOG(LogTemp, Warning, TEXT("DungeonManager: Unmatched door in %s (Edge=%d, StartCell=%d) at %s%s"),
+			*Room->GetName(), (int32)Point.WallEdge, Point.StartCell, *Point.WorldLocation.ToString(),
+			bSealUnmatchedDoors ? TEXT(" - sealing") : TEXT(""));
+		
+		// Sealing only records the door - the rooms re-solve (and republish their points) after this loop
+		if (bSealUnmatchedDoors && Room->SealDoor(Point.WallEdge, Point.StartCell))
+		{
+			RoomsToRegenerate.Add(Room);
+		}
+	}
+	
+	for (AMasterRoom* Room : RoomsToRegenerate)
+	{
+		// Built rooms regenerate, streamed-out rooms only re-solve
+		Room->SolveRoom();
+	}
+	
+	// 5. Hand the door graph to the pathfinder (rooms push their own grids as they generate)
+	if (UDungeonPathfindingSubsystem* Pathfinding = GetWorld() ? GetWorld()->GetSubsystem<UDungeonPathfindingSubsystem>() : nullptr)
+	{
+		Pathfinding->SetDoorConnections(DoorConnections);
+	}
+	
+	UE_LOG(LogTemp, Log, TEXT("DungeonManager: %d door connections, %d unmatched doors (%d rooms resealed)"),
+		DoorConnections.Num(), UnmatchedDoors.Num(), RoomsToRegenerate.Num());
+}
+
+void ADungeonManager::ResetDoorSeals()
+{
+	for (AMasterRoom* Room : GatherRooms())
+	{
+		if (Room->SealedDoors.Num() > 0)
+		{
+			Room->ClearSealedDoors();
+			Room->SolveRoom();
+		}
+	}
+	
+	ConnectRoomDoors();
+}
+
+void ADungeonManager::BindRoomInstances(bool bRegenerate)
+{
+	UDungeonInstanceManager* Target = bUseSharedInstances ? InstanceManager : nullptr;
+	for (AMasterRoom* Room : GatherRooms())
+	{
+		Room->SetSharedInstanceManager(Target, bRegenerate);
+	}
+}
+
+FRoomMemoryStats ADungeonManager::GetDungeonMemoryStats() const
+{
+	FRoomMemoryStats Total;
+	for (AMasterRoom* Room : GatherRooms())
+	{
+		Total += Room->GetMemoryStats();
+	}
+	
+	// Shared instance buffers aren't owned by any one room
+	if (InstanceManager)
+	{
+		Total.InstanceBytes += InstanceManager->GetInstanceBytes();
+		Total.NumInstanceComponents += InstanceManager->GetNumComponents();
+	}
+	return Total;
+}
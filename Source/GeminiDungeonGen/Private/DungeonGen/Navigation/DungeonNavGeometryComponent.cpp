@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Navigation/DungeonNavGeometryComponent.h"
+#include "AI/NavigationSystemBase.h"
+#include "AI/NavigationSystemHelpers.h"
+
+UDungeonNavGeometryComponent::UDungeonNavGeometryComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	
+	// Navigation export only - no collision, no rendering, no overlaps
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(false);
+	SetCanEverAffectNavigation(true);
+	bHasCustomNavigableGeometry = EHasCustomNavigableGeometry::EvenIfNotCollision;
+	bHiddenInGame = true;
+	CastShadow = false;
+}
+
+void UDungeonNavGeometryComponent::SetGeometry(TArray<FBox>&& InWalkable, TArray<FBox>&& InObstacles)
+{
+	Walkable = MoveTemp(InWalkable);
+	Obstacles = MoveTemp(InObstacles);
+	
+	// New bounds first so the navigation system dirties the right area (old + new bounds)
+	UpdateBounds();
+	FNavigationSystem::UpdateComponentData(*this);
+}
+
+void UDungeonNavGeometryComponent::ClearGeometry()
+{
+	if (GetNumBoxes() == 0) return;
+	
+	SetGeometry(TArray<FBox>(), TArray<FBox>());
+}
+
+FBoxSphereBounds UDungeonNavGeometryComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	FBox LocalBounds(ForceInit);
+	for (const FBox& Box : Walkable)
+	{
+		LocalBounds += Box;
+	}
+	for (const FBox& Box : Obstacles)
+	{
+		LocalBounds += Box;
+	}
+	
+	if (!LocalBounds.IsValid)
+	{
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.0f);
+	}
+	return FBoxSphereBounds(LocalBounds.TransformBy(LocalToWorld));
+}
+
+bool UDungeonNavGeometryComponent::IsNavigationRelevant() const
+{
+	return GetNumBoxes() > 0 && Super::IsNavigationRelevant();
+}
+
+void UDungeonNavGeometryComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Walkable.GetAllocatedSize() + Obstacles.GetAllocatedSize());
+}
+
+bool UDungeonNavGeometryComponent::DoCustomNavigableGeometryExport(FNavigableGeometryExport& GeomExport) const
+{
+	// Shared box topology: 8 corners, 12 triangles
+	// Unreal winding (normal = (C - A) x (B - A)) facing outwards - Recast derives walkability from
+	// the triangle normals after its axis swap, so the +Z faces must wind this way to be walkable
+	static const int32 BoxIndices[36] =
+	{
+		0, 1, 2,  0, 2, 3,	// -Z
+		4, 6, 5,  4, 7, 6,	// +Z
+		0, 5, 1,  0, 4, 5,	// -Y
+		2, 7, 3,  2, 6, 7,	// +Y
+		0, 7, 4,  0, 3, 7,	// -X
+		1, 6, 2,  1, 5, 6	// +X
+	};
+	
+	const FTransform& LocalToWorld = GetComponentTransform();
+	auto ExportBox = [&](const FBox& Box)
+	{
+		const FVector Vertices[8] =
+		{
+			FVector(Box.Min.X, Box.Min.Y, Box.Min.Z),
+			FVector(Box.Max.X, Box.Min.Y, Box.Min.Z),
+			FVector(Box.Max.X, Box.Max.Y, Box.Min.Z),
+			FVector(Box.Min.X, Box.Max.Y, Box.Min.Z),
+			FVector(Box.Min.X, Box.Min.Y, Box.Max.Z),
+			FVector(Box.Max.X, Box.Min.Y, Box.Max.Z),
+			FVector(Box.Max.X, Box.Max.Y, Box.Max.Z),
+			FVector(Box.Min.X, Box.Max.Y, Box.Max.Z)
+		};
+		GeomExport.ExportCustomMesh(Vertices, 8, BoxIndices, 36, LocalToWorld);
+	};
+	
+	for (const FBox& Box : Walkable)
+	{
+		ExportBox(Box);
+	}
+	for (const FBox& Box : Obstacles)
+	{
+		ExportBox(Box);
+	}
+	
+	// Nothing else to export (the component has no collision)
+	return false;
+}
@@ -0,0 +1,566 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Navigation/DungeonPathfinding.h"
+#include "DungeonGen/Rooms/MasterRoom.h"
+#include "DungeonGen/Manager/DungeonManager.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Reverse.h"
+#include "Async/ParallelFor.h"
+
+// ==================================================================================
+// GRID SEARCH HELPERS
+// ==================================================================================
+
+namespace DungeonPathfinding
+{
+	static constexpr float DiagonalCost = CELL_SIZE * UE_SQRT_2;
+
+	// Orthogonal moves first, then diagonals (index >= 4)
+	static const FIntPoint Directions[8] =
+	{
+		FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1),
+		FIntPoint(1, 1), FIntPoint(1, -1), FIntPoint(-1, 1), FIntPoint(-1, -1)
+	};
+
+	struct FOpenNode
+	{
+		int32 Index;
+		float F;
+	};
+
+	struct FOpenNodePredicate
+	{
+		bool operator()(const FOpenNode& A, const FOpenNode& B) const { return A.F < B.F; }
+	};
+
+	// Exact cost of the shortest 8-connected path on an empty grid (admissible A* heuristic)
+	static float OctileDistance(FIntPoint A, FIntPoint B)
+	{
+		const int32 DX = FMath::Abs(A.X - B.X);
+		const int32 DY = FMath::Abs(A.Y - B.Y);
+		return CELL_SIZE * (FMath::Max(DX, DY) + (UE_SQRT_2 - 1.0f) * FMath::Min(DX, DY));
+	}
+
+	static FVector CellToWorld(const FDungeonPathRoom& Room, FIntPoint Cell)
+	{
+		return Room.Transform.TransformPosition(FVector((Cell.X + 0.5f) * CELL_SIZE, (Cell.Y + 0.5f) * CELL_SIZE, 0.0f));
+	}
+
+	// A* towards Goal, or a full Dijkstra flood when Goal is null
+	// OutCost holds the path cost (cm) per cell (MAX_flt = unreached), OutParent the previous cell index
+	static bool SearchGrid(const FDungeonPathRoom& Room, FIntPoint Start, const FIntPoint* Goal, TArray<float>& OutCost, TArray<int32>& OutParent)
+	{
+		const int32 NumCells = Room.GridSize.X * Room.GridSize.Y;
+		OutCost.Init(MAX_flt, NumCells);
+		OutParent.Init(INDEX_NONE, NumCells);
+		if (!Room.IsWalkable(Start.X, Start.Y)) return false;
+
+		TBitArray<> Closed(false, NumCells);
+		TArray<FOpenNode> Open;
+		Open.Reserve(64);
+
+		const int32 StartIndex = Start.Y * Room.GridSize.X + Start.X;
+		OutCost[StartIndex] = 0.0f;
+		Open.HeapPush({ StartIndex, Goal ? OctileDistance(Start, *Goal) : 0.0f }, FOpenNodePredicate());
+
+		while (Open.Num() > 0)
+		{
+			FOpenNode Node;
+			Open.HeapPop(Node, FOpenNodePredicate(), EAllowShrinking::No);
+			if (Closed[Node.Index]) continue;	// Stale heap entry
+			Closed[Node.Index] = true;
+
+			const FIntPoint Cell(Node.Index % Room.GridSize.X, Node.Index / Room.GridSize.X);
+			if (Goal && Cell == *Goal) return true;
+
+			for (int32 Dir = 0; Dir < 8; ++Dir)
+			{
+				const FIntPoint Next = Cell + Directions[Dir];
+				if (!Room.IsWalkable(Next.X, Next.Y)) continue;
+
+				// No corner cutting: a diagonal step needs both orthogonal neighbours free
+				const bool bDiagonal = Dir >= 4;
+				if (bDiagonal && (!Room.IsWalkable(Next.X, Cell.Y) || !Room.IsWalkable(Cell.X, Next.Y))) continue;
+
+				const int32 NextIndex = Next.Y * Room.GridSize.X + Next.X;
+				if (Closed[NextIndex]) continue;
+
+				const float NewCost = OutCost[Node.Index] + (bDiagonal ? DiagonalCost : CELL_SIZE);
+				if (NewCost < OutCost[NextIndex])
+				{
+					OutCost[NextIndex] = NewCost;
+					OutParent[NextIndex] = Node.Index;
+					Open.HeapPush({ NextIndex, NewCost + (Goal ? OctileDistance(Next, *Goal) : 0.0f) }, FOpenNodePredicate());
+				}
+			}
+		}
+
+		return Goal == nullptr;
+	}
+
+	// Straight line between cell centres crosses only walkable cells (exact corner crossings need both sides free)
+	static bool HasLineOfSight(const FDungeonPathRoom& Room, FIntPoint A, FIntPoint B)
+	{
+		const int32 NX = FMath::Abs(B.X - A.X);
+		const int32 NY = FMath::Abs(B.Y - A.Y);
+		const int32 SX = B.X > A.X ? 1 : -1;
+		const int32 SY = B.Y > A.Y ? 1 : -1;
+
+		FIntPoint Cell = A;
+		for (int32 IX = 0, IY = 0; IX < NX || IY < NY; )
+		{
+			const int64 Decision = (int64)(1 + 2 * IX) * NY - (int64)(1 + 2 * IY) * NX;
+			if (Decision == 0)
+			{
+				if (!Room.IsWalkable(Cell.X + SX, Cell.Y) || !Room.IsWalkable(Cell.X, Cell.Y + SY)) return false;
+				Cell.X += SX; Cell.Y += SY;
+				++IX; ++IY;
+			}
+			else if (Decision < 0)
+			{
+				Cell.X += SX;
+				++IX;
+			}
+			else
+			{
+				Cell.Y += SY;
+				++IY;
+			}
+
+			if (!Room.IsWalkable(Cell.X, Cell.Y)) return false;
+		}
+		return true;
+	}
+
+	bool FindRoomLeg(const FDungeonPathRoom& Room, FIntPoint Start, FIntPoint Goal, TArray<FVector>& OutPoints)
+	{
+		TArray<float> Cost;
+		TArray<int32> Parent;
+		if (!SearchGrid(Room, Start, &Goal, Cost, Parent)) return false;
+
+		TArray<FIntPoint> Cells;
+		for (int32 Index = Goal.Y * Room.GridSize.X + Goal.X; Index != INDEX_NONE; Index = Parent[Index])
+		{
+			Cells.Add(FIntPoint(Index % Room.GridSize.X, Index / Room.GridSize.X));
+		}
+		Algo::Reverse(Cells);
+
+		// String pulling: keep a cell only where the line of sight from the last kept cell breaks
+		int32 Anchor = 0;
+		OutPoints.Add(CellToWorld(Room, Cells[0]));
+		for (int32 i = 2; i < Cells.Num(); ++i)
+		{
+			if (!HasLineOfSight(Room, Cells[Anchor], Cells[i]))
+			{
+				Anchor = i - 1;
+				OutPoints.Add(CellToWorld(Room, Cells[Anchor]));
+			}
+		}
+		if (Cells.Num() > 1)
+		{
+			OutPoints.Add(CellToWorld(Room, Cells.Last()));
+		}
+		return true;
+	}
+
+	static void AppendPoints(TArray<FVector>& Path, const TArray<FVector>& Points)
+	{
+		for (const FVector& Point : Points)
+		{
+			if (Path.Num() == 0 || !Path.Last().Equals(Point, 1.0f))
+			{
+				Path.Add(Point);
+			}
+		}
+	}
+}
+
+// ==================================================================================
+// ROOM SNAPSHOTS
+// ==================================================================================
+
+void UDungeonPathfindingSubsystem::UpdateRoom(AMasterRoom* Room)
+{
+	if (!Room || !Room->RoomData) return;
+
+	LLM_SCOPE_BYTAG(DungeonGen_Navigation);
+
+	const FIntPoint GridSize = Room->RoomData->GridSize;
+	const TArray<EGridCellType>& CellStates = Room->GetGridState();
+	if (CellStates.Num() != GridSize.X * GridSize.Y) return;
+
+	int32& RoomIndex = RoomIndices.FindOrAdd(Room, INDEX_NONE);
+	if (RoomIndex == INDEX_NONE)
+	{
+		RoomIndex = Rooms.AddDefaulted();
+	}
+
+	FDungeonPathRoom& PathRoom = Rooms[RoomIndex];
+	PathRoom = FDungeonPathRoom();
+	PathRoom.Room = Room;
+	PathRoom.Transform = Room->GetActorTransform();
+	PathRoom.GridSize = GridSize;
+	PathRoom.Height = FMath::Max(Room->GetRoomBounds().GetSize().Z, CELL_SIZE);
+
+	// Only floor tiles are walkable (interior meshes, carved-out cells and empty cells block)
+	PathRoom.Walkable.Init(false, CellStates.Num());
+	for (int32 i = 0; i < CellStates.Num(); ++i)
+	{
+		PathRoom.Walkable[i] = CellStates[i] == EGridCellType::ECT_FloorMesh;
+	}
+
+	// --- Portals: the walkable interior cell in front of each door ---
+	for (const FDoorConnectionPoint& Point : Room->GetDoorConnectionPoints())
+	{
+		FDungeonPathPortal& Portal = PathRoom.Portals.AddDefaulted_GetRef();
+		Portal.Edge = Point.WallEdge;
+		Portal.StartCell = Point.StartCell;
+
+		// Try the middle of the door span first, then the rest of the span
+		const int32 Footprint = FMath::Max(1, Point.Footprint);
+		for (int32 Step = 0; Step < Footprint; ++Step)
+		{
+			const int32 Offset = (Step % 2 == 0) ? Step / 2 : -(Step + 1) / 2;
+			const int32 SpanCell = Point.StartCell + Footprint / 2 + Offset;
+
+			FIntPoint Cell;
+			switch (Point.WallEdge)
+			{
+				case EWallEdge::North:	Cell = FIntPoint(GridSize.X - 1, SpanCell); break;
+				case EWallEdge::South:	Cell = FIntPoint(0, SpanCell); break;
+				case EWallEdge::East:	Cell = FIntPoint(SpanCell, GridSize.Y - 1); break;
+				default:				Cell = FIntPoint(SpanCell, 0); break;
+			}
+
+			if (Step == 0 || PathRoom.IsWalkable(Cell.X, Cell.Y))
+			{
+				Portal.Cell = Cell;
+				if (PathRoom.IsWalkable(Cell.X, Cell.Y)) break;
+			}
+		}
+		Portal.WorldLocation = DungeonPathfinding::CellToWorld(PathRoom, Portal.Cell);
+	}
+
+	// --- Portal-to-portal distances (one Dijkstra flood per portal) ---
+	const int32 NumPortals = PathRoom.Portals.Num();
+	PathRoom.PortalDistances.Init(MAX_flt, NumPortals * NumPortals);
+	TArray<float> Cost;
+	TArray<int32> Parent;
+	for (int32 From = 0; From < NumPortals; ++From)
+	{
+		DungeonPathfinding::SearchGrid(PathRoom, PathRoom.Portals[From].Cell, nullptr, Cost, Parent);
+		for (int32 To = 0; To < NumPortals; ++To)
+		{
+			const FIntPoint ToCell = PathRoom.Portals[To].Cell;
+			if (PathRoom.IsWalkable(ToCell.X, ToCell.Y))
+			{
+				PathRoom.PortalDistances[From * NumPortals + To] = Cost[ToCell.Y * GridSize.X + ToCell.X];
+			}
+		}
+	}
+
+	ResolvePortalLinks();
+}
+
+void UDungeonPathfindingSubsystem::RemoveRoom(AMasterRoom* Room)
+{
+	int32 RoomIndex = INDEX_NONE;
+	if (!RoomIndices.RemoveAndCopyValue(Room, RoomIndex)) return;
+
+	Rooms.RemoveAtSwap(RoomIndex);
+	if (Rooms.IsValidIndex(RoomIndex))
+	{
+		RoomIndices.Add(Rooms[RoomIndex].Room.Get(), RoomIndex);
+	}
+
+	ResolvePortalLinks();
+}
+
+void UDungeonPathfindingSubsystem::SetDoorConnections(const TArray<FDoorConnection>& Connections)
+{
+	PortalLinks.Reset(Connections.Num());
+	for (const FDoorConnection& Connection : Connections)
+	{
+		FPortalLinkKey A;
+		A.Room = Connection.A.Room;
+		A.Edge = Connection.A.Point.WallEdge;
+		A.StartCell = Connection.A.Point.StartCell;
+
+		FPortalLinkKey B;
+		B.Room = Connection.B.Room;
+		B.Edge = Connection.B.Point.WallEdge;
+		B.StartCell = Connection.B.Point.StartCell;
+
+		PortalLinks.Emplace(A, B);
+	}
+
+	ResolvePortalLinks();
+}
+
+void UDungeonPathfindingSubsystem::ResolvePortalLinks()
+{
+	PortalOffsets.SetNum(Rooms.Num());
+	NumPortalNodes = 0;
+	for (int32 RoomIndex = 0; RoomIndex < Rooms.Num(); ++RoomIndex)
+	{
+		PortalOffsets[RoomIndex] = NumPortalNodes;
+		NumPortalNodes += Rooms[RoomIndex].Portals.Num();
+		for (FDungeonPathPortal& Portal : Rooms[RoomIndex].Portals)
+		{
+			Portal.LinkedRoom = INDEX_NONE;
+			Portal.LinkedPortal = INDEX_NONE;
+		}
+	}
+
+	auto FindPortal = [this](const FPortalLinkKey& Key, int32& OutRoom, int32& OutPortal)
+	{
+		const int32* RoomIndex = Key.Room.IsValid() ? RoomIndices.Find(Key.Room.Get()) : nullptr;
+		if (!RoomIndex) return false;
+
+		const TArray<FDungeonPathPortal>& Portals = Rooms[*RoomIndex].Portals;
+		OutRoom = *RoomIndex;
+		OutPortal = Portals.IndexOfByPredicate([&Key](const FDungeonPathPortal& Portal)
+		{
+			return Portal.Edge == Key.Edge && Portal.StartCell == Key.StartCell;
+		});
+		return OutPortal != INDEX_NONE;
+	};
+
+	for (const TPair<FPortalLinkKey, FPortalLinkKey>& Link : PortalLinks)
+	{
+		int32 RoomA, PortalA, RoomB, PortalB;
+		if (FindPortal(Link.Key, RoomA, PortalA) && FindPortal(Link.Value, RoomB, PortalB))
+		{
+			Rooms[RoomA].Portals[PortalA].LinkedRoom = RoomB;
+			Rooms[RoomA].Portals[PortalA].LinkedPortal = PortalB;
+			Rooms[RoomB].Portals[PortalB].LinkedRoom = RoomA;
+			Rooms[RoomB].Portals[PortalB].LinkedPortal = PortalA;
+		}
+	}
+}
+
+bool UDungeonPathfindingSubsystem::FindRoomCell(const FVector& WorldLocation, int32& OutRoom, FIntPoint& OutCell) const
+{
+	for (int32 RoomIndex = 0; RoomIndex < Rooms.Num(); ++RoomIndex)
+	{
+		const FDungeonPathRoom& Room = Rooms[RoomIndex];
+		const FVector Local = Room.Transform.InverseTransformPosition(WorldLocation);
+		if (Local.Z < -CELL_SIZE || Local.Z > Room.Height) continue;
+
+		// Allow one cell of slack so positions standing in a doorway resolve to the room in front
+		const FIntPoint RawCell(FMath::FloorToInt(Local.X / CELL_SIZE), FMath::FloorToInt(Local.Y / CELL_SIZE));
+		if (RawCell.X < -1 || RawCell.Y < -1 || RawCell.X > Room.GridSize.X || RawCell.Y > Room.GridSize.Y) continue;
+
+		const FIntPoint Cell(FMath::Clamp(RawCell.X, 0, Room.GridSize.X - 1), FMath::Clamp(RawCell.Y, 0, Room.GridSize.Y - 1));
+		if (Room.IsWalkable(Cell.X, Cell.Y))
+		{
+			OutRoom = RoomIndex;
+			OutCell = Cell;
+			return true;
+		}
+
+		// Standing next to an obstacle (or exactly on its edge) - use the nearest walkable neighbour
+		for (const FIntPoint& Direction : DungeonPathfinding::Directions)
+		{
+			const FIntPoint Neighbour = Cell + Direction;
+			if (Room.IsWalkable(Neighbour.X, Neighbour.Y))
+			{
+				OutRoom = RoomIndex;
+				OutCell = Neighbour;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// ==================================================================================
+// QUERIES
+// ==================================================================================
+
+FDungeonPathResult UDungeonPathfindingSubsystem::FindPath(const FVector& Start, const FVector& End) const
+{
+	using namespace DungeonPathfinding;
+
+	FDungeonPathResult Result;
+
+	int32 StartRoom, GoalRoom;
+	FIntPoint StartCell, GoalCell;
+	if (!FindRoomCell(Start, StartRoom, StartCell) || !FindRoomCell(End, GoalRoom, GoalCell))
+	{
+		return Result;
+	}
+
+	TArray<FVector> Path;
+	Path.Add(Start);
+
+	// --- Same room: plain grid A* ---
+	TArray<FVector> LegPoints;
+	if (StartRoom == GoalRoom && FindRoomLeg(Rooms[StartRoom], StartCell, GoalCell, LegPoints))
+	{
+		AppendPoints(Path, LegPoints);
+	}
+	else
+	{
+		// --- Room graph: A* over door portals ---
+		// Costs from the start cell to every start-room portal and from every goal-room portal to the goal cell
+		TArray<float> StartField, GoalField;
+		TArray<int32> Parent;
+		SearchGrid(Rooms[StartRoom], StartCell, nullptr, StartField, Parent);
+		SearchGrid(Rooms[GoalRoom], GoalCell, nullptr, GoalField, Parent);
+
+		const int32 GoalNode = NumPortalNodes;
+		TArray<float> G;
+		TArray<int32> NodeParent;
+		G.Init(MAX_flt, NumPortalNodes + 1);
+		NodeParent.Init(INDEX_NONE, NumPortalNodes + 1);
+		TBitArray<> Closed(false, NumPortalNodes + 1);
+		TArray<FOpenNode> Open;
+
+		auto PortalCellCost = [](const FDungeonPathRoom& Room, const TArray<float>& Field, const FDungeonPathPortal& Portal)
+		{
+			return Room.IsWalkable(Portal.Cell.X, Portal.Cell.Y) ? Field[Portal.Cell.Y * Room.GridSize.X + Portal.Cell.X] : MAX_flt;
+		};
+
+		auto Relax = [&](int32 Node, int32 FromNode, float Cost, const FVector& NodeLocation)
+		{
+			if (Cost < G[Node] && !Closed[Node])
+			{
+				G[Node] = Cost;
+				NodeParent[Node] = FromNode;
+				Open.HeapPush({ Node, Cost + (Node == GoalNode ? 0.0f : (float)FVector::Dist(NodeLocation, End)) }, FOpenNodePredicate());
+			}
+		};
+
+		const FDungeonPathRoom& StartPathRoom = Rooms[StartRoom];
+		for (int32 p = 0; p < StartPathRoom.Portals.Num(); ++p)
+		{
+			const float Cost = PortalCellCost(StartPathRoom, StartField, StartPathRoom.Portals[p]);
+			if (Cost < MAX_flt)
+			{
+				Relax(PortalOffsets[StartRoom] + p, INDEX_NONE, Cost, StartPathRoom.Portals[p].WorldLocation);
+			}
+		}
+
+		// Node -> (room, portal) lookup
+		auto NodeToPortal = [this](int32 Node, int32& OutRoom, int32& OutPortal)
+		{
+			OutRoom = Algo::UpperBound(PortalOffsets, Node) - 1;
+			OutPortal = Node - PortalOffsets[OutRoom];
+		};
+
+		bool bFoundGoal = false;
+		while (Open.Num() > 0)
+		{
+			FOpenNode Node;
+			Open.HeapPop(Node, FOpenNodePredicate(), EAllowShrinking::No);
+			if (Closed[Node.Index]) continue;
+			Closed[Node.Index] = true;
+
+			if (Node.Index == GoalNode)
+			{
+				bFoundGoal = true;
+				break;
+			}
+
+			int32 RoomIndex, PortalIndex;
+			NodeToPortal(Node.Index, RoomIndex, PortalIndex);
+			const FDungeonPathRoom& Room = Rooms[RoomIndex];
+			const FDungeonPathPortal& Portal = Room.Portals[PortalIndex];
+			const float NodeCost = G[Node.Index];
+
+			// Finish inside the goal room
+			if (RoomIndex == GoalRoom)
+			{
+				const float GoalCost = PortalCellCost(Room, GoalField, Portal);
+				if (GoalCost < MAX_flt)
+				{
+					Relax(GoalNode, Node.Index, NodeCost + GoalCost, End);
+				}
+			}
+
+			// Step through the door into the neighbouring room
+			if (Portal.LinkedRoom != INDEX_NONE)
+			{
+				const FDungeonPathPortal& Linked = Rooms[Portal.LinkedRoom].Portals[Portal.LinkedPortal];
+				Relax(PortalOffsets[Portal.LinkedRoom] + Portal.LinkedPortal, Node.Index,
+					NodeCost + FVector::Dist(Portal.WorldLocation, Linked.WorldLocation), Linked.WorldLocation);
+			}
+
+			// Cross this room to one of its other doors
+			const int32 NumPortals = Room.Portals.Num();
+			for (int32 Other = 0; Other < NumPortals; ++Other)
+			{
+				const float Distance = Room.PortalDistances[PortalIndex * NumPortals + Other];
+				if (Other != PortalIndex && Distance < MAX_flt)
+				{
+					Relax(PortalOffsets[RoomIndex] + Other, Node.Index, NodeCost + Distance, Room.Portals[Other].WorldLocation);
+				}
+			}
+		}
+
+		if (!bFoundGoal)
+		{
+			return Result;
+		}
+
+		// Portal chain, start to goal
+		TArray<int32> Chain;
+		for (int32 Node = NodeParent[GoalNode]; Node != INDEX_NONE; Node = NodeParent[Node])
+		{
+			Chain.Add(Node);
+		}
+		Algo::Reverse(Chain);
+
+		// Stitch the in-room legs: start -> first portal, portal -> portal inside each room, last portal -> goal
+		int32 CurrentRoom = StartRoom;
+		FIntPoint CurrentCell = StartCell;
+		for (int32 Node : Chain)
+		{
+			int32 RoomIndex, PortalIndex;
+			NodeToPortal(Node, RoomIndex, PortalIndex);
+			const FIntPoint PortalCell = Rooms[RoomIndex].Portals[PortalIndex].Cell;
+
+			if (RoomIndex == CurrentRoom)
+			{
+				LegPoints.Reset();
+				if (!FindRoomLeg(Rooms[RoomIndex], CurrentCell, PortalCell, LegPoints)) return Result;
+				AppendPoints(Path, LegPoints);
+			}
+			else
+			{
+				// Crossed a door - continue from the portal cell on the other side
+				AppendPoints(Path, { CellToWorld(Rooms[RoomIndex], PortalCell) });
+			}
+			CurrentRoom = RoomIndex;
+			CurrentCell = PortalCell;
+		}
+
+		LegPoints.Reset();
+		if (!FindRoomLeg(Rooms[GoalRoom], CurrentCell, GoalCell, LegPoints)) return Result;
+		AppendPoints(Path, LegPoints);
+	}
+
+	AppendPoints(Path, { End });
+
+	Result.bSuccess = true;
+	for (int32 i = 1; i < Path.Num(); ++i)
+	{
+		Result.Length += FVector::Dist(Path[i - 1], Path[i]);
+	}
+	Result.Points = MoveTemp(Path);
+	return Result;
+}
+
+void UDungeonPathfindingSubsystem::FindPaths(TConstArrayView<FDungeonPathQuery> Queries, TArray<FDungeonPathResult>& OutResults) const
+{
+	OutResults.Reset();
+	OutResults.SetNum(Queries.Num());
+
+	// Room snapshots are read-only during queries, so every request can run on its own worker
+	ParallelFor(Queries.Num(), [this, &Queries, &OutResults](int32 Index)
+	{
+		OutResults[Index] = FindPath(Queries[Index].Start, Queries[Index].End);
+	});
+}
@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Rooms/FreeRectIndex.h"
+
+namespace FreeRectIndex
+{
+	static bool Overlaps(const FIntRect& A, const FIntRect& B)
+	{
+		return A.Min.X < B.Max.X && B.Min.X < A.Max.X && A.Min.Y < B.Max.Y && B.Min.Y < A.Max.Y;
+	}
+
+	static bool IsContainedIn(const FIntRect& Inner, const FIntRect& Outer)
+	{
+		return Inner.Min.X >= Outer.Min.X && Inner.Min.Y >= Outer.Min.Y && Inner.Max.X <= Outer.Max.X && Inner.Max.Y <= Outer.Max.Y;
+	}
+}
+
+void FFreeRectIndex::Init(FIntPoint GridSize)
+{
+	FreeRects.Reset();
+	if (GridSize.X > 0 && GridSize.Y > 0)
+	{
+		FreeRects.Emplace(0, 0, GridSize.X, GridSize.Y);
+	}
+}
+
+void FFreeRectIndex::Block(const FIntRect& Rect)
+{
+	if (Rect.Width() <= 0 || Rect.Height() <= 0) return;
+
+	// Split every overlapped rectangle into its free sides (they overlap each other - that's what keeps them maximal)
+	TArray<FIntRect, TInlineAllocator<16>> Split;
+	for (int32 i = FreeRects.Num() - 1; i >= 0; --i)
+	{
+		const FIntRect Free = FreeRects[i];
+		if (!FreeRectIndex::Overlaps(Free, Rect)) continue;
+
+		if (Rect.Min.X > Free.Min.X) Split.Emplace(Free.Min.X, Free.Min.Y, Rect.Min.X, Free.Max.Y);	// South side
+		if (Rect.Max.X < Free.Max.X) Split.Emplace(Rect.Max.X, Free.Min.Y, Free.Max.X, Free.Max.Y);	// North side
+		if (Rect.Min.Y > Free.Min.Y) Split.Emplace(Free.Min.X, Free.Min.Y, Free.Max.X, Rect.Min.Y);	// West side
+		if (Rect.Max.Y < Free.Max.Y) Split.Emplace(Free.Min.X, Rect.Max.Y, Free.Max.X, Free.Max.Y);	// East side
+
+		FreeRects.RemoveAtSwap(i, EAllowShrinking::No);
+	}
+
+	if (Split.Num() == 0) return;
+
+	const int32 FirstNew = FreeRects.Num();
+	FreeRects.Append(Split);
+	Prune(FirstNew);
+}
+
+void FFreeRectIndex::BlockMask(FIntPoint GridSize, const TBitArray<>& Mask)
+{
+	if (Mask.Num() != GridSize.X * GridSize.Y) return;
+
+	for (int32 Y = 0; Y < GridSize.Y; ++Y)
+	{
+		for (int32 X = 0; X < GridSize.X; )
+		{
+			if (!Mask[Y * GridSize.X + X])
+			{
+				++X;
+				continue;
+			}
+
+			// One obstacle per horizontal run keeps the number of splits down to the number of runs
+			int32 RunEnd = X + 1;
+			while (RunEnd < GridSize.X && Mask[Y * GridSize.X + RunEnd])
+			{
+				++RunEnd;
+			}
+			Block(FIntRect(X, Y, RunEnd, Y + 1));
+			X = RunEnd;
+		}
+	}
+}
+
+void FFreeRectIndex::FindFitting(FIntPoint Size, TArray<int32>& OutIndices) const
+{
+	OutIndices.Reset();
+	for (int32 i = 0; i < FreeRects.Num(); ++i)
+	{
+		if (FreeRects[i].Width() >= Size.X && FreeRects[i].Height() >= Size.Y)
+		{
+			OutIndices.Add(i);
+		}
+	}
+}
+
+void FFreeRectIndex::Prune(int32 FirstNew)
+{
+	// The old rectangles were already maximal among themselves - only pairs with a new one can nest
+	for (int32 i = FreeRects.Num() - 1; i >= FirstNew; --i)
+	{
+		bool bContained = false;
+		for (int32 j = 0; j < FreeRects.Num() && !bContained; ++j)
+		{
+			if (i == j) continue;
+
+			// Identical rectangles: keep the one with the lower index
+			bContained = FreeRectIndex::IsContainedIn(FreeRects[i], FreeRects[j]) && (FreeRects[i] != FreeRects[j] || j < i);
+		}
+
+		if (bContained)
+		{
+			FreeRects.RemoveAt(i, EAllowShrinking::No);
+		}
+	}
+}
@@ -2,14 +2,24 @@
 
 
 #include "DungeonGen/Rooms/MasterRoom.h"
+#include "DungeonGen/Rooms/RoomLayoutCache.h"
+#include "DungeonGen/Rooms/RoomBoundary.h"
+#include "DungeonGen/Rooms/FreeRectIndex.h"
+#include "DungeonGen/Doors/Doorway.h"
+#include "DungeonGen/Navigation/DungeonPathfinding.h"
+#include "DungeonGen/Navigation/DungeonNavGeometryComponent.h"
+#include "DungeonGen/Visibility/DungeonVisibility.h"
 #include "Net/UnrealNetwork.h"
-#include "DrawDebugHelpers.h" // Needed for debug drawing
-#include "Data/Room/FloorData.h"
+#include "DungeonGen/Debug/DungeonDebugGridComponent.h"
 #include "Data/Room/RoomData.h"
-#include "Data/Room/WallData.h"
-#include "Data/Room/CeilingData.h"
+#include "Data/Room/DoorData.h"
 #include "Data/Room/RoomShapePreset.h"
-#include "Engine/StaticMeshSocket.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Hash/CityHash.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "TimerManager.h"
 
 
 // Sets default values
@@ -25,205 +35,1479 @@ void AMasterRoom::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& Ou
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 	DOREPLIFETIME(AMasterRoom, GenerationSeed);
+	DOREPLIFETIME(AMasterRoom, ReplicatedOverrides);
+	DOREPLIFETIME(AMasterRoom, ReplicatedLayoutHash);
+}
+
+// ==================================================================================
+// CLIENT-SIDE GENERATION (Replicated Seed + Override Blob)
+// ==================================================================================
+
+namespace RoomOverrideSerialization
+{
+	// Bumped whenever the override blob layout changes
+	static constexpr uint8 OverrideBlobVersion = 3;
+	
+	// Override groups, serialized and replicated as units
+	// Doors come after ProceduralDoors so the reader knows whether fixed doors are designer input
+	enum EOverrideGroup : int32
+	{
+		OG_Assets,
+		OG_Floor,
+		OG_Walls,
+		OG_ProceduralDoors,
+		OG_Doors,
+		OG_Num
+	};
+	
+	static constexpr uint8 AllOverrideGroups = (1 << OG_Num) - 1;
+
+	static void SerializeSoftPath(FArchive& Ar, FSoftObjectPath& Path)
+	{
+		FString PathString = Path.ToString();
+		Ar << PathString;
+		if (Ar.IsLoading())
+		{
+			Path.SetPath(PathString);
+		}
+	}
+
+	template<typename T>
+	static void SerializeObjectRef(FArchive& Ar, T*& Object)
+	{
+		FSoftObjectPath Path(Object);
+		SerializeSoftPath(Ar, Path);
+		if (Ar.IsLoading())
+		{
+			Object = Cast<T>(Path.TryLoad());
+		}
+	}
+
+	template<typename T>
+	static void SerializeSoftPtr(FArchive& Ar, TSoftObjectPtr<T>& Ptr)
+	{
+		FSoftObjectPath Path = Ptr.ToSoftObjectPath();
+		SerializeSoftPath(Ar, Path);
+		if (Ar.IsLoading())
+		{
+			Ptr = TSoftObjectPtr<T>(Path);
+		}
+	}
+
+	static void SerializeEdge(FArchive& Ar, EWallEdge& Edge)
+	{
+		uint8 EdgeByte = (uint8)Edge;
+		Ar << EdgeByte;
+		Edge = (EWallEdge)EdgeByte;
+	}
+
+	static void SerializeBool(FArchive& Ar, bool& bValue)
+	{
+		uint8 Byte = bValue ? 1 : 0;
+		Ar << Byte;
+		bValue = Byte != 0;
+	}
+
+	static void SerializeMeshPlacementInfo(FArchive& Ar, FMeshPlacementInfo& Info)
+	{
+		SerializeSoftPtr(Ar, Info.MeshAsset);
+		Ar << Info.GridFootprint;
+		Ar << Info.PlacementWeight;
+		Ar << Info.AllowedRotations;
+		Ar << Info.CustomData;
+	}
+
+	static void SerializeWallModule(FArchive& Ar, FWallModule& Module)
+	{
+		Ar << Module.Y_AxisFootprint;
+		SerializeSoftPtr(Ar, Module.BaseMesh);
+		SerializeSoftPtr(Ar, Module.Middle1Mesh);
+		SerializeSoftPtr(Ar, Module.Middle2Mesh);
+		SerializeSoftPtr(Ar, Module.TopMesh);
+		Ar << Module.PlacementWeight;
+		Ar << Module.CustomData;
+	}
+
+	// Serializes a TArray element-by-element with a custom element serializer
+	template<typename T, typename FuncType>
+	static void SerializeArray(FArchive& Ar, TArray<T>& Array, FuncType&& SerializeElement)
+	{
+		int32 Num = Array.Num();
+		Ar << Num;
+		if (Ar.IsLoading())
+		{
+			Array.Reset(Num);
+			Array.SetNum(Num);
+		}
+		for (T& Element : Array)
+		{
+			SerializeElement(Ar, Element);
+		}
+	}
+}
+
+void AMasterRoom::SerializeGenerationOverrides(FArchive& Ar)
+{
+	using namespace RoomOverrideSerialization;
+	
+	uint8 Version = OverrideBlobVersion;
+	Ar << Version;
+	if (Ar.IsLoading() && Version != OverrideBlobVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: Override blob version %d not supported (expected %d)"), *GetName(), Version, OverrideBlobVersion);
+		Ar.SetError();
+		return;
+	}
+	
+	for (int32 Group = 0; Group < OG_Num; ++Group)
+	{
+		SerializeOverrideGroup(Ar, Group);
+	}
+	SerializeSealedDoors(Ar);
+}
+
+void AMasterRoom::SerializeReplicatedOverrides(FArchive& Ar)
+{
+	using namespace RoomOverrideSerialization;
+	
+	uint8 Version = OverrideBlobVersion;
+	Ar << Version;
+	if (Ar.IsLoading() && Version != OverrideBlobVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: Override blob version %d not supported (expected %d)"), *GetName(), Version, OverrideBlobVersion);
+		Ar.SetError();
+		return;
+	}
+	
+	// Only the groups changed at runtime - the rest is already on the client (saved in the map)
+	// Procedural doors are solved from the seed on every machine and never sent
+	uint8 Groups = 0;
+	if (Ar.IsSaving())
+	{
+		Groups = GetChangedOverrideGroups();
+		if (bEnableProceduralDoors)
+		{
+			Groups &= ~(1 << OG_Doors);
+		}
+	}
+	Ar << Groups;
+	if (Ar.IsLoading() && (Groups & ~AllOverrideGroups))
+	{
+		Ar.SetError();
+		return;
+	}
+	
+	for (int32 Group = 0; Group < OG_Num; ++Group)
+	{
+		if (Groups & (1 << Group))
+		{
+			SerializeOverrideGroup(Ar, Group);
+		}
+	}
+	SerializeSealedDoors(Ar);
+}
+
+void AMasterRoom::SerializeOverrideGroup(FArchive& Ar, int32 Group)
+{
+	using namespace RoomOverrideSerialization;
+	
+	switch (Group)
+	{
+	case OG_Assets:
+		// Style and shape assets
+		SerializeObjectRef(Ar, RoomData);
+		SerializeObjectRef(Ar, ShapePreset);
+		break;
+		
+	case OG_Floor:
+	{
+		SerializeArray(Ar, ForcedEmptyRegions, [](FArchive& A, FForcedEmptyRegion& Region)
+		{
+			A << Region.StartCell;
+			A << Region.EndCell;
+		});
+		Ar << ForcedEmptyFloorCells;
+		
+		// ForcedInteriorPlacements: written in map iteration order and re-added in the same order,
+		// so the placement order (and the random stream draws for rotations) match the server
+		int32 NumForcedPlacements = ForcedInteriorPlacements.Num();
+		Ar << NumForcedPlacements;
+		if (Ar.IsLoading())
+		{
+			ForcedInteriorPlacements.Empty(NumForcedPlacements);
+			for (int32 i = 0; i < NumForcedPlacements; ++i)
+			{
+				FIntPoint Cell;
+				FMeshPlacementInfo Info;
+				Ar << Cell;
+				SerializeMeshPlacementInfo(Ar, Info);
+				ForcedInteriorPlacements.Add(Cell, Info);
+			}
+		}
+		else
+		{
+			for (auto& Pair : ForcedInteriorPlacements)
+			{
+				FIntPoint Cell = Pair.Key;
+				Ar << Cell;
+				SerializeMeshPlacementInfo(Ar, Pair.Value);
+			}
+		}
+		break;
+	}
+		
+	case OG_Walls:
+		SerializeArray(Ar, ForcedWalls, [](FArchive& A, FForcedWallPlacement& Wall)
+		{
+			SerializeEdge(A, Wall.Edge);
+			A << Wall.StartCell;
+			SerializeWallModule(A, Wall.WallModule);
+		});
+		break;
+		
+	case OG_ProceduralDoors:
+		SerializeBool(Ar, bEnableProceduralDoors);
+		Ar << MinProceduralDoors;
+		Ar << MaxProceduralDoors;
+		SerializeArray(Ar, RequiredDoorEdges, [](FArchive& A, EWallEdge& Edge)
+		{
+			SerializeEdge(A, Edge);
+		});
+		break;
+		
+	case OG_Doors:
+		SerializeArray(Ar, FixedDoorLocations, [](FArchive& A, FFixedDoorLocation& Door)
+		{
+			SerializeEdge(A, Door.WallEdge);
+			A << Door.StartCell;
+			SerializeObjectRef(A, Door.DoorData);
+			A << Door.DoorPositionOffsets.FramePositionOffset;
+			A << Door.DoorPositionOffsets.ActorPositionOffset;
+		});
+		break;
+		
+	default:
+		break;
+	}
+}
+
+void AMasterRoom::SerializeSealedDoors(FArchive& Ar)
+{
+	using namespace RoomOverrideSerialization;
+	
+	// DungeonManager seals - runtime state, always part of the blob
+	SerializeArray(Ar, SealedDoors, [](FArchive& A, FSealedDoorSlot& Slot)
+	{
+		SerializeEdge(A, Slot.WallEdge);
+		A << Slot.StartCell;
+	});
+}
+
+uint32 AMasterRoom::HashOverrideGroup(int32 Group)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	SerializeOverrideGroup(Writer, Group);
+	return FCrc::MemCrc32(Bytes.GetData(), Bytes.Num());
+}
+
+void AMasterRoom::CaptureOverrideBaseline()
+{
+	using namespace RoomOverrideSerialization;
+	
+	OverrideBaselineHashes.SetNum(OG_Num);
+	for (int32 Group = 0; Group < OG_Num; ++Group)
+	{
+		OverrideBaselineHashes[Group] = HashOverrideGroup(Group);
+	}
+	ChangedOverrideGroups = 0;
+}
+
+uint8 AMasterRoom::GetChangedOverrideGroups()
+{
+	using namespace RoomOverrideSerialization;
+	
+	// Rooms spawned at runtime have no map-saved state on the client - everything is sent
+	if (!IsNetStartupActor() || OverrideBaselineHashes.Num() != OG_Num)
+	{
+		return AllOverrideGroups;
+	}
+	
+	// Sticky: a group changed once keeps being sent, so changing it back also reaches the client
+	for (int32 Group = 0; Group < OG_Num; ++Group)
+	{
+		if (!(ChangedOverrideGroups & (1 << Group)) && HashOverrideGroup(Group) != OverrideBaselineHashes[Group])
+		{
+			ChangedOverrideGroups |= 1 << Group;
+		}
+	}
+	return ChangedOverrideGroups;
+}
+
+uint64 AMasterRoom::ComputeLayoutHash() const
+{
+	// Meshes are visited in path-name order so the hash does not depend on queue (or HISM creation) order
+	TArray<TPair<FString, const FQueuedInstanceBatch*>> SortedBatches;
+	for (const auto& Pair : QueuedInstances)
+	{
+		if (Pair.Key)
+		{
+			SortedBatches.Emplace(Pair.Key->GetPathName(), &Pair.Value);
+		}
+	}
+	
+	// Clutter batches are separate from the room batches of the same mesh
+	for (const auto& Pair : QueuedClutterInstances)
+	{
+		if (Pair.Key)
+		{
+			SortedBatches.Emplace(TEXT("Clutter:") + Pair.Key->GetPathName(), &Pair.Value);
+		}
+	}
+	SortedBatches.Sort([](const TPair<FString, const FQueuedInstanceBatch*>& A, const TPair<FString, const FQueuedInstanceBatch*>& B)
+	{
+		return A.Key < B.Key;
+	});
+	
+	uint64 Hash = 0;
+	TArray<int32> Quantized;
+	for (const auto& Pair : SortedBatches)
+	{
+		const FTCHARToUTF8 MeshName(*Pair.Key);
+		Hash = CityHash64WithSeed(MeshName.Get(), MeshName.Length(), Hash);
+		
+		// Quantize to 0.1cm / 1e-4 so tiny float differences between platforms don't break verification
+		const FQueuedInstanceBatch& Batch = *Pair.Value;
+		Quantized.Reset(Batch.Transforms.Num() * 10 + Batch.CustomData.Num());
+		for (const FTransform& Transform : Batch.Transforms)
+		{
+			const FVector Location = Transform.GetLocation();
+			// q and -q are the same rotation - canonicalize to W >= 0
+			FQuat Rotation = Transform.GetRotation().GetNormalized();
+			if (Rotation.W < 0.0)
+			{
+				Rotation = FQuat(-Rotation.X, -Rotation.Y, -Rotation.Z, -Rotation.W);
+			}
+			const FVector Scale = Transform.GetScale3D();
+			Quantized.Add(FMath::RoundToInt(Location.X * 10.0));
+			Quantized.Add(FMath::RoundToInt(Location.Y * 10.0));
+			Quantized.Add(FMath::RoundToInt(Location.Z * 10.0));
+			Quantized.Add(FMath::RoundToInt(Rotation.X * 10000.0));
+			Quantized.Add(FMath::RoundToInt(Rotation.Y * 10000.0));
+			Quantized.Add(FMath::RoundToInt(Rotation.Z * 10000.0));
+			Quantized.Add(FMath::RoundToInt(Rotation.W * 10000.0));
+			Quantized.Add(FMath::RoundToInt(Scale.X * 1000.0));
+			Quantized.Add(FMath::RoundToInt(Scale.Y * 1000.0));
+			Quantized.Add(FMath::RoundToInt(Scale.Z * 1000.0));
+		}
+		
+		// Mesh variants: the custom data floats are part of the layout too
+		for (const float Value : Batch.CustomData)
+		{
+			Quantized.Add(FMath::RoundToInt(Value * 1000.0f));
+		}
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Quantized.GetData()), Quantized.Num() * sizeof(int32), Hash);
+	}
+	
+	return Hash;
+}
+
+uint64 AMasterRoom::ComputeLayoutCacheKey()
+{
+	// Procedural mode rebuilds FixedDoorLocations on every solve - they are the last solve's output, not
+	// designer input, and hashing them would give the same room a new key (and a new cache file) each run
+	TGuardValue<TArray<FFixedDoorLocation>> SolvedDoorsGuard(FixedDoorLocations,
+		bEnableProceduralDoors ? TArray<FFixedDoorLocation>() : FixedDoorLocations);
+	
+	// Inputs not covered by the data assets: versions, seed and the designer override blob
+	TArray<uint8> InputBlob;
+	FMemoryWriter Writer(InputBlob);
+	uint32 GeneratorVersion = FRoomLayoutCache::GeneratorVersion;
+	uint16 LayoutVersion = FRoomLayout::Version;
+	Writer << GeneratorVersion;
+	Writer << LayoutVersion;
+	Writer << GenerationSeed;
+	SerializeGenerationOverrides(Writer);
+	
+	uint64 Key = CityHash64(reinterpret_cast<const char*>(InputBlob.GetData()), InputBlob.Num());
+	
+	// Content of every data asset the solver reads - editing any of them must miss the cache
+	// (the blob above only stores their paths). The style assets are hashed through the room's compiled
+	// tables, which hold everything the solver reads from them and are all a cooked build has.
+	if (RoomData)
+	{
+		TArray<uint8> CompiledBytes;
+		RoomData->GetCompiledTables().Encode(CompiledBytes);
+		Key = CityHash64WithSeed(reinterpret_cast<const char*>(CompiledBytes.GetData()), CompiledBytes.Num(), Key);
+	}
+	
+	TArray<const UObject*> Assets;
+	Assets.Add(RoomData);
+	Assets.Add(ShapePreset);
+	for (const FFixedDoorLocation& DoorLoc : FixedDoorLocations)
+	{
+		Assets.AddUnique(DoorLoc.DoorData);
+	}
+	
+	for (const UObject* Asset : Assets)
+	{
+		Key = FRoomLayoutCache::HashObjectProperties(Asset, Key);
+	}
+	
+	return Key;
+}
+
+void AMasterRoom::ClearLayoutCache()
+{
+	FRoomLayoutCache::Clear();
+}
+
+void AMasterRoom::OnRep_GenerationState()
+{
+	if (!bClientSideGeneration || HasAuthority() || bClientRegenerationPending) return;
+	
+	// Seed, blob and hash usually arrive together - regenerate once on the next tick
+	if (UWorld* World = GetWorld())
+	{
+		bClientRegenerationPending = true;
+		World->GetTimerManager().SetTimerForNextTick(this, &AMasterRoom::ApplyReplicatedGenerationState);
+	}
+}
+
+void AMasterRoom::ApplyReplicatedGenerationState()
+{
+	bClientRegenerationPending = false;
+	
+	// Wait until the server has published its overrides (the layout hash follows once it has built the room)
+	if (ReplicatedOverrides.Num() == 0) return;
+	
+	// Only the server's layout hash changed (it built the room after us) - nothing to regenerate
+	const uint32 StateCrc = FCrc::MemCrc32(ReplicatedOverrides.GetData(), ReplicatedOverrides.Num(), (uint32)GenerationSeed);
+	if (bHasReplicatedGenerationState && StateCrc == AppliedGenerationStateCrc)
+	{
+		VerifyReplicatedLayoutHash();
+		return;
+	}
+	
+	FMemoryReader Reader(ReplicatedOverrides);
+	SerializeReplicatedOverrides(Reader);
+	if (Reader.IsError())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: Failed to read replicated generation overrides (%d bytes)"), *GetName(), ReplicatedOverrides.Num());
+		return;
+	}
+	bHasReplicatedGenerationState = true;
+	AppliedGenerationStateCrc = StateCrc;
+	
+	// Streamed rooms keep the state and build when they stream in
+	if (bDeferGenerationToStreaming && !bIsGenerated) return;
+	
+	RegenerateRoom();
+}
+
+void AMasterRoom::VerifyReplicatedLayoutHash() const
+{
+	if (HasAuthority() || !bIsGenerated || ReplicatedLayoutHash == 0) return;
+	
+	if (LocalLayoutHash != ReplicatedLayoutHash)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: Client layout hash mismatch (local %016llx, server %016llx, seed %d) - room content differs from the server"),
+			*GetName(), LocalLayoutHash, ReplicatedLayoutHash, GenerationSeed);
+	}
 }
 
 // --- Editor Debug/Button Logic ---
 
-void AMasterRoom::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+void AMasterRoom::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Check if the property that changed was 'bGenerateRoom'
+	FName PropertyName = (PropertyChangedEvent.Property != nullptr) ? PropertyChangedEvent.Property->GetFName() : NAME_None;
+
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(AMasterRoom, bGenerateRoom))
+	{
+		if (bGenerateRoom)
+		{
+			CancelScheduledRegeneration();
+			RegenerateRoom();
+			bGenerateRoom = false; // Reset the button immediately after execution
+		}
+		return;
+	}
+	
+	// Edits to the editor/debug toggles themselves never regenerate
+	const FName MemberName = PropertyChangedEvent.GetMemberPropertyName();
+	const bool bIsEditorSetting = MemberName == GET_MEMBER_NAME_CHECKED(AMasterRoom, bShowDebugGrid)
+		|| MemberName == GET_MEMBER_NAME_CHECKED(AMasterRoom, bAutoRegenerateOnEdit)
+		|| MemberName == GET_MEMBER_NAME_CHECKED(AMasterRoom, RegenerateDebounceDelay);
+	
+	if (bAutoRegenerateOnEdit && !bIsEditorSetting && RoomData && GetWorld() && !GetWorld()->IsGameWorld())
+	{
+		// Every edit (each drag step included) gets an instant preview; only committed edits
+		// (re)arm the full build, so a drag never builds instances until it's released
+		PreviewLayout();
+		if (PropertyChangedEvent.ChangeType & EPropertyChangeType::Interactive)
+		{
+			CancelScheduledRegeneration();
+		}
+		else
+		{
+			ScheduleRegeneration();
+		}
+		return;
+	}
+	
+	// IMPORTANT: Call the debug drawing here so it updates instantly in the editor
+	if (GIsEditor)
+	{
+		DrawDebugGrid();
+	}
+}
+
+void AMasterRoom::PreviewLayout()
+{
+	// Stale instances would contradict the preview - drop them until the full build
+	ClearAndResetComponents();
+	bIsGenerated = false;
+	
+	SolveLayout();
+	
+	bShowingLayoutPreview = true;
+	DrawDebugGrid();
+}
+
+void AMasterRoom::ScheduleRegeneration()
+{
+	CancelScheduledRegeneration();
+	
+	// Core ticker: runs in editor worlds, which don't tick their timer managers outside of play
+	PendingRegenerationHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+	{
+		PendingRegenerationHandle.Reset();
+		RegenerateRoom();
+		return false;	// One-shot
+	}), RegenerateDebounceDelay);
+}
+
+void AMasterRoom::CancelScheduledRegeneration()
+{
+	if (PendingRegenerationHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(PendingRegenerationHandle);
+		PendingRegenerationHandle.Reset();
+	}
+}
+
+// --- Region Expansion Logic ---
+
+void AMasterRoom::BuildForcedEmptyMask(FRoomShapeMask& OutMask) const
+{
+	OutMask.Init(RoomData ? RoomData->GridSize : FIntPoint::ZeroValue);
+	if (!RoomData) return;
+
+	// 0. Apply ShapePreset if assigned (cached per grid size - a word-wide OR, then manual overrides add to it)
+	if (ShapePreset)
+	{
+		OutMask.Combine(ShapePreset->GetShapeMask(OutMask.GridSize));
+	}
+
+	// 1. Rectangular regions (manual overrides) - any corner order, clamped to the grid
+	for (const FForcedEmptyRegion& Region : ForcedEmptyRegions)
+	{
+		OutMask.AddRegion(Region);
+	}
+
+	// 2. Individual forced empty cells (manual overrides, out-of-grid cells are ignored)
+	for (const FIntPoint& Cell : ForcedEmptyFloorCells)
+	{
+		OutMask.AddCell(Cell);
+	}
+}
+
+bool AMasterRoom::CanGenerate() const
+{
+	// Only the server or the editor should run generation,
+	// unless client-side generation is enabled and the server's overrides have been received
+	const bool bIsAuthority = GetLocalRole() == ROLE_Authority || IsEditorOnly() || GIsEditor;
+	return bIsAuthority || (bClientSideGeneration && bHasReplicatedGenerationState);
+}
+
+void AMasterRoom::RegenerateRoom()
+{
+	LLM_SCOPE_BYTAG(DungeonGen);
+	
+	if (!CanGenerate())
+	{
+		return;
+	}
+
+	if (!RoomData)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ADungeonMasterRoom: RoomData is null. Cannot generate."));
+		return;
+	}
+	
+	PublishReplicatedOverrides();
+	
+	// 1. Clean up and prepare for a new generation pass
+	ClearAndResetComponents();
+
+	// 2. Solve the layout (grid state + layout records only, no components touched)
+	const bool bLayoutFromCache = SolveOrLoadLayout();
+	
+	// 3. Decode the layout into per-mesh instance arrays and upload them
+	if (!BuildFromLayout(CurrentLayout) && bLayoutFromCache)
+	{
+		// Cached entry doesn't fit this room after all - fall back to a fresh solve
+		SolveLayout();
+		BuildFromLayout(CurrentLayout);
+	}
+	
+	FinishGeneration();
+}
+
+void AMasterRoom::SolveRoom()
+{
+	// A built room regenerates so its instances follow the new doors
+	if (bIsGenerated)
+	{
+		RegenerateRoom();
+		return;
+	}
+	
+	LLM_SCOPE_BYTAG(DungeonGen);
+	
+	if (!CanGenerate() || !RoomData) return;
+	
+	PublishReplicatedOverrides();
+	
+	DoorConnectionPoints.Empty();
+	InternalGridState.Init(EGridCellType::ECT_Empty, RoomData->GridSize.X * RoomData->GridSize.Y);
+	SolveOrLoadLayout();
+	
+	TArray<FFixedDoorLocation> LayoutDoors;
+	TArray<FCompiledDoorFrame> LayoutDoorFrames;
+	ResolveLayoutDoors(CurrentLayout, LayoutDoors, LayoutDoorFrames);
+	BuildDoorConnectionPoints(LayoutDoors, LayoutDoorFrames);
+	
+	// Nothing is built - the grid state is rebuilt with the room
+	InternalGridState.Empty();
+	
+	// Portal links through this room resolve before it streams in
+	if (UDungeonVisibilitySubsystem* Visibility = GetWorld() ? GetWorld()->GetSubsystem<UDungeonVisibilitySubsystem>() : nullptr)
+	{
+		Visibility->UpdateRoom(this);
+	}
+}
+
+void AMasterRoom::PublishReplicatedOverrides()
+{
+	// Server: publish the generation inputs the clients don't have so they can regenerate locally
+	// (procedural doors are derived from the seed on every machine and are never sent)
+	if (bClientSideGeneration && HasAuthority())
+	{
+		TArray<uint8> OverrideBlob;
+		FMemoryWriter Writer(OverrideBlob);
+		SerializeReplicatedOverrides(Writer);
+		ReplicatedOverrides = MoveTemp(OverrideBlob);
+	}
+}
+
+bool AMasterRoom::SolveOrLoadLayout()
+{
+	// Identical inputs always solve to the same layout, so a cached one is reused when available
+	bool bLayoutFromCache = false;
+	uint64 CacheKey = 0;
+	if (bUseLayoutCache)
+	{
+		CacheKey = ComputeLayoutCacheKey();
+		bLayoutFromCache = FRoomLayoutCache::Load(CacheKey, CurrentLayout);
+	}
+	
+	if (!bLayoutFromCache)
+	{
+		SolveLayout();
+		if (bUseLayoutCache)
+		{
+			FRoomLayoutCache::Store(CacheKey, CurrentLayout);
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s: Layout cache hit (%016llx) - solver skipped"), *GetName(), CacheKey);
+	}
+	return bLayoutFromCache;
+}
+
+void AMasterRoom::FinishGeneration()
+{
+	// Force bounding box updates on all new and existing components
+	for (const auto* HISMMap : { &MeshToHISMMap, &ClutterHISMMap })
+	{
+		for (const auto& Pair : *HISMMap)
+		{
+			if (UHierarchicalInstancedStaticMeshComponent* HISM = Pair.Value)
+			{
+				// Forces the component to re-evaluate its spatial boundaries based on new instances
+				HISM->UpdateBounds(); 
+				HISM->MarkRenderStateDirty(); // Ensures the rendering thread picks up the change
+			}
+		}
+	}
+
+	// LocalLayoutHash was taken from the instance queue by FlushQueuedInstances
+	bIsGenerated = true;
+	bShowingLayoutPreview = false;
+	
+	// Paths through this room reflect the new layout immediately
+	if (UDungeonPathfindingSubsystem* Pathfinding = GetWorld() ? GetWorld()->GetSubsystem<UDungeonPathfindingSubsystem>() : nullptr)
+	{
+		Pathfinding->UpdateRoom(this);
+	}
+	if (UDungeonVisibilitySubsystem* Visibility = GetWorld() ? GetWorld()->GetSubsystem<UDungeonVisibilitySubsystem>() : nullptr)
+	{
+		Visibility->UpdateRoom(this);
+	}
+	if (HasAuthority())
+	{
+		ReplicatedLayoutHash = LocalLayoutHash;
+	}
+	else
+	{
+		VerifyReplicatedLayoutHash();
+	}
+
+	// In Editor, this is the most reliable way to force a complete bounds update on the actor
+#if WITH_EDITOR
+	RerunConstructionScripts();
+#endif
+	
+	// Update the debug visuals immediately
+	if (GIsEditor)
+	{
+		DrawDebugGrid();
+	}
+}
+
+// ==================================================================================
+// LAYOUT SOLVE / BUILD
+// ==================================================================================
+
+void AMasterRoom::SolveLayout()
+{
+	LLM_SCOPE_BYTAG(DungeonGen_Layout);
+	
+	CurrentLayout.Reset(RoomData->GridSize, GenerationSeed);
+	
+	// The passes only select from the compiled tables (the cooked blob in packaged builds)
+	SolverData = &RoomData->GetCompiledData();
+	
+	GenerateFloorAndInterior();
+	GenerateWallsAndDoors();
+	GenerateInteriorFurniture();	// After the doors so their clearance and connecting path are known
+	GenerateClutter();	// After the doors so their approaches stay clear
+	GenerateCeiling();
+	
+	SolverData = nullptr;
+	CurrentLayout.CellStates = InternalGridState;
+	
+	UE_LOG(LogTemp, Log, TEXT("%s: Layout solved - %d placements, %d walls, %d doors, %d meshes"),
+		*GetName(), CurrentLayout.Placements.Num(), CurrentLayout.Walls.Num(), CurrentLayout.Doors.Num(), CurrentLayout.Meshes.Num());
+}
+
+bool AMasterRoom::BuildFromLayout(const FRoomLayout& Layout)
+{
+	if (!RoomData) return false;
+	
+	// Grid state, occupancy, wall segments and instance queues (the build steps below retag their own components)
+	LLM_SCOPE_BYTAG(DungeonGen_Layout);
+	
+	if (Layout.GridSize != RoomData->GridSize || Layout.CellStates.Num() != RoomData->GridSize.X * RoomData->GridSize.Y)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: Layout grid size %s does not match RoomData grid size %s - not applied"),
+			*GetName(), *Layout.GridSize.ToString(), *RoomData->GridSize.ToString());
+		return false;
+	}
+	
+	QueuedInstances.Reset();
+	QueuedClutterInstances.Reset();
+	InstanceCollisionMeshes.Reset();
+	PendingDoorways.Reset();
+	PlacedBaseWalls.Reset();
+	OccupancyGrid.Reset();
+	InternalGridState = Layout.CellStates;
+	
+	TArray<UStaticMesh*> LayoutMeshes;
+	Layout.ResolveMeshes(LayoutMeshes);
+	
+	// Everything below comes from the compiled tables (the cooked blob in packaged builds), never the style assets
+	const FCompiledRoomData& Compiled = RoomData->GetCompiledData();
+	
+	// Resolve every wall module's stacking chain once (placed walls refer to it by index)
+	CompiledWallStyle.Compile(*RoomData, ForcedWalls);
+	
+	// --- Grid Placements (floor, interior, clutter, ceiling) ---
+	for (const FRoomLayoutPlacement& Placement : Layout.Placements)
+	{
+		UStaticMesh* Mesh = LayoutMeshes.IsValidIndex(Placement.MeshIndex) ? LayoutMeshes[Placement.MeshIndex] : nullptr;
+		if (!Mesh) continue;
+		
+		const FVector CenterLocation(
+			(Placement.CellX + Placement.FootprintX / 2.0f) * CELL_SIZE,
+			(Placement.CellY + Placement.FootprintY / 2.0f) * CELL_SIZE,
+			0.0f);
+		
+		if (Placement.Layer == ERoomLayoutLayer::Ceiling)
+		{
+			const FVector TilePosition = CenterLocation + FVector(0.0f, 0.0f, Compiled.CeilingHeight);
+			QueueInstance(Mesh, FTransform(Compiled.CeilingRotation, TilePosition, FVector(1.0f)), Layout.MeshCustomData[Placement.MeshIndex]);
+		}
+		else if (Placement.Layer == ERoomLayoutLayer::Clutter)
+		{
+			QueueClutterInstance(Mesh, FTransform(FRotator(0.0f, Placement.Quadrant * 90.0f, 0.0f), CenterLocation), Layout.MeshCustomData[Placement.MeshIndex]);
+		}
+		else
+		{
+			QueueInstance(Mesh, FTransform(FRotator(0.0f, Placement.Quadrant * 90.0f, 0.0f), CenterLocation), Layout.MeshCustomData[Placement.MeshIndex]);
+			if (Placement.Layer == ERoomLayoutLayer::Interior)
+			{
+				InstanceCollisionMeshes.Add(Mesh);
+			}
+		}
+	}
+	
+	// --- Doors ---
+	TArray<FFixedDoorLocation> LayoutDoors;
+	TArray<FCompiledDoorFrame> LayoutDoorFrames;
+	ResolveLayoutDoors(Layout, LayoutDoors, LayoutDoorFrames);
+	
+	for (int32 DoorIndex = 0; DoorIndex < LayoutDoors.Num(); ++DoorIndex)
+	{
+		const FFixedDoorLocation& DoorLoc = LayoutDoors[DoorIndex];
+		const FCompiledDoorFrame& Frame = LayoutDoorFrames[DoorIndex];
+		PlaceDoorFrame(DoorLoc, Frame);
+		
+		const TArray<FIntPoint> EdgeCells = GetCellsForEdge(DoorLoc.WallEdge);
+		for (int32 i = 0; i < Frame.Footprint; ++i)
+		{
+			if (EdgeCells.IsValidIndex(DoorLoc.StartCell + i))
+			{
+				OccupancyGrid.Add(EdgeCells[DoorLoc.StartCell + i], EGridCellType::ECT_Doorway);
+			}
+		}
+	}
+	
+	// --- Base Walls ---
+	for (const FRoomLayoutWall& Wall : Layout.Walls)
+	{
+		const int32 ModuleIndex = CompiledWallStyle.GetModuleIndex(Wall.bForced, Wall.ModuleIndex);
+		if (ModuleIndex == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: Layout wall module %d not found (data asset changed?) - skipped"), *GetName(), Wall.ModuleIndex);
+			continue;
+		}
+		
+		PlaceBaseWall(Wall.Edge, Wall.Line, Wall.StartCell, ModuleIndex);
+		
+		if (Wall.bForced)
+		{
+			const TArray<FIntPoint> EdgeCells = GetCellsForEdge(Wall.Edge);
+			for (int32 i = 0; i < CompiledWallStyle.Modules[ModuleIndex].Footprint; ++i)
+			{
+				if (EdgeCells.IsValidIndex(Wall.StartCell + i))
+				{
+					OccupancyGrid.Add(EdgeCells[Wall.StartCell + i], EGridCellType::ECT_Wall);
+				}
+			}
+		}
+	}
+	
+	// --- Derived Layers ---
+	// Middle/Top stacks and corners are fully determined by the base walls and compiled tables
+	SpawnMiddleWalls();
+	SpawnTopWalls();
+	SpawnCorners();
+	
+	BuildMergedCollision();
+	BuildRoomProxy();
+	FlushQueuedInstances();
+	SpawnPendingDoorways();
+	
+	// --- Publish Door Connection Points ---
+	// The DungeonManager pairs these across adjacent rooms
+	BuildDoorConnectionPoints(LayoutDoors, LayoutDoorFrames);
+	BuildNavigationGeometry();
+	
+	return true;
+}
+
+void FQueuedInstanceBatch::Add(const FTransform& Transform, TConstArrayView<float> InCustomData)
+{
+	// A variant with more floats than any before it widens the stride of the whole batch
+	if (InCustomData.Num() > NumCustomData)
+	{
+		TArray<float> Widened;
+		Widened.SetNumZeroed(Transforms.Num() * InCustomData.Num());
+		for (int32 i = 0; i < Transforms.Num(); ++i)
+		{
+			FMemory::Memcpy(&Widened[i * InCustomData.Num()], &CustomData[i * NumCustomData], NumCustomData * sizeof(float));
+		}
+		CustomData = MoveTemp(Widened);
+		NumCustomData = InCustomData.Num();
+	}
+	
+	Transforms.Add(Transform);
+	if (NumCustomData > 0)
+	{
+		CustomData.Append(InCustomData.GetData(), InCustomData.Num());
+		CustomData.AddZeroed(NumCustomData - InCustomData.Num());
+	}
+}
+
+void AMasterRoom::QueueInstance(UStaticMesh* Mesh, const FTransform& Transform, TConstArrayView<float> CustomData)
+{
+	if (!Mesh) return;
+	
+	QueuedInstances.FindOrAdd(Mesh).Add(Transform, CustomData);
+}
+
+void AMasterRoom::QueueClutterInstance(UStaticMesh* Mesh, const FTransform& Transform, TConstArrayView<float> CustomData)
+{
+	if (!Mesh) return;
+	
+	QueuedClutterInstances.FindOrAdd(Mesh).Add(Transform, CustomData);
+}
+
+void AMasterRoom::FlushQueuedInstances()
+{
+	LLM_SCOPE_BYTAG(DungeonGen_Instances);
+	
+	LocalLayoutHash = ComputeLayoutHash();
+	
+	FlushInstanceQueue(QueuedInstances, false);
+	FlushInstanceQueue(QueuedClutterInstances, true);
+}
+
+void AMasterRoom::FlushInstanceQueue(TMap<UStaticMesh*, FQueuedInstanceBatch>& Queue, bool bClutter)
+{
+	// Distant proxy: the renderer stops drawing the full room where the proxy starts (0 = no limit)
+	// Clutter is small and only worth drawing up close, so it gets its own, tighter distance
+	const float CullDistance = bClutter ? GetClutterCullDistance() : (bGenerateProxy ? ProxyDistance : 0.0f);
+	
+	// --- Shared Instances ---
+	// World-space batches go to the dungeon's chunked HISMs (the room keeps only the handles)
+	if (IsValid(SharedInstances))
+	{
+		const FTransform RoomTransform = RootComponent->GetComponentTransform();
+		TArray<FTransform> WorldTransforms;
+		for (const auto& Pair : Queue)
+		{
+			const FQueuedInstanceBatch& Batch = Pair.Value;
+			
+			// Clutter is decorative: no collision and no navigation in any mode
+			FDungeonInstanceSettings Settings;
+			Settings.bCollision = !bClutter && (CollisionMode == ERoomCollisionMode::PerInstance || InstanceCollisionMeshes.Contains(Pair.Key));
+			Settings.bAffectNavigation = !bClutter && !bEmitNavigationGeometry;
+			Settings.CullDistance = CullDistance;
+			
+			WorldTransforms.Reset(Batch.Transforms.Num());
+			for (const FTransform& Transform : Batch.Transforms)
+			{
+				WorldTransforms.Add(Transform * RoomTransform);
+			}
+			SharedInstances->AddInstances(Pair.Key, Settings, WorldTransforms, Batch.CustomData, Batch.NumCustomData, SharedInstanceHandles);
+		}
+		Queue.Reset();
+		return;
+	}
+	
+	for (auto& Pair : Queue)
+	{
+		const FQueuedInstanceBatch& Batch = Pair.Value;
+		if (UHierarchicalInstancedStaticMeshComponent* HISM = GetOrCreateHISM(Pair.Key, bClutter))
+		{
+			// Merged mode: walls/floor/ceiling collide through the merged boxes instead
+			const bool bInstanceCollision = !bClutter && (CollisionMode == ERoomCollisionMode::PerInstance || InstanceCollisionMeshes.Contains(Pair.Key));
+			HISM->SetCollisionEnabled(bInstanceCollision ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
+			
+			// Emitted navigation: the nav geometry component stands in for the instances
+			HISM->SetCanEverAffectNavigation(!bClutter && !bEmitNavigationGeometry);
+			
+			HISM->SetCullDistance(CullDistance);
+			
+			// Mesh variants: one float block per instance (the HISM was cleared, so resizing loses nothing)
+			if (HISM->NumCustomDataFloats != Batch.NumCustomData)
+			{
+				HISM->SetNumCustomDataFloats(Batch.NumCustomData);
+			}
+			
+			const TArray<int32> Indices = HISM->AddInstances(Batch.Transforms, Batch.NumCustomData > 0);
+			for (int32 i = 0; i < Indices.Num(); ++i)
+			{
+				HISM->SetCustomData(Indices[i], MakeArrayView(&Batch.CustomData[i * Batch.NumCustomData], Batch.NumCustomData));
+			}
+		}
+	}
+	Queue.Reset();
+}
+
+float AMasterRoom::GetClutterCullDistance() const
+{
+	const float RoomCullDistance = bGenerateProxy ? ProxyDistance : 0.0f;
+	const float ClutterCullDistance = RoomData ? RoomData->GetCompiledTables().ClutterCullDistance : 0.0f;
+	
+	// 0 means "no limit" on either side
+	if (ClutterCullDistance <= 0.0f) return RoomCullDistance;
+	if (RoomCullDistance <= 0.0f) return ClutterCullDistance;
+	return FMath::Min(ClutterCullDistance, RoomCullDistance);
+}
+
+void AMasterRoom::ReleaseSharedInstances()
+{
+	if (IsValid(SharedInstances))
+	{
+		SharedInstances->RemoveInstances(SharedInstanceHandles);
+	}
+	SharedInstanceHandles.Reset();
+}
+
+void AMasterRoom::SetSharedInstanceManager(UDungeonInstanceManager* InManager, bool bRegenerate)
+{
+	if (SharedInstances == InManager) return;
+	
+	ReleaseSharedInstances();
+	SharedInstances = InManager;
+	
+	// Move an existing build over to the new target (the old HISMs are emptied by the regeneration)
+	if (bIsGenerated && bRegenerate)
+	{
+		RegenerateRoom();
+	}
+}
+
+void AMasterRoom::ComputeMergedPrimitives(TArray<FBox>& OutWallRuns, TArray<FBox>& OutFloorRects) const
+{
+	OutWallRuns.Reset();
+	OutFloorRects.Reset();
+	if (!RoomData) return;
+	
+	const FIntPoint GridSize = RoomData->GridSize;
+	const float WallHeight = RoomData->GetCompiledTables().WallHeight;
+	
+	// --- Wall Runs ---
+	// Contiguous base wall segments on one boundary line become one box (door gaps and carved cells split runs)
+	if (WallHeight > 0.0f)
+	{
+		const FPlacedWallSegments& Walls = PlacedBaseWalls;
+		TArray<int32> Segments;
+		Segments.Reserve(Walls.Num());
+		for (int32 i = 0; i < Walls.Num(); ++i)
+		{
+			Segments.Add(i);
+		}
+		Segments.Sort([&Walls](int32 A, int32 B)
+		{
+			if (Walls.Edges[A] != Walls.Edges[B]) return Walls.Edges[A] < Walls.Edges[B];
+			if (Walls.Lines[A] != Walls.Lines[B]) return Walls.Lines[A] < Walls.Lines[B];
+			return Walls.StartCells[A] < Walls.StartCells[B];
+		});
+		
+		for (int32 RunStart = 0; RunStart < Segments.Num();)
+		{
+			int32 RunEnd = RunStart;
+			while (RunEnd + 1 < Segments.Num()
+				&& Walls.Edges[Segments[RunEnd + 1]] == Walls.Edges[Segments[RunStart]]
+				&& Walls.Lines[Segments[RunEnd + 1]] == Walls.Lines[Segments[RunStart]]
+				&& Walls.StartCells[Segments[RunEnd + 1]] == Walls.StartCells[Segments[RunEnd]] + Walls.Lengths[Segments[RunEnd]])
+			{
+				++RunEnd;
+			}
+			
+			// Base transforms are room-local, like the proxy boxes
+			const int32 First = Segments[RunStart];
+			const int32 Last = Segments[RunEnd];
+			const FVector FirstCenter = Walls.BaseTransforms[First].GetLocation();
+			const FVector LastCenter = Walls.BaseTransforms[Last].GetLocation();
+			
+			// North/South walls run along Y, East/West walls along X
+			const bool bAlongY = (Walls.Edges[First] == EWallEdge::North || Walls.Edges[First] == EWallEdge::South);
+			const int32 Axis = bAlongY ? 1 : 0;
+			
+			// Extend by half the thickness on both ends so runs close the room corners
+			const float RunMin = FirstCenter[Axis] - Walls.Lengths[First] * CELL_SIZE * 0.5f - WallCollisionThickness * 0.5f;
+			const float RunMax = LastCenter[Axis] + Walls.Lengths[Last] * CELL_SIZE * 0.5f + WallCollisionThickness * 0.5f;
+			
+			FVector Center = FirstCenter;
+			Center[Axis] = (RunMin + RunMax) * 0.5f;
+			Center.Z = WallHeight * 0.5f;
+			
+			FVector Extent(WallCollisionThickness * 0.5f, WallCollisionThickness * 0.5f, WallHeight * 0.5f);
+			Extent[Axis] = (RunMax - RunMin) * 0.5f;
+			
+			OutWallRuns.Add(FBox::BuildAABB(Center, Extent));
+			RunStart = RunEnd + 1;
+		}
+	}
+	
+	// --- Floor Rectangles ---
+	// Greedy rectangle merge of all floor cells: grow along X, then along Y while the whole row fits
+	TArray<bool> Covered;
+	Covered.Init(false, GridSize.X * GridSize.Y);
+	auto IsFreeFloor = [&](int32 X, int32 Y)
+	{
+		const int32 Index = Y * GridSize.X + X;
+		return InternalGridState.IsValidIndex(Index) && !Covered[Index]
+			&& (InternalGridState[Index] == EGridCellType::ECT_FloorMesh || InternalGridState[Index] == EGridCellType::ECT_Interior);
+	};
+	
+	for (int32 Y = 0; Y < GridSize.Y; ++Y)
+	{
+		for (int32 X = 0; X < GridSize.X; ++X)
+		{
+			if (!IsFreeFloor(X, Y)) continue;
+			
+			int32 Width = 1;
+			while (X + Width < GridSize.X && IsFreeFloor(X + Width, Y))
+			{
+				++Width;
+			}
+			
+			int32 Height = 1;
+			for (bool bRowFits = true; bRowFits && Y + Height < GridSize.Y; )
+			{
+				for (int32 i = 0; i < Width && bRowFits; ++i)
+				{
+					bRowFits = IsFreeFloor(X + i, Y + Height);
+				}
+				if (bRowFits) ++Height;
+			}
+			
+			for (int32 j = 0; j < Height; ++j)
+			{
+				for (int32 i = 0; i < Width; ++i)
+				{
+					Covered[(Y + j) * GridSize.X + (X + i)] = true;
+				}
+			}
+			
+			// Slab from -FloorCollisionThickness up to the walkable surface at Z = 0
+			OutFloorRects.Add(FBox(
+				FVector(X * CELL_SIZE, Y * CELL_SIZE, -FloorCollisionThickness),
+				FVector((X + Width) * CELL_SIZE, (Y + Height) * CELL_SIZE, 0.0f)));
+		}
+	}
+}
+
+void AMasterRoom::BuildMergedCollision()
 {
-	Super::PostEditChangeProperty(PropertyChangedEvent);
-
-	// Check if the property that changed was 'bGenerateRoom'
-	FName PropertyName = (PropertyChangedEvent.Property != nullptr) ? PropertyChangedEvent.Property->GetFName() : NAME_None;
-
-	if (PropertyName == GET_MEMBER_NAME_CHECKED(AMasterRoom, bGenerateRoom))
+	LLM_SCOPE_BYTAG(DungeonGen_Collision);
+	
+	int32 NumBoxes = 0;
+	
+	if (CollisionMode == ERoomCollisionMode::MergedPrimitives && RoomData)
 	{
-		if (bGenerateRoom)
+		TArray<FBox> WallRuns, FloorRects;
+		ComputeMergedPrimitives(WallRuns, FloorRects);
+		
+		for (const FBox& WallRun : WallRuns)
 		{
-			RegenerateRoom();
-			bGenerateRoom = false; // Reset the button immediately after execution
+			SetCollisionBox(NumBoxes++, WallRun.GetCenter(), WallRun.GetExtent());
+		}
+		
+		const float CeilingHeight = bCeilingCollision ? RoomData->GetCompiledTables().CeilingHeight : 0.0f;
+		for (const FBox& FloorRect : FloorRects)
+		{
+			SetCollisionBox(NumBoxes++, FloorRect.GetCenter(), FloorRect.GetExtent());
+			
+			// Matching slab just above the ceiling tiles
+			if (CeilingHeight > 0.0f)
+			{
+				const FVector CeilingOffset(0.0f, 0.0f, CeilingHeight + FloorCollisionThickness);
+				SetCollisionBox(NumBoxes++, FloorRect.GetCenter() + CeilingOffset, FloorRect.GetExtent());
+			}
 		}
 	}
 	
-	// IMPORTANT: Call the debug drawing here so it updates instantly in the editor
-	if (GIsEditor)
+	// Disable boxes left over from a larger previous layout (kept for reuse)
+	for (int32 i = NumBoxes; i < CollisionBoxes.Num(); ++i)
 	{
-		DrawDebugGrid();
+		if (CollisionBoxes[i])
+		{
+			CollisionBoxes[i]->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		}
+	}
+	
+	if (NumBoxes > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s: Merged collision - %d boxes"), *GetName(), NumBoxes);
 	}
 }
 
-// --- Helper: Weighted Random Selection ---
-
-// Selects one FMeshPlacementInfo struct based on placement weights
-
-const FMeshPlacementInfo* AMasterRoom::SelectWeightedMesh(const TArray<FMeshPlacementInfo>& MeshPool, FRandomStream& Stream)
+void AMasterRoom::SetCollisionBox(int32 Index, const FVector& LocalCenter, const FVector& Extent)
 {
-	if (MeshPool.Num() == 0)
+	if (!CollisionBoxes.IsValidIndex(Index) || !CollisionBoxes[Index])
 	{
-		return nullptr;
+		UBoxComponent* NewBox = NewObject<UBoxComponent>(this, FName(*FString::Printf(TEXT("MergedCollision_%d"), Index)));
+		NewBox->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		NewBox->SetupAttachment(RootComponent);
+		NewBox->RegisterComponent();
+		
+		CollisionBoxes.SetNum(FMath::Max(CollisionBoxes.Num(), Index + 1));
+		CollisionBoxes[Index] = NewBox;
 	}
+	
+	UBoxComponent* Box = CollisionBoxes[Index];
+	Box->SetBoxExtent(Extent, false);
+	Box->SetRelativeLocation(LocalCenter);
+	Box->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	Box->SetCanEverAffectNavigation(!bEmitNavigationGeometry);
+}
 
-	// Calculate total weight
-	float TotalWeight = 0.0f;
-	for (const FMeshPlacementInfo& Info : MeshPool)
+void AMasterRoom::BuildRoomProxy()
+{
+	LLM_SCOPE_BYTAG(DungeonGen_Instances);
+	
+	if (ProxyComponent)
 	{
-		TotalWeight += Info.PlacementWeight;
+		ProxyComponent->ClearInstances();
 	}
-
-	if (TotalWeight <= 0.0f)
+	if (!bGenerateProxy || !RoomData) return;
+	
+	UStaticMesh* Mesh = ProxyMesh.LoadSynchronous();
+	if (!Mesh)
 	{
-		return &MeshPool[Stream.RandRange(0, MeshPool.Num() - 1)]; // Fallback to uniform random
+		UE_LOG(LogTemp, Warning, TEXT("%s: bGenerateProxy is set but ProxyMesh is missing"), *GetName());
+		return;
 	}
-
-	// Choose a random point in the total weight range
-	float RandomWeight = Stream.FRand() * TotalWeight;
 	
-	// Find which mesh corresponds to that weight point
-	float CurrentWeight = 0.0f;
-	for (const FMeshPlacementInfo& Info : MeshPool)
+	if (!ProxyComponent)
+	{
+		ProxyComponent = NewObject<UInstancedStaticMeshComponent>(this, TEXT("DistantProxy"));
+		ProxyComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		ProxyComponent->SetCanEverAffectNavigation(false);
+		ProxyComponent->SetupAttachment(RootComponent);
+		ProxyComponent->RegisterComponent();
+	}
+	ProxyComponent->SetStaticMesh(Mesh);
+	ProxyComponent->SetMaterial(0, ProxyMaterial.LoadSynchronous());
+	
+	// The swap is pure per-primitive distance culling on the render thread - no per-frame game thread work
+	ProxyComponent->MinDrawDistance = ProxyDistance;
+	
+	TArray<FBox> WallRuns, FloorRects;
+	ComputeMergedPrimitives(WallRuns, FloorRects);
+	
+	TArray<FBox> Boxes = MoveTemp(WallRuns);
+	Boxes.Append(FloorRects);
+	
+	// Ceiling: the floor rectangles lifted to the ceiling tiles
+	const float CeilingHeight = RoomData->GetCompiledTables().CeilingHeight;
+	if (CeilingHeight > 0.0f)
 	{
-		CurrentWeight += Info.PlacementWeight;
-		if (RandomWeight <= CurrentWeight)
+		for (const FBox& FloorRect : FloorRects)
 		{
-			return &Info;
+			Boxes.Add(FloorRect.ShiftBy(FVector(0.0f, 0.0f, CeilingHeight + FloorCollisionThickness)));
 		}
 	}
-
-	return &MeshPool.Last(); // Should not be reached, but safe fallback
+	
+	// Stretch the 100cm unit cube over each box
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(Boxes.Num());
+	for (const FBox& Box : Boxes)
+	{
+		Transforms.Emplace(FQuat::Identity, Box.GetCenter(), Box.GetSize() / 100.0f);
+	}
+	ProxyComponent->AddInstances(Transforms, false);
+	
+	UE_LOG(LogTemp, Log, TEXT("%s: Distant proxy - %d boxes (full room beyond %.0fcm)"), *GetName(), Transforms.Num(), ProxyDistance);
 }
 
-// --- Region Expansion Logic ---
-
-TArray<FIntPoint> AMasterRoom::ExpandForcedEmptyRegions() const
+void AMasterRoom::BuildNavigationGeometry()
 {
-	if (!RoomData) return TArray<FIntPoint>();
-
-	const FIntPoint GridSize = RoomData->GridSize;
-	TArray<FIntPoint> ExpandedCells;
-
-	// 0. Apply ShapePreset if assigned (preset takes priority, then manual overrides can add to it)
-	if (ShapePreset)
+	LLM_SCOPE_BYTAG(DungeonGen_Navigation);
+	
+	if (!bEmitNavigationGeometry || !RoomData)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Applying RoomShapePreset: %s (%s)"), 
-			*ShapePreset->ShapeName, 
-			*UEnum::GetValueAsString(ShapePreset->ShapeType));
-
-		// Expand preset's empty regions
-		for (const FForcedEmptyRegion& Region : ShapePreset->EmptyRegions)
+		if (NavGeometry)
 		{
-			int32 MinX = FMath::Min(Region.StartCell.X, Region.EndCell.X);
-			int32 MaxX = FMath::Max(Region.StartCell.X, Region.EndCell.X);
-			int32 MinY = FMath::Min(Region.StartCell.Y, Region.EndCell.Y);
-			int32 MaxY = FMath::Max(Region.StartCell.Y, Region.EndCell.Y);
-
-			MinX = FMath::Clamp(MinX, 0, GridSize.X - 1);
-			MaxX = FMath::Clamp(MaxX, 0, GridSize.X - 1);
-			MinY = FMath::Clamp(MinY, 0, GridSize.Y - 1);
-			MaxY = FMath::Clamp(MaxY, 0, GridSize.Y - 1);
-
-			for (int32 Y = MinY; Y <= MaxY; ++Y)
-			{
-				for (int32 X = MinX; X <= MaxX; ++X)
-				{
-					ExpandedCells.AddUnique(FIntPoint(X, Y));
-				}
-			}
+			NavGeometry->ClearGeometry();
 		}
+		return;
+	}
+	
+	if (!NavGeometry)
+	{
+		NavGeometry = NewObject<UDungeonNavGeometryComponent>(this, TEXT("NavGeometry"));
+		NavGeometry->SetupAttachment(RootComponent);
+		NavGeometry->RegisterComponent();
+	}
+	
+	TArray<FBox> WallRuns, FloorRects;
+	ComputeMergedPrimitives(WallRuns, FloorRects);
+	
+	// --- Door Openings ---
+	// Doorway cells sit in the boundary ring outside the grid - a floor slab over each one lets the
+	// navmesh run through the opening and meet the neighbouring room's slab (sealed doors are walls)
+	for (const auto& Pair : OccupancyGrid)
+	{
+		if (Pair.Value != EGridCellType::ECT_Doorway) continue;
+		
+		const FIntPoint& Cell = Pair.Key;
+		FloorRects.Add(FBox(
+			FVector(Cell.X * CELL_SIZE, Cell.Y * CELL_SIZE, -FloorCollisionThickness),
+			FVector((Cell.X + 1) * CELL_SIZE, (Cell.Y + 1) * CELL_SIZE, 0.0f)));
+	}
+	
+	const int32 NumWalkable = FloorRects.Num();
+	const int32 NumObstacles = WallRuns.Num();
+	NavGeometry->SetGeometry(MoveTemp(FloorRects), MoveTemp(WallRuns));
+	
+	UE_LOG(LogTemp, Log, TEXT("%s: Navigation geometry - %d walkable boxes, %d obstacles"), *GetName(), NumWalkable, NumObstacles);
+}
 
-		// Add preset's empty cells
-		for (const FIntPoint& Cell : ShapePreset->EmptyCells)
-		{
-			if (Cell.X >= 0 && Cell.X < GridSize.X && Cell.Y >= 0 && Cell.Y < GridSize.Y)
-			{
-				ExpandedCells.AddUnique(Cell);
-			}
-		}
+void AMasterRoom::GetEncodedLayout(TArray<uint8>& OutBytes) const
+{
+	CurrentLayout.Encode(OutBytes);
+}
 
-		UE_LOG(LogTemp, Warning, TEXT("ShapePreset added %d empty cells"), ExpandedCells.Num());
+bool AMasterRoom::ApplyEncodedLayout(const TArray<uint8>& Bytes)
+{
+	if (!RoomData) return false;
+	
+	LLM_SCOPE_BYTAG(DungeonGen);
+	
+	FRoomLayout Layout;
+	if (!Layout.Decode(Bytes))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: Failed to decode room layout (%d bytes)"), *GetName(), Bytes.Num());
+		return false;
 	}
-
-	// 1. Expand all rectangular regions into individual cells (manual overrides)
-	for (const FForcedEmptyRegion& Region : ForcedEmptyRegions)
+	
+	ClearAndResetComponents();
+	if (!BuildFromLayout(Layout))
 	{
-		// Calculate the bounding box (handles any corner order)
-		int32 MinX = FMath::Min(Region.StartCell.X, Region.EndCell.X);
-		int32 MaxX = FMath::Max(Region.StartCell.X, Region.EndCell.X);
-		int32 MinY = FMath::Min(Region.StartCell.Y, Region.EndCell.Y);
-		int32 MaxY = FMath::Max(Region.StartCell.Y, Region.EndCell.Y);
-
-		// Clamp to valid grid bounds (safety check)
-		MinX = FMath::Clamp(MinX, 0, GridSize.X - 1);
-		MaxX = FMath::Clamp(MaxX, 0, GridSize.X - 1);
-		MinY = FMath::Clamp(MinY, 0, GridSize.Y - 1);
-		MaxY = FMath::Clamp(MaxY, 0, GridSize.Y - 1);
+		return false;
+	}
+	CurrentLayout = MoveTemp(Layout);
+	
+	FinishGeneration();
+	return true;
+}
 
-		// Add all cells within the rectangular region
-		for (int32 Y = MinY; Y <= MaxY; ++Y)
+void AMasterRoom::ReleaseRoom()
+{
+	// Destroy the HISM components rather than just clearing them so instance buffers,
+	// cluster trees, render proxies and physics bodies are all freed
+	for (const auto* HISMMap : { &MeshToHISMMap, &ClutterHISMMap })
+	{
+		for (const auto& Pair : *HISMMap)
 		{
-			for (int32 X = MinX; X <= MaxX; ++X)
+			if (UHierarchicalInstancedStaticMeshComponent* HISM = Pair.Value)
 			{
-				FIntPoint Cell(X, Y);
-				ExpandedCells.AddUnique(Cell); // AddUnique prevents duplicates from overlapping regions
+				HISM->ClearInstances();
+				HISM->DestroyComponent();
 			}
 		}
 	}
-
-	// 2. Add individual forced empty cells (manual overrides)
-	for (const FIntPoint& Cell : ForcedEmptyFloorCells)
+	MeshToHISMMap.Empty();
+	ClutterHISMMap.Empty();
+	ReleaseSharedInstances();
+	
+	for (UBoxComponent* Box : CollisionBoxes)
 	{
-		// Validate cell is within grid bounds
-		if (Cell.X >= 0 && Cell.X < GridSize.X && Cell.Y >= 0 && Cell.Y < GridSize.Y)
+		if (Box)
 		{
-			ExpandedCells.AddUnique(Cell);
+			Box->DestroyComponent();
 		}
 	}
-
-	return ExpandedCells;
-}
-
-void AMasterRoom::RegenerateRoom()
-{
-	// Server Check: Only the server or the editor should run generation
-	if (GetLocalRole() != ROLE_Authority && !IsEditorOnly() && !GIsEditor)
+	CollisionBoxes.Empty();
+	
+	if (ProxyComponent)
 	{
-		return;
+		ProxyComponent->DestroyComponent();
+		ProxyComponent = nullptr;
+	}
+	
+	// Streamed-out rooms leave no navmesh behind (rebuilt with the room)
+	if (NavGeometry)
+	{
+		NavGeometry->DestroyComponent();
+		NavGeometry = nullptr;
 	}
+	
+	ReleaseDoorways();
+	
+	// Generation scratch state is rebuilt by the next RegenerateRoom
+	InternalGridState.Empty();
+	OccupancyGrid.Empty();
+	PlacedBaseWalls.Empty();
+	CompiledWallStyle.Reset();
+	
+	bIsGenerated = false;
+}
 
-	if (!RoomData)
+FBox AMasterRoom::GetRoomBounds() const
+{
+	const FIntPoint GridSize = RoomData ? RoomData->GridSize : FIntPoint::ZeroValue;
+	float Height = 0.0f;
+	if (RoomData)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("ADungeonMasterRoom: RoomData is null. Cannot generate."));
-		return;
+		// Tables only - bounds of an unbuilt (streamed out) room never load its meshes
+		const FCompiledRoomData& Compiled = RoomData->GetCompiledTables();
+		Height = FMath::Max3(Height, Compiled.WallHeight, Compiled.CeilingHeight);
 	}
 	
-	// 1. Clean up and prepare for a new generation pass
-	ClearAndResetComponents();
+	// Include the virtual wall boundary ring (-1 and GridSize cells)
+	const FBox LocalBounds(
+		FVector(-CELL_SIZE, -CELL_SIZE, 0.0f),
+		FVector((GridSize.X + 1) * CELL_SIZE, (GridSize.Y + 1) * CELL_SIZE, Height));
+	
+	return LocalBounds.TransformBy(GetActorTransform());
+}
 
-	// 2. Run generation steps
-	GenerateFloorAndInterior();
-	GenerateWallsAndDoors();
-	GenerateCeiling();
+FRoomMemoryStats AMasterRoom::GetMemoryStats() const
+{
+	FRoomMemoryStats Stats;
 	
-	// 3. Force bounding box updates on all new and existing components
-	for (const auto& Pair : MeshToHISMMap)
+	// --- Generation State ---
+	Stats.GridStateBytes = InternalGridState.GetAllocatedSize();
+	Stats.OccupancyGridBytes = OccupancyGrid.GetAllocatedSize();
+	Stats.WallSegmentBytes = PlacedBaseWalls.GetAllocatedSize() + CompiledWallStyle.GetAllocatedSize();
+	Stats.LayoutBytes = CurrentLayout.GetAllocatedSize() + QueuedInstances.GetAllocatedSize() + QueuedClutterInstances.GetAllocatedSize()
+		+ DoorConnectionPoints.GetAllocatedSize() + InstanceCollisionMeshes.GetAllocatedSize()
+		+ MeshToHISMMap.GetAllocatedSize() + ClutterHISMMap.GetAllocatedSize() + CollisionBoxes.GetAllocatedSize()
+		+ PendingDoorways.GetAllocatedSize() + SpawnedDoorways.GetAllocatedSize() + ReplicatedOverrides.GetAllocatedSize()
+		+ SharedInstanceHandles.GetAllocatedSize();
+	
+	// --- Components ---
+	// Exclusive resource size: instance data, cluster trees and physics bodies, without the shared meshes
+	for (const auto* HISMMap : { &MeshToHISMMap, &ClutterHISMMap })
 	{
-		if (UHierarchicalInstancedStaticMeshComponent* HISM = Pair.Value)
+		for (const auto& Pair : *HISMMap)
 		{
-			// Forces the component to re-evaluate its spatial boundaries based on new instances
-			HISM->UpdateBounds(); 
-			HISM->MarkRenderStateDirty(); // Ensures the rendering thread picks up the change
+			if (UHierarchicalInstancedStaticMeshComponent* HISM = Pair.Value)
+			{
+				Stats.InstanceBytes += DungeonMemory::GetComponentBytes(HISM);
+				Stats.NumInstances += HISM->GetInstanceCount();
+				++Stats.NumInstanceComponents;
+			}
 		}
 	}
-
-	// In Editor, this is the most reliable way to force a complete bounds update on the actor
-#if WITH_EDITOR
-	RerunConstructionScripts();
-#endif
 	
-	// 4. Update the debug visuals immediately
-	if (GIsEditor)
+	// Shared instances: the buffers belong to the dungeon's instance manager (see ADungeonManager::GetDungeonMemoryStats)
+	Stats.NumInstances += SharedInstanceHandles.Num();
+	
+	for (UBoxComponent* Box : CollisionBoxes)
 	{
-		DrawDebugGrid();
+		Stats.CollisionBytes += DungeonMemory::GetComponentBytes(Box);
 	}
+	
+	Stats.ProxyBytes = DungeonMemory::GetComponentBytes(ProxyComponent);
+	Stats.NavigationBytes = DungeonMemory::GetComponentBytes(NavGeometry);
+	Stats.DebugBytes = DungeonMemory::GetComponentBytes(DebugGrid);
+	
+	return Stats;
 }
 
 // --- Wall Generation Helper Functions ---
@@ -267,6 +1551,27 @@ TArray<FIntPoint> AMasterRoom::GetCellsForEdge(EWallEdge Edge) const
 	return Cells;
 }
 
+void AMasterRoom::TraceFloorBoundary(FRoomBoundary& OutBoundary) const
+{
+	OutBoundary.Reset();
+	if (!RoomData) return;
+	
+	const FIntPoint GridSize = RoomData->GridSize;
+	if (InternalGridState.Num() != GridSize.X * GridSize.Y) return;
+	
+	// Everything but the carved cells is floor (forced-empty cells are ECT_Wall in the grid state)
+	TBitArray<> FloorMask(false, InternalGridState.Num());
+	for (int32 Index = 0; Index < InternalGridState.Num(); ++Index)
+	{
+		if (InternalGridState[Index] != EGridCellType::ECT_Wall)
+		{
+			FloorMask[Index] = true;
+		}
+	}
+	
+	OutBoundary.Trace(GridSize, FloorMask);
+}
+
 FRotator AMasterRoom::GetWallRotationForEdge(EWallEdge Edge) const
 {
 	// Rotations confirmed from previous project:
@@ -295,25 +1600,23 @@ FVector AMasterRoom::CalculateNorthSouthWallPosition(int32 X, int32 StartY, floa
 {
 	// COORDINATE SYSTEM: North = +X, South = -X
 	// X can now be -1 (South boundary) or GridSize (North boundary)
-	FVector BasePosition = GetActorLocation() + FVector(
+	// Room-local: the HISMs are attached to the root, so the actor transform is applied by the component
+	FVector BasePosition(
 			X * CELL_SIZE,
 			StartY * CELL_SIZE,
 			0.0f
 		);
 	float HalfLength = WallMeshLength / 2.0f;
 	
-	// Get wall offsets from WallData asset (per-wall-type configuration)
+	// Get wall offsets from the compiled WallData adjustments (per-wall-type configuration)
 	float NorthOffset = 0.0f;
 	float SouthOffset = 0.0f;
 	
-	if (RoomData && RoomData->WallStyleData.IsValid())
+	if (RoomData)
 	{
-		UWallData* WallData = RoomData->WallStyleData.LoadSynchronous();
-		if (WallData)
-		{
-			NorthOffset = WallData->NorthWallOffsetX;
-			SouthOffset = WallData->SouthWallOffsetX;
-		}
+		const FCompiledRoomData& Compiled = RoomData->GetCompiledTables();
+		NorthOffset = Compiled.NorthWallOffset;
+		SouthOffset = Compiled.SouthWallOffset;
 	}
 	
 	FVector WallPivotOffset;
@@ -348,25 +1651,23 @@ FVector AMasterRoom::CalculateEastWestWallPosition(int32 StartX, int32 Y, float
 {
 	// COORDINATE SYSTEM: East = +Y, West = -Y
 	// Y can now be -1 (West boundary) or GridSize (East boundary)
-	FVector BasePosition = GetActorLocation() + FVector(
+	// Room-local: the HISMs are attached to the root, so the actor transform is applied by the component
+	FVector BasePosition(
 		StartX * CELL_SIZE,
 		Y * CELL_SIZE,
 		0.0f
 	);
 	float HalfLength = WallMeshLength / 2.0f;
 	
-	// Get wall offsets from WallData asset (per-wall-type configuration)
+	// Get wall offsets from the compiled WallData adjustments (per-wall-type configuration)
 	float EastOffset = 0.0f;
 	float WestOffset = 0.0f;
 	
-	if (RoomData && RoomData->WallStyleData.IsValid())
+	if (RoomData)
 	{
-		UWallData* WallData = RoomData->WallStyleData.LoadSynchronous();
-		if (WallData)
-		{
-			EastOffset = WallData->EastWallOffsetY;
-			WestOffset = WallData->WestWallOffsetY;
-		}
+		const FCompiledRoomData& Compiled = RoomData->GetCompiledTables();
+		EastOffset = Compiled.EastWallOffset;
+		WestOffset = Compiled.WestWallOffset;
 	}
 	
 	FVector WallPivotOffset;
@@ -410,7 +1711,7 @@ FVector AMasterRoom::CalculateDoorPosition(EWallEdge Edge, int32 StartCell, floa
 	if (!RoomData) return FVector::ZeroVector;
 	
 	const FIntPoint GridSize = RoomData->GridSize;
-	FVector BasePosition = GetActorLocation();
+	FVector BasePosition = FVector::ZeroVector;	// Room-local, like the walls
 	FVector DoorPivotOffset;
 	
 	switch (Edge)
@@ -481,206 +1782,321 @@ FVector AMasterRoom::CalculateDoorPosition(EWallEdge Edge, int32 StartCell, floa
 	return BasePosition + DoorPivotOffset;
 }
 
-void AMasterRoom::FillWallSegment(EWallEdge Edge, int32 SegmentStart, int32 SegmentLength, FRandomStream& Stream)
+void AMasterRoom::ResolveLayoutDoors(const FRoomLayout& Layout, TArray<FFixedDoorLocation>& OutDoors, TArray<FCompiledDoorFrame>& OutFrames)
 {
-	if (!RoomData || !RoomData->WallStyleData) return;
-	
-	UWallData* WallData = RoomData->WallStyleData.LoadSynchronous();
-	if (WallData->AvailableWallModules.Num() == 0) return;
-	
-	TArray<FIntPoint> EdgeCells = GetCellsForEdge(Edge);
-	if (EdgeCells.Num() == 0 || SegmentStart < 0 || SegmentStart >= EdgeCells.Num()) return;
-	
-	FRotator WallRotation = GetWallRotationForEdge(Edge);
-	bool bIsNorthWall = (Edge == EWallEdge::North);
-	bool bIsEastWall = (Edge == EWallEdge::East);
+	OutDoors.Reset();
+	OutFrames.Reset();
+	if (!RoomData) return;
 	
-	// Greedy bin packing: largest module first
-	int32 RemainingCells = SegmentLength;
-	int32 CurrentCell = SegmentStart;
+	// Procedural doors are rebuilt into FixedDoorLocations so seals and replicated overrides see them
+	if (bEnableProceduralDoors)
+	{
+		FixedDoorLocations.Reset();
+	}
 	
-	while (RemainingCells > 0)
+	for (const FRoomLayoutDoor& Door : Layout.Doors)
 	{
-		// Find the largest module that fits
-		const FWallModule* BestModule = nullptr;
-		
-		for (const FWallModule& Module : WallData->AvailableWallModules)
+		FFixedDoorLocation DoorLoc;
+		FCompiledDoorFrame Frame;
+		switch (Door.Source)
 		{
-			if (Module.Y_AxisFootprint <= RemainingCells)
+			case ERoomLayoutDoorSource::FixedLocation:
+				// Designer-placed doors are actor overrides (like forced walls) - their frame comes from their own asset
+				if (!FixedDoorLocations.IsValidIndex(Door.Index)) continue;
+				DoorLoc = FixedDoorLocations[Door.Index];
+				Frame = FCompiledDoorFrame::FromDoorData(DoorLoc.DoorData);
+				break;
+			
+			case ERoomLayoutDoorSource::DoorStyle:
+			case ERoomLayoutDoorSource::DoorStylePool:
 			{
-				if (!BestModule || Module.Y_AxisFootprint > BestModule->Y_AxisFootprint)
-				{
-					BestModule = &Module;
-				}
+				const FCompiledDoorFrame* CompiledFrame = RoomData->GetCompiledDoorFrame(
+					Door.Source == ERoomLayoutDoorSource::DoorStyle ? INDEX_NONE : (int32)Door.Index);
+				if (!CompiledFrame) continue;
+				Frame = *CompiledFrame;
+				DoorLoc.DoorData = Frame.DoorData;
+				break;
 			}
 		}
+		DoorLoc.WallEdge = Door.Edge;
+		DoorLoc.StartCell = Door.StartCell;
+		if (!DoorLoc.DoorData) continue;
 		
-		if (!BestModule) break;  // No module fits remaining space
+		if (Door.Source != ERoomLayoutDoorSource::FixedLocation)
+		{
+			FixedDoorLocations.Add(DoorLoc);
+		}
+		OutDoors.Add(DoorLoc);
+		OutFrames.Add(Frame);
+	}
+}
+
+void AMasterRoom::BuildDoorConnectionPoints(TConstArrayView<FFixedDoorLocation> Doors, TConstArrayView<FCompiledDoorFrame> Frames)
+{
+	DoorConnectionPoints.Empty();
+	if (!RoomData) return;
+	
+	const FIntPoint GridSize = RoomData->GridSize;
+	const FTransform& ActorTransform = GetActorTransform();
+	
+	for (int32 DoorIndex = 0; DoorIndex < Doors.Num(); ++DoorIndex)
+	{
+		const FFixedDoorLocation& DoorLoc = Doors[DoorIndex];
+		const FCompiledDoorFrame& Frame = Frames[DoorIndex];
+		if (!DoorLoc.DoorData || IsDoorSealed(DoorLoc)) continue;
 		
-		// Load base mesh
-		UStaticMesh* BaseMesh = BestModule->BaseMesh.LoadSynchronous();
-		if (!BaseMesh) break;
+		const int32 DoorFootprint = Frame.Footprint;
+		const float SpanCenter = (DoorLoc.StartCell + DoorFootprint / 2.0f) * CELL_SIZE;
 		
-		// Calculate position based on wall edge using the corrected helper functions
-		FVector Position;
-		float WallMeshLength = BestModule->Y_AxisFootprint * CELL_SIZE;
+		// Connection points sit on the room boundary plane (not the interior cell used by CalculateDoorPosition)
+		// so that two rooms sharing a boundary publish coincident points for facing doors
+		FVector LocalLocation;
+		FVector LocalFacing;
+		switch (DoorLoc.WallEdge)
+		{
+			case EWallEdge::North:
+				LocalLocation = FVector(GridSize.X * CELL_SIZE, SpanCenter, 0.0f);
+				LocalFacing = FVector(1.0f, 0.0f, 0.0f);
+				break;
+			case EWallEdge::South:
+				LocalLocation = FVector(0.0f, SpanCenter, 0.0f);
+				LocalFacing = FVector(-1.0f, 0.0f, 0.0f);
+				break;
+			case EWallEdge::East:
+				LocalLocation = FVector(SpanCenter, GridSize.Y * CELL_SIZE, 0.0f);
+				LocalFacing = FVector(0.0f, 1.0f, 0.0f);
+				break;
+			case EWallEdge::West:
+			default:
+				LocalLocation = FVector(SpanCenter, 0.0f, 0.0f);
+				LocalFacing = FVector(0.0f, -1.0f, 0.0f);
+				break;
+		}
 		
-		if (bIsNorthWall || Edge == EWallEdge::South)
+		FDoorConnectionPoint& Point = DoorConnectionPoints.AddDefaulted_GetRef();
+		Point.WorldLocation = ActorTransform.TransformPosition(LocalLocation);
+		Point.WorldFacing = ActorTransform.TransformVectorNoScale(LocalFacing);
+		Point.WallEdge = DoorLoc.WallEdge;
+		Point.StartCell = DoorLoc.StartCell;
+		Point.Footprint = DoorFootprint;
+		Point.ConnectionBoxExtent = Frame.ConnectionBoxExtent;
+		Point.DoorData = DoorLoc.DoorData;
+	}
+}
+
+void AMasterRoom::GetPortalQuads(TArray<FDungeonPortalQuad>& OutQuads) const
+{
+	OutQuads.Reset();
+	if (!RoomData) return;
+	
+	const float WallHeight = RoomData->GetCompiledTables().WallHeight;
+	const float OpeningHeight = WallHeight > 0.0f ? WallHeight : GetRoomBounds().GetSize().Z;
+	const FVector WorldUp = GetActorTransform().TransformVectorNoScale(FVector::UpVector);
+	
+	// Connection points are exactly the placed, unsealed doors - already in world space, on the boundary plane
+	for (const FDoorConnectionPoint& Point : DoorConnectionPoints)
+	{
+		OutQuads.Add(FDungeonPortalQuad::FromConnectionPoint(Point, WorldUp, OpeningHeight));
+	}
+}
+
+void AMasterRoom::SetPortalCulled(bool bCulled)
+{
+	for (const auto* HISMMap : { &MeshToHISMMap, &ClutterHISMMap })
+	{
+		for (const auto& Pair : *HISMMap)
 		{
-			// North/South walls: Use Y coordinate from EdgeCells
-			int32 X = EdgeCells[CurrentCell].X;
-			int32 StartY = EdgeCells[CurrentCell].Y;
-			Position = CalculateNorthSouthWallPosition(X, StartY, WallMeshLength, bIsNorthWall);
+			if (UHierarchicalInstancedStaticMeshComponent* HISM = Pair.Value)
+			{
+				HISM->SetVisibility(!bCulled);
+			}
 		}
-		else  // East or West wall
+	}
+	if (ProxyComponent)
+	{
+		ProxyComponent->SetVisibility(!bCulled);
+	}
+}
+
+bool AMasterRoom::SealDoor(EWallEdge Edge, int32 StartCell)
+{
+	for (const FSealedDoorSlot& Slot : SealedDoors)
+	{
+		if (Slot.WallEdge == Edge && Slot.StartCell == StartCell)
 		{
-			// East/West walls: Use X coordinate from EdgeCells
-			int32 StartX = EdgeCells[CurrentCell].X;
-			int32 Y = EdgeCells[CurrentCell].Y;
-			Position = CalculateEastWestWallPosition(StartX, Y, WallMeshLength, bIsEastWall);
+			return false;
 		}
-		
-		// Base walls spawn at floor level (Z=0)
-		// BottomBackCenter socket will be at floor level
-		// (No offset needed - mesh origin at floor)
-		
-		// Place base mesh
-		UHierarchicalInstancedStaticMeshComponent* HISM = GetOrCreateHISM(BaseMesh);
-		if (HISM)
+	}
+	
+	FSealedDoorSlot& NewSlot = SealedDoors.AddDefaulted_GetRef();
+	NewSlot.WallEdge = Edge;
+	NewSlot.StartCell = StartCell;
+	return true;
+}
+
+void AMasterRoom::ClearSealedDoors()
+{
+	SealedDoors.Empty();
+}
+
+bool AMasterRoom::IsDoorSealed(const FFixedDoorLocation& Door) const
+{
+	for (const FSealedDoorSlot& Slot : SealedDoors)
+	{
+		if (Slot.WallEdge == Door.WallEdge && Slot.StartCell == Door.StartCell)
 		{
-			FTransform Transform(WallRotation, Position, FVector(1.0f));
-			HISM->AddInstance(Transform);
-			
-			// Track this base wall for Middle/Top spawning
-			FWallSegmentInfo SegmentInfo;
-			SegmentInfo.Edge = Edge;
-			SegmentInfo.StartCell = CurrentCell;
-			SegmentInfo.SegmentLength = BestModule->Y_AxisFootprint;
-			SegmentInfo.BaseTransform = Transform;
-			SegmentInfo.BaseMesh = BaseMesh;
-			SegmentInfo.WallModule = BestModule;
-			PlacedBaseWalls.Add(SegmentInfo);
+			return true;
 		}
+	}
+	return false;
+}
+
+void AMasterRoom::FillWallSegment(EWallEdge Edge, int32 Line, int32 SegmentStart, int32 SegmentLength, FRandomStream& Stream)
+{
+	if (!SolverData || SolverData->WallFillOrder.Num() == 0) return;
+	const TArray<uint8>& Footprints = SolverData->WallFillFootprints;
+	
+	const int32 EdgeLength = FRoomBoundary::GetEdgeLength(Edge, RoomData->GridSize);
+	if (SegmentStart < 0 || SegmentStart >= EdgeLength) return;
+	
+	// Greedy bin packing: largest module first
+	int32 RemainingCells = SegmentLength;
+	int32 CurrentCell = SegmentStart;
+	
+	while (RemainingCells > 0)
+	{
+		// Find the largest module that fits: the fill order is sorted largest first, so it's the first
+		// entry whose footprint is <= the remaining cells
+		const int32 FillIndex = Algo::LowerBound(Footprints, (uint8)FMath::Min(RemainingCells, (int32)MAX_uint8), TGreater<>());
+		if (FillIndex >= Footprints.Num()) break;  // No module fits remaining space
+		
+		// Record the module - its transform and Middle/Top stack are derived when the layout is built
+		CurrentLayout.AddWall(Edge, Line, CurrentCell, SolverData->WallFillOrder[FillIndex], false);
 		
 		// Advance to next segment
-		RemainingCells -= BestModule->Y_AxisFootprint;
-		CurrentCell += BestModule->Y_AxisFootprint;
+		RemainingCells -= Footprints[FillIndex];
+		CurrentCell += Footprints[FillIndex];
+	}
+}
+
+void AMasterRoom::PlaceBaseWall(EWallEdge Edge, int32 Line, int32 StartCell, int32 ModuleIndex)
+{
+	const FCompiledWallModule& Module = CompiledWallStyle.Modules[ModuleIndex];
+	UStaticMesh* BaseMesh = Module.BaseMesh;
+	if (!BaseMesh) return;
+	
+	if (StartCell < 0 || StartCell >= FRoomBoundary::GetEdgeLength(Edge, RoomData->GridSize)) return;
+	
+	// Void cell the wall stands on: an outer boundary cell, or a carved cell for inner walls
+	const FIntPoint WallCell = FRoomBoundary::GetWallCell(Edge, Line, StartCell);
+	
+	FRotator WallRotation = GetWallRotationForEdge(Edge);
+	bool bIsNorthWall = (Edge == EWallEdge::North);
+	bool bIsEastWall = (Edge == EWallEdge::East);
+	
+	// Calculate position based on wall edge using the corrected helper functions
+	FVector Position;
+	float WallMeshLength = Module.Footprint * CELL_SIZE;
+	
+	if (bIsNorthWall || Edge == EWallEdge::South)
+	{
+		// North/South walls: Use Y coordinate from the wall cell
+		int32 X = WallCell.X;
+		int32 StartY = WallCell.Y;
+		Position = CalculateNorthSouthWallPosition(X, StartY, WallMeshLength, bIsNorthWall);
+	}
+	else  // East or West wall
+	{
+		// East/West walls: Use X coordinate from the wall cell
+		int32 StartX = WallCell.X;
+		int32 Y = WallCell.Y;
+		Position = CalculateEastWestWallPosition(StartX, Y, WallMeshLength, bIsEastWall);
 	}
+	
+	// Base walls spawn at floor level (Z=0)
+	// BottomBackCenter socket will be at floor level
+	// (No offset needed - mesh origin at floor)
+	FTransform Transform(WallRotation, Position, FVector(1.0f));
+	QueueInstance(BaseMesh, Transform, Module.CustomData);
+	
+	// Track this base wall for Middle/Top spawning
+	PlacedBaseWalls.Add(Edge, Line, StartCell, Module.Footprint, ModuleIndex, Transform);
 }
 
 void AMasterRoom::DrawDebugGrid()
 {
-	if (!RoomData) return;
-
-	const FIntPoint GridSize = RoomData->GridSize;
-	const FVector ActorLocation = GetActorLocation();
-	const UWorld* World = GetWorld();
-	if (!World) return;
-
-	// 1. Draw Grid Lines (Green)
+	// Editor worlds only (the component is hidden in game anyway), and the root must be registered to attach to
+	if (!RoomData || !GetWorld() || GetWorld()->IsGameWorld() || !RootComponent || !RootComponent->IsRegistered()) return;
+	
+	LLM_SCOPE_BYTAG(DungeonGen_Debug);
 	
-	// Draw X-Axis lines
-	for (int32 X = 0; X <= GridSize.X; ++X)
+	if (!bShowDebugGrid)
 	{
-		FVector Start = ActorLocation + FVector(X * CELL_SIZE, 0.0f, 0.0f);
-		FVector End = ActorLocation + FVector(X * CELL_SIZE, GridSize.Y * CELL_SIZE, 0.0f);
-		DrawDebugLine(World, Start, End, FColor::Green, false, 5.0f, 0, 5.0f);
+		if (DebugGrid)
+		{
+			DebugGrid->ClearGrid();
+		}
+		return;
 	}
-
-	// Draw Y-Axis lines
-	for (int32 Y = 0; Y <= GridSize.Y; ++Y)
+	
+	if (!DebugGrid)
 	{
-		FVector Start = ActorLocation + FVector(0.0f, Y * CELL_SIZE, 0.0f);
-		FVector End = ActorLocation + FVector(GridSize.X * CELL_SIZE, Y * CELL_SIZE, 0.0f);
-		DrawDebugLine(World, Start, End, FColor::Green, false, 5.0f, 0, 5.0f);
+		DebugGrid = NewObject<UDungeonDebugGridComponent>(this, TEXT("DebugGrid"), RF_Transient);
+		DebugGrid->SetupAttachment(RootComponent);
+		DebugGrid->RegisterComponent();
 	}
 	
-	// 2. Draw Forced Empty Regions (Cyan) - Designer Override Visualization
+	const FIntPoint GridSize = RoomData->GridSize;
+	auto IsInGrid = [&GridSize](const FIntPoint& Cell)
+	{
+		return Cell.X >= 0 && Cell.X < GridSize.X && Cell.Y >= 0 && Cell.Y < GridSize.Y;
+	};
 	
+	// Rasterize the forced-empty regions (handles any corner order, clamped to the grid, overlaps counted once)
+	FRoomShapeMask RegionMask;
+	RegionMask.Init(GridSize);
 	for (const FForcedEmptyRegion& Region : ForcedEmptyRegions)
 	{
-		// Calculate the bounding box (handles any corner order)
-		int32 MinX = FMath::Min(Region.StartCell.X, Region.EndCell.X);
-		int32 MaxX = FMath::Max(Region.StartCell.X, Region.EndCell.X);
-		int32 MinY = FMath::Min(Region.StartCell.Y, Region.EndCell.Y);
-		int32 MaxY = FMath::Max(Region.StartCell.Y, Region.EndCell.Y);
-
-		// Clamp to valid grid bounds
-		MinX = FMath::Clamp(MinX, 0, GridSize.X - 1);
-		MaxX = FMath::Clamp(MaxX, 0, GridSize.X - 1);
-		MinY = FMath::Clamp(MinY, 0, GridSize.Y - 1);
-		MaxY = FMath::Clamp(MaxY, 0, GridSize.Y - 1);
-
-		// Draw each cell in the region with cyan boxes
-		for (int32 Y = MinY; Y <= MaxY; ++Y)
-		{
-			for (int32 X = MinX; X <= MaxX; ++X)
-			{
-				// Center of the cell
-				FVector Center = ActorLocation + FVector(
-					(X + 0.5f) * CELL_SIZE, 
-					(Y + 0.5f) * CELL_SIZE, 
-					40.0f // Lift higher than normal boxes for visibility
-				);
-				
-				// Size of the box (half extent) - slightly larger for emphasis
-				FVector Extent(CELL_SIZE / 2.2f, CELL_SIZE / 2.2f, 25.0f);
-				
-				// Cyan color for forced empty regions
-				DrawDebugBox(World, Center, Extent, FQuat::Identity, FColor::Cyan, false, 5.0f, 0, 4.0f);
-			}
-		}
+		RegionMask.AddRegion(Region);
 	}
-
-	// 3. Draw Individual Forced Empty Cells (Cyan with Orange border)
+	TArray<FIntPoint> RegionCells;
+	RegionMask.GetCells(RegionCells);
 	
-	for (const FIntPoint& Cell : ForcedEmptyFloorCells)
+	TArray<FIntPoint> ForcedCells = ForcedEmptyFloorCells;
+	ForcedCells.RemoveAll([&IsInGrid](const FIntPoint& Cell) { return !IsInGrid(Cell); });
+	
+	// Preview: outline each solved wall module over its boundary cells (no wall instances exist yet)
+	TArray<FBox> WallOutlines;
+	if (bShowingLayoutPreview)
 	{
-		// Validate cell is within grid bounds
-		if (Cell.X >= 0 && Cell.X < GridSize.X && Cell.Y >= 0 && Cell.Y < GridSize.Y)
+		const FCompiledRoomData& Compiled = RoomData->GetCompiledTables();
+		const float WallHeight = Compiled.WallHeight > 0.0f ? Compiled.WallHeight : CELL_SIZE;
+		
+		for (const FRoomLayoutWall& Wall : CurrentLayout.Walls)
 		{
-			// Center of the cell
-			FVector Center = ActorLocation + FVector(
-				(Cell.X + 0.5f) * CELL_SIZE, 
-				(Cell.Y + 0.5f) * CELL_SIZE, 
-				40.0f // Same height as region boxes
-			);
-			
-			// Inner cyan box
-			FVector InnerExtent(CELL_SIZE / 2.2f, CELL_SIZE / 2.2f, 25.0f);
-			DrawDebugBox(World, Center, InnerExtent, FQuat::Identity, FColor::Cyan, false, 5.0f, 0, 4.0f);
+			const int32 Footprint = GetLayoutWallFootprint(Wall, Compiled);
+			const int32 EdgeLength = FRoomBoundary::GetEdgeLength(Wall.Edge, GridSize);
+			if (Footprint == 0 || Wall.StartCell >= EdgeLength) continue;
 			
-			// Outer orange border to distinguish from region cells
-			FVector OuterExtent(CELL_SIZE / 2.0f, CELL_SIZE / 2.0f, 27.0f);
-			DrawDebugBox(World, Center, OuterExtent, FQuat::Identity, FColor::Orange, false, 5.0f, 0, 2.0f);
+			const FIntPoint First = FRoomBoundary::GetWallCell(Wall.Edge, Wall.Line, Wall.StartCell);
+			const FIntPoint Last = FRoomBoundary::GetWallCell(Wall.Edge, Wall.Line, FMath::Min(Wall.StartCell + Footprint, EdgeLength) - 1);
+			WallOutlines.Emplace(
+				FVector(FMath::Min(First.X, Last.X) * CELL_SIZE, FMath::Min(First.Y, Last.Y) * CELL_SIZE, 0.0f),
+				FVector((FMath::Max(First.X, Last.X) + 1) * CELL_SIZE, (FMath::Max(First.Y, Last.Y) + 1) * CELL_SIZE, WallHeight));
 		}
 	}
 	
-	// 4. Draw Cell State Boxes (Red/Blue)
-	
-	for (int32 Y = 0; Y < GridSize.Y; ++Y)
-	{
-		for (int32 X = 0; X < GridSize.X; ++X)
-		{
-			int32 Index = Y * GridSize.X + X;
-			if (InternalGridState.IsValidIndex(Index))
-			{
-				// Center of the cell
-				FVector Center = ActorLocation + FVector(
-					(X + 0.5f) * CELL_SIZE, 
-					(Y + 0.5f) * CELL_SIZE, 
-					20.0f // Lift the box slightly above Z=0
-				);
-				
-				// Size of the box (half extent)
-				FVector Extent(CELL_SIZE / 2.0f, CELL_SIZE / 2.0f, 20.0f);
-				
-				FColor BoxColor = (InternalGridState[Index] != EGridCellType::ECT_Empty) ? FColor::Red : FColor::Blue;
+	// No-op unless the layout or the overrides changed
+	DebugGrid->SetGrid(GridSize, InternalGridState, RegionCells, ForcedCells, WallOutlines);
+}
 
-				DrawDebugBox(World, Center, Extent, FQuat::Identity, BoxColor, false, 5.0f, 0, 3.0f);
-			}
-		}
+int32 AMasterRoom::GetLayoutWallFootprint(const FRoomLayoutWall& Wall, const FCompiledRoomData& Compiled) const
+{
+	if (Wall.bForced)
+	{
+		return ForcedWalls.IsValidIndex(Wall.ModuleIndex) ? FMath::Max(ForcedWalls[Wall.ModuleIndex].WallModule.Y_AxisFootprint, 1) : 0;
 	}
+	return Compiled.WallModules.IsValidIndex(Wall.ModuleIndex) ? Compiled.WallModules[Wall.ModuleIndex].Footprint : 0;
 }
 
 // --- Component Management ---
@@ -688,16 +2104,25 @@ void AMasterRoom::DrawDebugGrid()
 void AMasterRoom::ClearAndResetComponents()
 {
 	// 1. Clear all instances from existing HISM components
-	for (const auto& Pair : MeshToHISMMap)
+	for (const auto* HISMMap : { &MeshToHISMMap, &ClutterHISMMap })
 	{
-		if (UHierarchicalInstancedStaticMeshComponent* HISM = Pair.Value)
+		for (const auto& Pair : *HISMMap)
 		{
-			HISM->ClearInstances();
+			if (UHierarchicalInstancedStaticMeshComponent* HISM = Pair.Value)
+			{
+				HISM->ClearInstances();
+			}
 		}
 	}
 	
-	// 2. Reset internal grid state
+	// 2. Return doorways to the pool (reused by the build pass instead of respawned), and shared instances to the manager
+	ReleaseDoorways();
+	ReleaseSharedInstances();
+	LocalLayoutHash = 0;
+	
+	// 3. Reset internal grid state
 	InternalGridState.Empty();
+	DoorConnectionPoints.Empty();
 	if (RoomData)
 	{
 		int32 TotalCells = RoomData->GridSize.X * RoomData->GridSize.Y;
@@ -706,19 +2131,26 @@ void AMasterRoom::ClearAndResetComponents()
 	}
 }
 
-UHierarchicalInstancedStaticMeshComponent* AMasterRoom::GetOrCreateHISM(UStaticMesh* Mesh)
+UHierarchicalInstancedStaticMeshComponent* AMasterRoom::GetOrCreateHISM(UStaticMesh* Mesh, bool bClutter)
 {
+	LLM_SCOPE_BYTAG(DungeonGen_Instances);
+	
 	if (!Mesh) return nullptr;
 
+	// Clutter has its own components so its render settings never touch the room geometry of the same mesh
+	TMap<UStaticMesh*, UHierarchicalInstancedStaticMeshComponent*>& HISMMap = bClutter ? ClutterHISMMap : MeshToHISMMap;
+
 	// Use a raw pointer for the key since UStaticMesh is a UObject and handles its own lifecycle
-	if (UHierarchicalInstancedStaticMeshComponent** HISM_Ptr = MeshToHISMMap.Find(Mesh))
+	if (UHierarchicalInstancedStaticMeshComponent** HISM_Ptr = HISMMap.Find(Mesh))
 	{
 		return *HISM_Ptr;
 	}
 	else
 	{
 		// Create a new HISM component for this unique mesh
-		FString ComponentName = FString::Printf(TEXT("HISM_%s"), *Mesh->GetName());
+		FString ComponentName = bClutter
+			? FString::Printf(TEXT("HISM_Clutter_%s"), *Mesh->GetName())
+			: FString::Printf(TEXT("HISM_%s"), *Mesh->GetName());
 		UHierarchicalInstancedStaticMeshComponent* NewHISM = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, FName(*ComponentName));
 		
 		if (NewHISM)
@@ -727,7 +2159,7 @@ UHierarchicalInstancedStaticMeshComponent* AMasterRoom::GetOrCreateHISM(UStaticM
 			NewHISM->RegisterComponent();
 			NewHISM->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
 			
-			MeshToHISMMap.Add(Mesh, NewHISM);
+			HISMMap.Add(Mesh, NewHISM);
 			return NewHISM;
 		}
 	}
@@ -744,9 +2176,9 @@ void AMasterRoom::GenerateFloorAndInterior()
 	FRandomStream RandomStream(GenerationSeed);
 	
 	const FIntPoint GridSize = RoomData->GridSize;
-	const UFloorData* FloorData = RoomData->FloorStyleData.LoadSynchronous();
+	const FCompiledRoomData& Compiled = *SolverData;
 	
-	if (!FloorData)
+	if (RoomData->FloorStyleData.IsNull())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("FloorData failed to load or is null. Cannot generate floor."));
 		return;
@@ -755,14 +2187,15 @@ void AMasterRoom::GenerateFloorAndInterior()
     // --- PASS 0: DESIGNER OVERRIDES: FORCED PLACEMENTS (NEW) ---
     ExecuteForcedPlacements(RandomStream);
     
-    // --- DESIGNER OVERRIDES: FORCED EMPTY CELLS (Uses Regions + Individual Cells) ---
-    // Expand all regions and individual cells into a unified list
-    TArray<FIntPoint> AllForcedEmptyCells = ExpandForcedEmptyRegions();
+    // --- DESIGNER OVERRIDES: FORCED EMPTY CELLS (Uses Preset + Regions + Individual Cells) ---
+    // One bit per cell, so overlapping regions cost nothing and each cell is visited once
+    FRoomShapeMask ForcedEmptyMask;
+    BuildForcedEmptyMask(ForcedEmptyMask);
     
     // Mark specific cells as reserved (to be empty) before Pass 1 begins
-    for (const FIntPoint& EmptyCoord : AllForcedEmptyCells)
+    for (TConstSetBitIterator<> It(ForcedEmptyMask.Bits); It; ++It)
     {
-        int32 Index = EmptyCoord.Y * GridSize.X + EmptyCoord.X;
+        const int32 Index = It.GetIndex();
         if (InternalGridState.IsValidIndex(Index) && InternalGridState[Index] == EGridCellType::ECT_Empty)
         {
             // Mark cell as a reserved boundary/empty slot
@@ -785,29 +2218,19 @@ void AMasterRoom::GenerateFloorAndInterior()
 				continue;
 			}
 			
-			// ... (A. Weighted Random Selection remains the same) ...
-			const FMeshPlacementInfo* MeshToPlaceInfo = SelectWeightedMesh(FloorData->FloorTilePool, RandomStream);
-			
-			if (!MeshToPlaceInfo || MeshToPlaceInfo->MeshAsset.IsPending())
-			{
-				if (MeshToPlaceInfo) MeshToPlaceInfo->MeshAsset.LoadSynchronous();
-				continue;
-			}
+			// A. Weighted Random Selection (integer weight table, meshes resolved when the tables were compiled)
+			const FCompiledMeshEntry* Entry = Compiled.FloorTiles.Select(RandomStream);
+			if (!Entry) continue;
 			
-			UStaticMesh* Mesh = MeshToPlaceInfo->MeshAsset.Get();
+			UStaticMesh* Mesh = RoomData->GetCompiledMesh(Entry->MeshIndex);
 			if (!Mesh) continue;
 
 			bool bCanPlace = true;
 
-			// ... (B. Select Rotation and Calculate Rotated Footprint remains the same) ...
-            const int32 RandomRotationIndex = RandomStream.RandRange(0, MeshToPlaceInfo->AllowedRotations.Num() - 1);
-			const float YawRotation = (float)MeshToPlaceInfo->AllowedRotations[RandomRotationIndex];
-
-			FIntPoint RotatedFootprint = MeshToPlaceInfo->GridFootprint;
-			if (FMath::IsNearlyEqual(YawRotation, 90.0f) || FMath::IsNearlyEqual(YawRotation, 270.0f))
-			{
-				RotatedFootprint = FIntPoint(MeshToPlaceInfo->GridFootprint.Y, MeshToPlaceInfo->GridFootprint.X);
-			}
+			// B. Select Rotation (validated quadrants - never empty) and Calculate Rotated Footprint
+			const uint8 Quadrant = Entry->Quadrants[RandomStream.RandRange(0, Entry->NumQuadrants - 1)];
+			const float YawRotation = Quadrant * 90.0f;
+			const FIntPoint RotatedFootprint = Entry->GetRotatedFootprint(Quadrant);
 
 			// C. Bounds and Occupancy Check (Crucially checks against all existing occupations, including forced items)
 			if (X + RotatedFootprint.X > GridSize.X || Y + RotatedFootprint.Y > GridSize.Y)
@@ -834,29 +2257,18 @@ void AMasterRoom::GenerateFloorAndInterior()
 				}
 			}
 
-			// D. Placement and Grid Marking (remains the same)
+			// D. Placement and Grid Marking (recorded in the layout, instances are built from it afterwards)
 			if (bCanPlace)
 			{
-				UHierarchicalInstancedStaticMeshComponent* HISM = GetOrCreateHISM(Mesh);
-				if (HISM)
+				CurrentLayout.AddPlacement(Mesh, FIntPoint(X, Y), RotatedFootprint, YawRotation, ERoomLayoutLayer::Floor, Entry->CustomData);
+				
+				// Mark all cells as occupied
+				for (int32 FootY = 0; FootY < RotatedFootprint.Y; ++FootY)
 				{
-					FVector CenterLocation = FVector(
-						(X + RotatedFootprint.X / 2.0f) * CELL_SIZE, 
-						(Y + RotatedFootprint.Y / 2.0f) * CELL_SIZE, 
-						0.0f
-					);
-					
-					FTransform InstanceTransform(FRotator(0.0f, YawRotation, 0.0f), CenterLocation);
-					HISM->AddInstance(InstanceTransform);
-					
-					// Mark all cells as occupied
-					for (int32 FootY = 0; FootY < RotatedFootprint.Y; ++FootY)
+					for (int32 FootX = 0; FootX < RotatedFootprint.X; ++FootX)
 					{
-						for (int32 FootX = 0; FootX < RotatedFootprint.X; ++FootX)
-						{
-							int32 FootIndex = (Y + FootY) * GridSize.X + (X + FootX);
-							InternalGridState[FootIndex] = EGridCellType::ECT_FloorMesh; 
-						}
+						int32 FootIndex = (Y + FootY) * GridSize.X + (X + FootX);
+						InternalGridState[FootIndex] = EGridCellType::ECT_FloorMesh; 
 					}
 				}
 			}
@@ -866,11 +2278,9 @@ void AMasterRoom::GenerateFloorAndInterior()
 
     // --- PASS 2: GAP FILLING WITH DEFAULT 1x1 TILE (Modified to respect forced empty cells) ---
     
-    UStaticMesh* FillerMesh = FloorData->DefaultFillerTile.LoadSynchronous();
+    UStaticMesh* FillerMesh = RoomData->GetCompiledMesh(Compiled.FillerMeshIndex);
     if (FillerMesh)
     {
-        UHierarchicalInstancedStaticMeshComponent* HISM = GetOrCreateHISM(FillerMesh);
-        
         for (int32 Y = 0; Y < GridSize.Y; ++Y)
         {
             for (int32 X = 0; X < GridSize.X; ++X)
@@ -881,14 +2291,7 @@ void AMasterRoom::GenerateFloorAndInterior()
                 if (InternalGridState[Index] == EGridCellType::ECT_Empty)
                 {
                     // Placement is trivial since it's a 1x1 tile
-                    FVector CenterLocation = FVector(
-                        (X + 0.5f) * CELL_SIZE, 
-                        (Y + 0.5f) * CELL_SIZE, 
-                        0.0f
-                    );
-                    
-                    FTransform InstanceTransform(FRotator::ZeroRotator, CenterLocation);
-                    HISM->AddInstance(InstanceTransform);
+                    CurrentLayout.AddPlacement(FillerMesh, FIntPoint(X, Y), FIntPoint(1, 1), 0.0f, ERoomLayoutLayer::Floor);
                     
                     // Mark cell as ECT_FloorMesh, it is now filled
                     InternalGridState[Index] = EGridCellType::ECT_FloorMesh; 
@@ -900,10 +2303,7 @@ void AMasterRoom::GenerateFloorAndInterior()
 
 void AMasterRoom::GenerateWallsAndDoors()
 {
-	if (!RoomData) return;
-
-	UWallData* WallData = RoomData->WallStyleData.LoadSynchronous();
-	if (!WallData) return;
+	if (!RoomData || RoomData->WallStyleData.IsNull()) return;
 
 	// Clear OccupancyGrid for fresh generation
 	OccupancyGrid.Empty();
@@ -959,6 +2359,14 @@ void AMasterRoom::GenerateWallsAndDoors()
 	// Place forced walls before random generation so they take priority
 	PlaceForcedWalls();
 
+	// --- Boundary Tracing ---
+	// Walls go wherever floor meets void: the outer edges where floor reaches them, and the
+	// carved edges of L/T/U shapes, so non-rectangular rooms are enclosed without forced walls
+	const FIntPoint GridSize = RoomData->GridSize;
+	FRoomBoundary Boundary;
+	TraceFloorBoundary(Boundary);
+	UE_LOG(LogTemp, Verbose, TEXT("Boundary traced: %d runs, %d corners"), Boundary.Runs.Num(), Boundary.Corners.Num());
+
 	TArray<EWallEdge> Edges = {EWallEdge::North, EWallEdge::South, EWallEdge::East, EWallEdge::West};
 	
 	for (EWallEdge Edge : Edges)
@@ -966,20 +2374,33 @@ void AMasterRoom::GenerateWallsAndDoors()
 		TArray<FIntPoint> EdgeCells = GetCellsForEdge(Edge);
 		if (EdgeCells.Num() == 0) continue;
 
+		// Only cells covered by an outer boundary run have floor behind them - carved cells along
+		// the edge stay open (their walls are on the inner runs)
+		const int32 OuterLine = FRoomBoundary::GetOuterLine(Edge, GridSize);
 		TArray<bool> CellOccupied;
-		CellOccupied.SetNum(EdgeCells.Num());
+		CellOccupied.Init(true, EdgeCells.Num());
+		for (const FRoomBoundaryRun& Run : Boundary.Runs)
+		{
+			if (Run.Edge != Edge || Run.Line != OuterLine) continue;
+			for (int32 i = Run.Start; i < Run.Start + Run.Length; ++i)
+			{
+				CellOccupied[i] = false;
+			}
+		}
+		
 		for (int32 i = 0; i < EdgeCells.Num(); ++i)
 		{
 			// Check if cell is already occupied (by forced walls or other elements)
-			CellOccupied[i] = OccupancyGrid.Contains(EdgeCells[i]);
+			CellOccupied[i] |= OccupancyGrid.Contains(EdgeCells[i]);
 		}
 
 		// --- PASS 1: Mark Door Cells and Place ONLY Side Frames ---
 		int32 DoorsOnThisEdge = 0;
 		UE_LOG(LogTemp, Warning, TEXT(">>> Processing Edge %d <<<"), (int32)Edge);
 		
-		for (const FFixedDoorLocation& DoorLoc : FixedDoorLocations)
+		for (int32 DoorIndex = 0; DoorIndex < FixedDoorLocations.Num(); ++DoorIndex)
 		{
+			const FFixedDoorLocation& DoorLoc = FixedDoorLocations[DoorIndex];
 			UE_LOG(LogTemp, Warning, TEXT("  Checking door: Edge=%d vs %d, DoorData=%s"), 
 				(int32)DoorLoc.WallEdge, (int32)Edge, DoorLoc.DoorData ? TEXT("Valid") : TEXT("NULL"));
 			
@@ -989,6 +2410,12 @@ void AMasterRoom::GenerateWallsAndDoors()
 				continue;
 			}
 			
+			if (IsDoorSealed(DoorLoc))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("    SKIPPED (sealed by DungeonManager - walls will fill the gap)"));
+				continue;
+			}
+			
 			DoorsOnThisEdge++;
 			UE_LOG(LogTemp, Warning, TEXT(">>> PLACING DOOR #%d on edge %d <<<"), DoorsOnThisEdge, (int32)Edge);
 			UE_LOG(LogTemp, Warning, TEXT("  StartCell: %d"), DoorLoc.StartCell);
@@ -997,80 +2424,25 @@ void AMasterRoom::GenerateWallsAndDoors()
 			int32 DoorFootprint = FMath::Max(1, DoorData->FrameFootprintY);
 			UE_LOG(LogTemp, Warning, TEXT("  DoorFootprint: %d"), DoorFootprint);
 			
-			// Load door frame side mesh only
-			UStaticMesh* FrameSideMesh = DoorData->FrameSideMesh.LoadSynchronous();
-			UE_LOG(LogTemp, Warning, TEXT("  FrameSideMesh: %s"), FrameSideMesh ? *FrameSideMesh->GetName() : TEXT("NULL"));
-			
-			FRotator WallRotation = GetWallRotationForEdge(Edge);
-			// NOTE: If using the designer-editable offset (from previous suggestion), apply it here:
-			// FRotator FinalRotation = WallRotation + DoorData->FrameRotationOffset;
-			FRotator FinalRotation = WallRotation; 
-
-			bool bIsNorthWall = (Edge == EWallEdge::North);
-			bool bIsEastWall = (Edge == EWallEdge::East);
-			
-			// --- Placement of Door Frame Meshes ---
-			if (FrameSideMesh)
+			// --- Record Door in Layout ---
+			// Procedural doors are stored as a reference into the door style (or its pool) so the
+			// layout stays independent of the transient FixedDoorLocations array
+			if (bEnableProceduralDoors)
 			{
-				UHierarchicalInstancedStaticMeshComponent* HISM_Side = GetOrCreateHISM(FrameSideMesh);
-				if (HISM_Side)
+				UDoorData* DoorStyle = RoomData->DoorStyleData.LoadSynchronous();
+				if (DoorData == DoorStyle)
 				{
-					int32 InstancesBefore = HISM_Side->GetInstanceCount();
-					UE_LOG(LogTemp, Warning, TEXT("  HISM Component: %s (instances BEFORE adding: %d)"), 
-						*HISM_Side->GetName(), InstancesBefore);
-					
-					// Apply door rotation (wall rotation + any door-specific offset)
-					FRotator DoorRotation = WallRotation + DoorData->FrameRotationOffset;
-
-					// CRITICAL: For COMPLETE door frame meshes (not separate pillars)
-					// Place ONE instance centered across the door span
-					
-					// Calculate center position of the door span
-					// For 2-cell door at StartCell=1: center between cells 1 and 2 = Y=200
-					float DoorSpanCenter;
-					if (Edge == EWallEdge::North || Edge == EWallEdge::South)
-					{
-						// North/South doors span along Y-axis
-						DoorSpanCenter = (DoorLoc.StartCell * CELL_SIZE) + ((DoorFootprint * CELL_SIZE) / 2.0f);
-					}
-					else
-					{
-						// East/West doors span along X-axis
-						DoorSpanCenter = (DoorLoc.StartCell * CELL_SIZE) + ((DoorFootprint * CELL_SIZE) / 2.0f);
-					}
-					
-					// Get the base position using the middle of the door span
-					float MiddleCell = DoorLoc.StartCell + (DoorFootprint / 2.0f);
-					FVector DoorCenterPos = CalculateDoorPosition(Edge, MiddleCell, 0.0f);
-					
-					// Door frames spawn at floor level (Z=0), matching base walls
-					// BottomBackCenter socket will be at floor level
-					
-					// Apply per-door frame position offset
-					DoorCenterPos += DoorLoc.DoorPositionOffsets.FramePositionOffset;
-					
-					UE_LOG(LogTemp, Warning, TEXT("  Placing COMPLETE door frame: Footprint=%d cells, StartCell=%d"), 
-						DoorFootprint, DoorLoc.StartCell);
-					UE_LOG(LogTemp, Warning, TEXT("  Calculated middle cell: %.2f"), MiddleCell);
-					UE_LOG(LogTemp, Warning, TEXT("  Applied FramePositionOffset: %s"), 
-						*DoorLoc.DoorPositionOffsets.FramePositionOffset.ToString());
-					
-					// Place ONE instance of the complete door frame
-					HISM_Side->AddInstance(FTransform(DoorRotation, DoorCenterPos, FVector(1.0f)));
-					UE_LOG(LogTemp, Warning, TEXT("    >>> PLACED DOOR FRAME at position: %s (instances now: %d)"), 
-						*DoorCenterPos.ToString(), HISM_Side->GetInstanceCount());
-					
-					UE_LOG(LogTemp, Warning, TEXT("  TOTAL instances added for this door: 1 (Complete Frame)"));
-					UE_LOG(LogTemp, Warning, TEXT("  Final HISM instance count: %d"), HISM_Side->GetInstanceCount());
+					CurrentLayout.AddDoor(Edge, DoorLoc.StartCell, ERoomLayoutDoorSource::DoorStyle, 0);
 				}
 				else
 				{
-					UE_LOG(LogTemp, Error, TEXT("  ERROR: Failed to get HISM component!"));
+					const int32 PoolIndex = DoorStyle ? DoorStyle->DoorStylePool.IndexOfByKey(DoorData) : INDEX_NONE;
+					CurrentLayout.AddDoor(Edge, DoorLoc.StartCell, ERoomLayoutDoorSource::DoorStylePool, PoolIndex);
 				}
 			}
 			else
 			{
-				UE_LOG(LogTemp, Error, TEXT("  ERROR: FrameSideMesh is NULL!"));
+				CurrentLayout.AddDoor(Edge, DoorLoc.StartCell, ERoomLayoutDoorSource::FixedLocation, DoorIndex);
 			}
 			
 			// Mark the cells as occupied by this door (essential for wall filling logic)
@@ -1093,10 +2465,7 @@ void AMasterRoom::GenerateWallsAndDoors()
 				}
 			}
 			
-			// TODO: Add logic here to spawn the ADoorway actor using DoorData->DoorwayClass
-			// When implemented, apply DoorLoc.DoorPositionOffsets.ActorPositionOffset to actor position:
-			// FVector ActorPos = DoorCenterPos + DoorLoc.DoorPositionOffsets.ActorPositionOffset;
-			// GetWorld()->SpawnActor<ADoorway>(DoorData->DoorwayClass, ActorPos, DoorRotation);
+			// The frame mesh and ADoorway actor are placed from this record in BuildFromLayout (PlaceDoorFrame)
 		}
 
 		// --- PASS 2: Find continuous wall segments (non-door cells) and fill them ---
@@ -1120,7 +2489,7 @@ void AMasterRoom::GenerateWallsAndDoors()
 					int32 SegmentLength = i - SegmentStart;
 					UE_LOG(LogTemp, Warning, TEXT("  Found wall segment: Start=%d, Length=%d"), 
 						SegmentStart, SegmentLength);
-					FillWallSegment(Edge, SegmentStart, SegmentLength, RandomStream);
+					FillWallSegment(Edge, OuterLine, SegmentStart, SegmentLength, RandomStream);
 					SegmentStart = -1;
 				}
 			}
@@ -1132,25 +2501,97 @@ void AMasterRoom::GenerateWallsAndDoors()
 			int32 SegmentLength = CellOccupied.Num() - SegmentStart;
 			UE_LOG(LogTemp, Warning, TEXT("  Found final wall segment: Start=%d, Length=%d"), 
 				SegmentStart, SegmentLength);
-			FillWallSegment(Edge, SegmentStart, SegmentLength, RandomStream);
+			FillWallSegment(Edge, OuterLine, SegmentStart, SegmentLength, RandomStream);
 		}
 	}
 	
-	// --- Spawn Middle & Top Wall Layers ---
-	// Now that all base walls are placed and tracked, spawn stacked layers
-	SpawnMiddleWalls();
-	SpawnTopWalls();
+	// --- Inner Boundary Runs ---
+	// Carved edges take no doors or forced walls, so each run is filled as one segment
+	for (const FRoomBoundaryRun& Run : Boundary.Runs)
+	{
+		if (Run.Line == FRoomBoundary::GetOuterLine(Run.Edge, GridSize)) continue;
+		
+		UE_LOG(LogTemp, Verbose, TEXT("  Inner wall run: Edge=%d, Line=%d, Start=%d, Length=%d"),
+			(int32)Run.Edge, Run.Line, Run.Start, Run.Length);
+		FillWallSegment(Run.Edge, Run.Line, Run.Start, Run.Length, RandomStream);
+	}
 	
-	// --- Spawn Corner Pieces ---
-	// Place corner meshes at the 4 room corners
-	SpawnCorners();
+	// Middle/Top layers, corners and door connection points are derived from the layout in BuildFromLayout()
 	
 	UE_LOG(LogTemp, Warning, TEXT("========================================"));
 	UE_LOG(LogTemp, Warning, TEXT("GenerateWallsAndDoors() COMPLETE"));
-	UE_LOG(LogTemp, Warning, TEXT("Base walls placed: %d segments"), PlacedBaseWalls.Num());
+	UE_LOG(LogTemp, Warning, TEXT("Layout walls recorded: %d, doors recorded: %d"), CurrentLayout.Walls.Num(), CurrentLayout.Doors.Num());
 	UE_LOG(LogTemp, Warning, TEXT("========================================"));
 }
 
+void AMasterRoom::PlaceDoorFrame(const FFixedDoorLocation& DoorLoc, const FCompiledDoorFrame& Frame)
+{
+	const EWallEdge Edge = DoorLoc.WallEdge;
+	int32 DoorFootprint = Frame.Footprint;
+	
+	// Apply door rotation (wall rotation + any door-specific offset)
+	FRotator WallRotation = GetWallRotationForEdge(Edge);
+	FRotator DoorRotation = WallRotation + Frame.RotationOffset;
+	
+	// CRITICAL: For COMPLETE door frame meshes (not separate pillars)
+	// Place ONE instance centered across the door span
+	// For 2-cell door at StartCell=1: center between cells 1 and 2
+	float MiddleCell = DoorLoc.StartCell + (DoorFootprint / 2.0f);
+	FVector DoorCenterPos = CalculateDoorPosition(Edge, MiddleCell, 0.0f);
+	
+	// Door frames spawn at floor level (Z=0), matching base walls
+	// Apply per-door frame position offset
+	DoorCenterPos += DoorLoc.DoorPositionOffsets.FramePositionOffset;
+	
+	// Door frame side mesh only (loaded with the compiled tables)
+	UStaticMesh* FrameSideMesh = Frame.FrameMesh;
+	if (FrameSideMesh)
+	{
+		QueueInstance(FrameSideMesh, FTransform(DoorRotation, DoorCenterPos, FVector(1.0f)));
+		InstanceCollisionMeshes.Add(FrameSideMesh);
+		UE_LOG(LogTemp, Warning, TEXT("  Placed door frame on edge %d at position: %s (Footprint=%d, StartCell=%d)"), 
+			(int32)Edge, *DoorCenterPos.ToString(), DoorFootprint, DoorLoc.StartCell);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("  ERROR: FrameSideMesh is NULL!"));
+	}
+	
+	// --- Functional Doorway Actor ---
+	// Queued here and acquired from the doorway pool in one batch at the end of the build
+	// Actor position = frame position + ActorPositionOffset, room-local like every instance and transformed into world space
+	if (Frame.DoorwayClass)
+	{
+		const FVector LocalDoorwayPos = DoorCenterPos + DoorLoc.DoorPositionOffsets.ActorPositionOffset;
+		
+		FDoorwaySpawnRequest& Request = PendingDoorways.AddDefaulted_GetRef();
+		Request.DoorwayClass = Frame.DoorwayClass;
+		Request.Transform = FTransform(DoorRotation, LocalDoorwayPos) * GetActorTransform();
+	}
+}
+
+void AMasterRoom::SpawnPendingDoorways()
+{
+	// Doorways are replicated actors - only the server spawns them (clients only rebuild the static meshes)
+	UWorld* World = GetWorld();
+	UDoorwayPoolSubsystem* DoorwayPool = World ? World->GetSubsystem<UDoorwayPoolSubsystem>() : nullptr;
+	if (DoorwayPool && HasAuthority())
+	{
+		DoorwayPool->AcquireDoorways(PendingDoorways, this, SpawnedDoorways);
+	}
+	PendingDoorways.Reset();
+}
+
+void AMasterRoom::ReleaseDoorways()
+{
+	UWorld* World = GetWorld();
+	if (UDoorwayPoolSubsystem* DoorwayPool = World ? World->GetSubsystem<UDoorwayPoolSubsystem>() : nullptr)
+	{
+		DoorwayPool->ReleaseDoorways(SpawnedDoorways);
+	}
+	SpawnedDoorways.Reset();
+}
+
 void AMasterRoom::PlaceProceduralDoors(FRandomStream& Stream)
 {
 	if (!RoomData) return;
@@ -1246,37 +2687,18 @@ void AMasterRoom::PlaceProceduralDoors(FRandomStream& Stream)
 		UE_LOG(LogTemp, Warning, TEXT("  Selected gap #%d: StartCell=%d, Size=%d"), 
 			RandomGapIndex, GapStart, GapSize);
 		
-		// Select a size-appropriate door from pool
-		UDoorData* SelectedDoor = nullptr;
-		int32 Attempts = 0;
-		const int32 MaxAttempts = 10;
-		
-		while (Attempts < MaxAttempts && !SelectedDoor)
-		{
-			UDoorData* CandidateDoor = SelectRandomDoorFromPool(Stream);
-			if (CandidateDoor)
-			{
-				int32 DoorFootprint = FMath::Max(1, CandidateDoor->FrameFootprintY);
-				
-				// Check if door fits in gap
-				if (DoorFootprint <= GapSize)
-				{
-					SelectedDoor = CandidateDoor;
-					UE_LOG(LogTemp, Warning, TEXT("    Selected door with footprint %d"), DoorFootprint);
-					break;
-				}
-			}
-			Attempts++;
-		}
-		
+		// Select a size-appropriate door from pool (only doors that fit the gap are candidates)
+		UDoorData* SelectedDoor = SelectRandomDoorFromPool(Stream, GapSize);
 		if (!SelectedDoor)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("    FAILED: Could not find door that fits after %d attempts"), MaxAttempts);
+			UE_LOG(LogTemp, Warning, TEXT("    FAILED: No door in the pool fits a gap of %d cells"), GapSize);
 			continue;
 		}
 		
-		// Calculate random placement position within gap
 		int32 DoorFootprint = FMath::Max(1, SelectedDoor->FrameFootprintY);
+		UE_LOG(LogTemp, Warning, TEXT("    Selected door with footprint %d"), DoorFootprint);
+		
+		// Calculate random placement position within gap
 		int32 MaxOffset = GapSize - DoorFootprint;
 		int32 RandomOffset = (MaxOffset > 0) ? Stream.RandRange(0, MaxOffset) : 0;
 		int32 PlacementCell = GapStart + RandomOffset;
@@ -1383,32 +2805,20 @@ void AMasterRoom::ExecuteForcedPlacements(FRandomStream& Stream)
 		// 5. Placement and Grid Marking (Executed ONLY if all checks passed)
 		if (bCanPlace)
 		{
-			UHierarchicalInstancedStaticMeshComponent* HISM = GetOrCreateHISM(Mesh);
-			if (HISM)
+			// CRITICAL: Record the placement (Center Pivot assumed, transform is derived when the layout is built)
+			CurrentLayout.AddPlacement(Mesh, StartCoord, RotatedFootprint, YawRotation, ERoomLayoutLayer::Interior, MeshToPlaceInfo.CustomData);
+			
+			// CRITICAL: Mark all covered cells as occupied (Red in debug view)
+			for (int32 FootY = 0; FootY < RotatedFootprint.Y; ++FootY)
 			{
-				// Calculate position (Center Pivot assumed)
-				FVector CenterLocation = FVector(
-					(StartCoord.X + RotatedFootprint.X / 2.0f) * CELL_SIZE, 
-					(StartCoord.Y + RotatedFootprint.Y / 2.0f) * CELL_SIZE, 
-					0.0f
-				);
-				
-				FTransform InstanceTransform(FRotator(0.0f, YawRotation, 0.0f), CenterLocation);
-				
-				// CRITICAL: Add the instance visually
-				HISM->AddInstance(InstanceTransform);
-				
-				// CRITICAL: Mark all covered cells as occupied (Red in debug view)
-				for (int32 FootY = 0; FootY < RotatedFootprint.Y; ++FootY)
+				for (int32 FootX = 0; FootX < RotatedFootprint.X; ++FootX)
 				{
-					for (int32 FootX = 0; FootX < RotatedFootprint.X; ++FootX)
+					int32 FootIndex = (StartCoord.Y + FootY) * GridSize.X + (StartCoord.X + FootX);
+					
+					if (InternalGridState.IsValidIndex(FootIndex)) 
 					{
-						int32 FootIndex = (StartCoord.Y + FootY) * GridSize.X + (StartCoord.X + FootX);
-						
-						if (InternalGridState.IsValidIndex(FootIndex)) 
-						{
-							InternalGridState[FootIndex] = EGridCellType::ECT_FloorMesh; 
-						}
+						// Interior meshes block movement - kept distinct from walkable floor tiles
+						InternalGridState[FootIndex] = EGridCellType::ECT_Interior; 
 					}
 				}
 			}
@@ -1493,67 +2903,20 @@ void AMasterRoom::PlaceForcedWalls()
 			continue;
 		}
 
-		// Calculate wall position
-		FVector WallPosition;
-		bool bIsNorthWall = (ForcedWall.Edge == EWallEdge::North);
-		bool bIsEastWall = (ForcedWall.Edge == EWallEdge::East);
-
-		float WallLength = Footprint * CELL_SIZE;
+		// Record the forced wall - BuildFromLayout() resolves it back to ForcedWalls[i]
+		CurrentLayout.AddWall(ForcedWall.Edge, FRoomBoundary::GetOuterLine(ForcedWall.Edge, RoomData->GridSize), ForcedWall.StartCell, i, true);
+		UE_LOG(LogTemp, Warning, TEXT("    BASE WALL RECORDED (Edge=%d, StartCell=%d)"),
+			(int32)ForcedWall.Edge, ForcedWall.StartCell);
 
-		if (ForcedWall.Edge == EWallEdge::North || ForcedWall.Edge == EWallEdge::South)
-		{
-			// North/South walls: Get X and StartY from EdgeCells
-			int32 X = EdgeCells[ForcedWall.StartCell].X;
-			int32 StartY = EdgeCells[ForcedWall.StartCell].Y;
-			WallPosition = CalculateNorthSouthWallPosition(X, StartY, WallLength, bIsNorthWall);
-		}
-		else
+		// Mark cells as occupied
+		for (int32 j = 0; j < Footprint; j++)
 		{
-			// East/West walls: Get StartX and Y from EdgeCells
-			int32 StartX = EdgeCells[ForcedWall.StartCell].X;
-			int32 Y = EdgeCells[ForcedWall.StartCell].Y;
-			WallPosition = CalculateEastWestWallPosition(StartX, Y, WallLength, bIsEastWall);
+			int32 CellIndex = ForcedWall.StartCell + j;
+			FIntPoint CellCoord = EdgeCells[CellIndex];
+			OccupancyGrid.Add(CellCoord, EGridCellType::ECT_Wall);
 		}
 
-		// Get wall rotation
-		FRotator WallRotation = GetWallRotationForEdge(ForcedWall.Edge);
-
-		// Spawn base wall mesh
-		UHierarchicalInstancedStaticMeshComponent* HISM = GetOrCreateHISM(BaseMesh);
-		if (HISM)
-		{
-			FTransform WallTransform(WallRotation, WallPosition, FVector(1.0f));
-			int32 InstanceIndex = HISM->AddInstance(WallTransform);
-
-			UE_LOG(LogTemp, Warning, TEXT("    BASE WALL PLACED at %s (Instance %d)"),
-				*WallPosition.ToString(), InstanceIndex);
-
-			// Mark cells as occupied
-			for (int32 j = 0; j < Footprint; j++)
-			{
-				int32 CellIndex = ForcedWall.StartCell + j;
-				FIntPoint CellCoord = EdgeCells[CellIndex];
-				OccupancyGrid.Add(CellCoord, EGridCellType::ECT_Wall);
-			}
-
-			// Track for Middle/Top spawning
-			FWallSegmentInfo SegmentInfo;
-			SegmentInfo.Edge = ForcedWall.Edge;
-			SegmentInfo.StartCell = ForcedWall.StartCell;
-			SegmentInfo.SegmentLength = Footprint;
-			SegmentInfo.BaseTransform = WallTransform;
-			SegmentInfo.BaseMesh = BaseMesh;
-			SegmentInfo.WallModule = &Module;
-
-			PlacedBaseWalls.Add(SegmentInfo);
-
-			WallsPlaced++;
-		}
-		else
-		{
-			UE_LOG(LogTemp, Error, TEXT("    SKIPPED: Failed to get/create HISM"));
-			WallsSkipped++;
-		}
+		WallsPlaced++;
 	}
 
 	UE_LOG(LogTemp, Warning, TEXT("Forced walls complete: %d placed, %d skipped"), WallsPlaced, WallsSkipped);
@@ -1564,52 +2927,24 @@ void AMasterRoom::PlaceForcedWalls()
 // DOOR VARIETY HELPER FUNCTIONS (Hybrid System)
 // ==================================================================================
 
-UDoorData* AMasterRoom::SelectRandomDoorFromPool(FRandomStream& Stream) const
+UDoorData* AMasterRoom::SelectRandomDoorFromPool(FRandomStream& Stream, int32 MaxFootprint) const
 {
-	if (!RoomData) return nullptr;
-	
-	// Load the DoorData asset
-	UDoorData* DoorData = RoomData->DoorStyleData.LoadSynchronous();
-	if (!DoorData || DoorData->DoorStylePool.Num() == 0)
-	{
-		// No pool available, return the DoorData itself as fallback (single door mode)
-		return DoorData;
-	}
-	
-	// Calculate total weight
-	float TotalWeight = 0.0f;
-	for (UDoorData* PoolDoor : DoorData->DoorStylePool)
-	{
-		if (PoolDoor)
-		{
-			TotalWeight += PoolDoor->PlacementWeight;
-		}
-	}
+	if (!RoomData || !SolverData) return nullptr;
 	
-	if (TotalWeight <= 0.0f)
-	{
-		// If all weights are 0, pick randomly
-		return DoorData->DoorStylePool[Stream.RandRange(0, DoorData->DoorStylePool.Num() - 1)];
-	}
+	// The compiled pool is sorted by footprint, so the doors that fit are a prefix of it -
+	// one weighted pick over that prefix (no pick-and-retry)
+	const int32 NumFitting = SolverData->GetNumDoorsFitting(MaxFootprint);
+	const int32 Index = SolverData->DoorWeights.Select(Stream, NumFitting);
+	if (Index == INDEX_NONE) return nullptr;
 	
-	// Weighted random selection
-	float RandomValue = Stream.FRandRange(0.0f, TotalWeight);
-	float CurrentWeight = 0.0f;
+	UDoorData* DoorData = RoomData->DoorStyleData.LoadSynchronous();
+	if (!DoorData) return nullptr;
 	
-	for (UDoorData* PoolDoor : DoorData->DoorStylePool)
-	{
-		if (PoolDoor)
-		{
-			CurrentWeight += PoolDoor->PlacementWeight;
-			if (RandomValue <= CurrentWeight)
-			{
-				return PoolDoor;
-			}
-		}
-	}
+	// No pool: the DoorData itself is the only door (single door mode)
+	const int32 PoolIndex = SolverData->DoorPoolIndices[Index];
+	if (PoolIndex == INDEX_NONE) return DoorData;
 	
-	// Fallback (should never reach here)
-	return DoorData->DoorStylePool[0];
+	return DoorData->DoorStylePool.IsValidIndex(PoolIndex) ? DoorData->DoorStylePool[PoolIndex] : nullptr;
 }
 
 bool AMasterRoom::CanFitDoor(EWallEdge Edge, int32 StartCell, int32 Footprint) const
@@ -1734,6 +3069,37 @@ TArray<TPair<int32, int32>> AMasterRoom::GetValidDoorLocations(EWallEdge Edge) c
 		return A.Key < B.Key;
 	});
 	
+	// Edge cells with a carved cell behind them get no wall, so a door there would open onto nothing
+	auto HasFloorBehind = [&](int32 Along)
+	{
+		const FIntPoint Inner =
+			Edge == EWallEdge::North ? FIntPoint(GridSize.X - 1, Along) :
+			Edge == EWallEdge::South ? FIntPoint(0, Along) :
+			Edge == EWallEdge::East  ? FIntPoint(Along, GridSize.Y - 1) :
+			                           FIntPoint(Along, 0);
+		const int32 Index = Inner.Y * GridSize.X + Inner.X;
+		return !InternalGridState.IsValidIndex(Index) || InternalGridState[Index] != EGridCellType::ECT_Wall;
+	};
+	
+	// Add a gap, split into its floor-backed stretches
+	auto AddGap = [&](int32 GapStart, int32 GapEnd)
+	{
+		int32 StretchStart = INDEX_NONE;
+		for (int32 Cell = GapStart; Cell <= GapEnd; ++Cell)
+		{
+			const bool bUsable = Cell < GapEnd && HasFloorBehind(Cell);
+			if (bUsable && StretchStart == INDEX_NONE)
+			{
+				StretchStart = Cell;
+			}
+			else if (!bUsable && StretchStart != INDEX_NONE)
+			{
+				ValidLocations.Add(TPair<int32, int32>(StretchStart, Cell - StretchStart));
+				StretchStart = INDEX_NONE;
+			}
+		}
+	};
+	
 	// Find gaps between occupied ranges
 	int32 CurrentPos = 0;
 	
@@ -1745,8 +3111,7 @@ TArray<TPair<int32, int32>> AMasterRoom::GetValidDoorLocations(EWallEdge Edge) c
 		if (GapEnd > GapStart)
 		{
 			// Found a gap!
-			int32 GapSize = GapEnd - GapStart;
-			ValidLocations.Add(TPair<int32, int32>(GapStart, GapSize));
+			AddGap(GapStart, GapEnd);
 		}
 		
 		CurrentPos = Range.Value;
@@ -1755,109 +3120,45 @@ TArray<TPair<int32, int32>> AMasterRoom::GetValidDoorLocations(EWallEdge Edge) c
 	// Check for gap at the end
 	if (CurrentPos < EdgeSize)
 	{
-		int32 GapSize = EdgeSize - CurrentPos;
-		ValidLocations.Add(TPair<int32, int32>(CurrentPos, GapSize));
+		AddGap(CurrentPos, EdgeSize);
 	}
 	
 	return ValidLocations;
 }
 
-// --- Middle & Top Wall Spawning Implementation ---
-
-void AMasterRoom::SpawnMiddleWalls()
-{
-	if (!RoomData) return;
-	
-	UWallData* WallData = RoomData->WallStyleData.LoadSynchronous();
-	if (!WallData) return;
-	
-	int32 Middle1Spawned = 0;
-	int32 Middle2Spawned = 0;
-	int32 MiddleSkipped = 0;
-	
-	UE_LOG(LogTemp, Warning, TEXT("========================================"));
-	UE_LOG(LogTemp, Warning, TEXT("SPAWNING MIDDLE WALLS (2-Layer System)"));
-	UE_LOG(LogTemp, Warning, TEXT("Base wall segments to process: %d"), PlacedBaseWalls.Num());
-	
-	for (const FWallSegmentInfo& Segment : PlacedBaseWalls)
-	{
-		// Check if this module exists
-		if (!Segment.WallModule)
-		{
-			MiddleSkipped++;
-			continue;
-		}
-		
-		// --- MIDDLE 1 LAYER ---
-		// Try to load Middle1 mesh
-		UStaticMesh* Middle1Mesh = Segment.WallModule->Middle1Mesh.LoadSynchronous();
-		
-		if (Middle1Mesh)
-		{
-			// Get socket from Base mesh
-			FVector SocketLocation;
-			FRotator SocketRotation;
-			bool bHasSocket = GetSocketTransform(Segment.BaseMesh, FName("TopBackCenter"), SocketLocation, SocketRotation);
-			
-			if (!bHasSocket)
-			{
-				// Fallback: Base wall height is 100cm
-				SocketLocation = FVector(0, 0, 100.0f);
-				SocketRotation = FRotator::ZeroRotator;
-			}
-			
-			// Calculate world transform for Middle1
-			FTransform SocketTransform(SocketRotation, SocketLocation);
-			FTransform Middle1WorldTransform = SocketTransform * Segment.BaseTransform;
-			
-			// Spawn Middle1
-			UHierarchicalInstancedStaticMeshComponent* HISM1 = GetOrCreateHISM(Middle1Mesh);
-			if (HISM1)
-			{
-				HISM1->AddInstance(Middle1WorldTransform);
-				Middle1Spawned++;
-				
-				// --- MIDDLE 2 LAYER (only if Middle1 exists) ---
-				UStaticMesh* Middle2Mesh = Segment.WallModule->Middle2Mesh.LoadSynchronous();
-				
-				if (Middle2Mesh)
-				{
-					// Get socket from Middle1 mesh
-					FVector Middle2SocketLocation;
-					FRotator Middle2SocketRotation;
-					bool bHasMiddle1Socket = GetSocketTransform(Middle1Mesh, FName("TopBackCenter"), 
-					                                            Middle2SocketLocation, Middle2SocketRotation);
-					
-					if (!bHasMiddle1Socket)
-					{
-						// Fallback: Assume Middle1 is 100cm or 200cm tall
-						// Check bounds to determine
-						FBoxSphereBounds Bounds = Middle1Mesh->GetBounds();
-						float Middle1Height = (Bounds.BoxExtent.Z * 2.0f);
-						Middle2SocketLocation = FVector(0, 0, Middle1Height);
-						Middle2SocketRotation = FRotator::ZeroRotator;
-						
-						UE_LOG(LogTemp, Verbose, TEXT("  Middle1 mesh missing TopBackCenter, using bounds: Z=%.1f"), Middle1Height);
-					}
-					
-					// Chain transforms: Base → Middle1 → Middle2
-					FTransform Middle1SocketTransform(Middle2SocketRotation, Middle2SocketLocation);
-					FTransform Middle2WorldTransform = Middle1SocketTransform * Middle1WorldTransform;
-					
-					// Spawn Middle2
-					UHierarchicalInstancedStaticMeshComponent* HISM2 = GetOrCreateHISM(Middle2Mesh);
-					if (HISM2)
-					{
-						HISM2->AddInstance(Middle2WorldTransform);
-						Middle2Spawned++;
-					}
-				}
-			}
-		}
-		else
+// --- Middle & Top Wall Spawning Implementation ---
+
+void AMasterRoom::SpawnMiddleWalls()
+{
+	int32 Middle1Spawned = 0;
+	int32 Middle2Spawned = 0;
+	int32 MiddleSkipped = 0;
+	
+	UE_LOG(LogTemp, Warning, TEXT("========================================"));
+	UE_LOG(LogTemp, Warning, TEXT("SPAWNING MIDDLE WALLS (2-Layer System)"));
+	UE_LOG(LogTemp, Warning, TEXT("Base wall segments to process: %d"), PlacedBaseWalls.Num());
+	
+	// Socket chains are resolved per module at compile time - each layer is one transform multiply
+	const TArray<int32>& ModuleIndices = PlacedBaseWalls.ModuleIndices;
+	const TArray<FTransform>& BaseTransforms = PlacedBaseWalls.BaseTransforms;
+	for (int32 i = 0; i < PlacedBaseWalls.Num(); ++i)
+	{
+		const FCompiledWallModule& Module = CompiledWallStyle.Modules[ModuleIndices[i]];
+		
+		// No Middle1 mesh, skip entirely (Middle2 requires Middle1)
+		if (!Module.Middle1Mesh)
 		{
-			// No Middle1 mesh, skip entirely (Middle2 requires Middle1)
 			MiddleSkipped++;
+			continue;
+		}
+		
+		QueueInstance(Module.Middle1Mesh, Module.Middle1Relative * BaseTransforms[i], Module.CustomData);
+		Middle1Spawned++;
+		
+		if (Module.Middle2Mesh)
+		{
+			QueueInstance(Module.Middle2Mesh, Module.Middle2Relative * BaseTransforms[i], Module.CustomData);
+			Middle2Spawned++;
 		}
 	}
 	
@@ -1869,11 +3170,6 @@ void AMasterRoom::SpawnMiddleWalls()
 
 void AMasterRoom::SpawnTopWalls()
 {
-	if (!RoomData) return;
-	
-	UWallData* WallData = RoomData->WallStyleData.LoadSynchronous();
-	if (!WallData) return;
-	
 	int32 TopSpawned = 0;
 	int32 TopSkipped = 0;
 	
@@ -1881,284 +3177,452 @@ void AMasterRoom::SpawnTopWalls()
 	UE_LOG(LogTemp, Warning, TEXT("SPAWNING TOP WALLS"));
 	UE_LOG(LogTemp, Warning, TEXT("Base wall segments to process: %d"), PlacedBaseWalls.Num());
 	
-	for (const FWallSegmentInfo& Segment : PlacedBaseWalls)
+	// Top sits on the highest layer of its module (Middle2 > Middle1 > Base), resolved at compile time
+	const TArray<int32>& ModuleIndices = PlacedBaseWalls.ModuleIndices;
+	const TArray<FTransform>& BaseTransforms = PlacedBaseWalls.BaseTransforms;
+	for (int32 i = 0; i < PlacedBaseWalls.Num(); ++i)
 	{
-		// Check if this module exists
-		if (!Segment.WallModule)
+		const FCompiledWallModule& Module = CompiledWallStyle.Modules[ModuleIndices[i]];
+		if (!Module.TopMesh)
 		{
 			TopSkipped++;
 			continue;
 		}
 		
-		// Load middle meshes (may or may not exist)
-		UStaticMesh* Middle1Mesh = Segment.WallModule->Middle1Mesh.LoadSynchronous();
-		UStaticMesh* Middle2Mesh = Segment.WallModule->Middle2Mesh.LoadSynchronous();
+		QueueInstance(Module.TopMesh, Module.TopRelative * BaseTransforms[i], Module.CustomData);
+		TopSpawned++;
+	}
+	
+	UE_LOG(LogTemp, Warning, TEXT("Top walls spawned: %d"), TopSpawned);
+	UE_LOG(LogTemp, Warning, TEXT("Top walls skipped (no mesh): %d"), TopSkipped);
+	UE_LOG(LogTemp, Warning, TEXT("========================================"));
+}
+
+void AMasterRoom::SpawnCorners()
+{
+	UE_LOG(LogTemp, Warning, TEXT("========================================"));
+	UE_LOG(LogTemp, Warning, TEXT("SpawnCorners() CALLED"));
+	
+	if (!RoomData)
+	{
+		UE_LOG(LogTemp, Error, TEXT("SpawnCorners FAILED: RoomData is NULL!"));
+		return;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("RoomData valid: %s"), *RoomData->GetName());
+	
+	// Corner mesh and offsets come from the compiled WallData (loaded with the rest of the tables)
+	const FCompiledRoomData& Compiled = RoomData->GetCompiledData();
+	UStaticMesh* CornerMesh = RoomData->GetCompiledMesh(Compiled.CornerMeshIndex);
+	if (!CornerMesh)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SpawnCorners: No DefaultCornerMesh compiled (not assigned or failed to load) - skipping corners"));
+		return;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("Corner Mesh loaded: %s"), *CornerMesh->GetName());
+	
+	const FIntPoint GridSize = RoomData->GridSize;
+	
+	UE_LOG(LogTemp, Warning, TEXT("Grid Size: %d x %d"), GridSize.X, GridSize.Y);
+	
+	// Every convex and concave corner of the floor boundary (the 4 room corners for a plain
+	// rectangle, plus the inner/outer corners of carved L/T/U shapes)
+	FRoomBoundary Boundary;
+	TraceFloorBoundary(Boundary);
+	
+	UE_LOG(LogTemp, Verbose, TEXT("Corner positions traced: %d corners"), Boundary.Corners.Num());
+	UE_LOG(LogTemp, Verbose, TEXT("Per-corner offsets:"));
+	UE_LOG(LogTemp, Verbose, TEXT("  SouthWest: %s"), *Compiled.CornerOffsets[0].ToString());
+	UE_LOG(LogTemp, Verbose, TEXT("  SouthEast: %s"), *Compiled.CornerOffsets[1].ToString());
+	UE_LOG(LogTemp, Verbose, TEXT("  NorthEast: %s"), *Compiled.CornerOffsets[2].ToString());
+	UE_LOG(LogTemp, Verbose, TEXT("  NorthWest: %s"), *Compiled.CornerOffsets[3].ToString());
+	
+	int32 CornersSpawned = 0;
+	
+	// Offsets by the void quadrant the corner piece sits in (SW, SE, NE, NW - ERoomCornerQuadrant order)
+	const FVector (&CornerOffsets)[4] = Compiled.CornerOffsets;
+	
+	for (const FRoomBoundaryCorner& Corner : Boundary.Corners)
+	{
+		// Room-local grid vertex (the HISM applies the actor transform)
+		const FVector Position(Corner.Vertex.X * CELL_SIZE, Corner.Vertex.Y * CELL_SIZE, 0.0f);
+		const FVector& Offset = CornerOffsets[(uint8)Corner.Quadrant];
+		
+		// Apply per-corner offset from WallData
+		FVector FinalPosition = Position + Offset;
+		
+		FTransform CornerTransform(FRotator::ZeroRotator, FinalPosition, FVector(1.0f));
 		
-		// Load top mesh (required)
-		UStaticMesh* TopMesh = Segment.WallModule->TopMesh.LoadSynchronous();
+		UE_LOG(LogTemp, Verbose, TEXT("  Adding %s corner at vertex %s (quadrant %d): %s"),
+			Corner.bInner ? TEXT("inner") : TEXT("outer"), *Corner.Vertex.ToString(), (int32)Corner.Quadrant, *FinalPosition.ToString());
 		
-		if (!TopMesh)
+		QueueInstance(CornerMesh, CornerTransform);
+		CornersSpawned++;
+	}
+	
+	UE_LOG(LogTemp, Warning, TEXT("Corners spawned: %d"), CornersSpawned);
+	UE_LOG(LogTemp, Warning, TEXT("========================================"));
+}
+
+// ==================================================================================
+// INTERIOR FURNITURE PACKING
+// ==================================================================================
+
+void AMasterRoom::GenerateInteriorFurniture()
+{
+	if (!RoomData || !SolverData) return;
+	
+	const FCompiledRoomData& Compiled = *SolverData;
+	if (Compiled.Interior.Entries.Num() == 0 || Compiled.InteriorFillRatio <= 0.0f || Compiled.InteriorMaxAttempts <= 0) return;
+	
+	const FIntPoint GridSize = RoomData->GridSize;
+	const int32 NumCells = GridSize.X * GridSize.Y;
+	if (NumCells <= 0 || InternalGridState.Num() != NumCells) return;
+	
+	// Own sequence: furniture settings never reshuffle the floor, walls, doors or clutter
+	FRandomStream RandomStream(GenerationSeed + 3000);
+	
+	// --- Blocked Cells ---
+	// Furniture only sits on floor tiles, clear of the door approaches
+	TBitArray<> Blocked(false, NumCells);
+	MarkDoorApproachCells(Blocked, Compiled.InteriorDoorClearance);
+	for (int32 Index = 0; Index < NumCells; ++Index)
+	{
+		if (InternalGridState[Index] != EGridCellType::ECT_FloorMesh)
 		{
-			TopSkipped++;
-			UE_LOG(LogTemp, Verbose, TEXT("  Segment: No top mesh assigned"));
-			continue;
+			Blocked[Index] = true;
 		}
+	}
+	
+	// --- Door-to-Door Path ---
+	// The furniture can never cut a door off from the rest
+	TBitArray<> DoorCells(false, NumCells);
+	MarkDoorApproachCells(DoorCells, 1);
+	
+	TBitArray<> Reserved;
+	TArray<int32> Unreached;
+	ReserveDoorPaths(GridSize, InternalGridState, DoorCells, Reserved, Unreached);
+	Blocked.CombineWithBitwiseOR(Reserved, EBitwiseOperatorFlags::MaintainSize);
+	
+	for (const int32 Index : Unreached)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: Door approach cell (%d, %d) is not connected to the other doors over the floor"),
+			*GetName(), Index % GridSize.X, Index / GridSize.X);
+	}
+	
+	// --- Free Rectangles ---
+	FFreeRectIndex FreeSpace;
+	FreeSpace.Init(GridSize);
+	FreeSpace.BlockMask(GridSize, Blocked);
+	
+	const int32 FreeCells = NumCells - Blocked.CountSetBits();
+	const int32 TargetCells = FMath::FloorToInt(FreeCells * Compiled.InteriorFillRatio);
+	
+	// --- Packing ---
+	// Every attempt is one pool pick plus one scan of the free rectangles - InteriorMaxAttempts bounds the pass
+	TArray<int32> Fitting;
+	int32 CoveredCells = 0;
+	int32 NumPlaced = 0;
+	int32 Attempt = 0;
+	for (; Attempt < Compiled.InteriorMaxAttempts && CoveredCells < TargetCells && FreeSpace.Num() > 0; ++Attempt)
+	{
+		const FCompiledMeshEntry* Entry = Compiled.Interior.Select(RandomStream);
+		UStaticMesh* Mesh = Entry ? RoomData->GetCompiledMesh(Entry->MeshIndex) : nullptr;
+		if (!Mesh) continue;
+		
+		const uint8 Quadrant = Entry->Quadrants[RandomStream.RandRange(0, Entry->NumQuadrants - 1)];
+		const FIntPoint RotatedFootprint = Entry->GetRotatedFootprint(Quadrant);
+		
+		FreeSpace.FindFitting(RotatedFootprint, Fitting);
+		if (Fitting.Num() == 0) continue;
+		
+		// Random rectangle, random offset inside it - every cell of the footprint is free by construction
+		const FIntRect& Rect = FreeSpace.FreeRects[Fitting[RandomStream.RandRange(0, Fitting.Num() - 1)]];
+		const FIntPoint StartCoord(
+			RandomStream.RandRange(Rect.Min.X, Rect.Max.X - RotatedFootprint.X),
+			RandomStream.RandRange(Rect.Min.Y, Rect.Max.Y - RotatedFootprint.Y));
 		
-		// Find the highest point to stack Top from (priority: Middle2 > Middle1 > Base)
-		FVector SocketLocation;
-		FRotator SocketRotation;
-		FTransform StackBaseTransform = Segment.BaseTransform;
-		UStaticMesh* StackFromMesh = nullptr;
+		FreeSpace.Block(FIntRect(StartCoord, StartCoord + RotatedFootprint));
+		CurrentLayout.AddPlacement(Mesh, StartCoord, RotatedFootprint, Quadrant * 90.0f, ERoomLayoutLayer::Interior, Entry->CustomData);
 		
-		// Determine which layer Top should stack on
-		if (Middle2Mesh && Middle1Mesh)
+		for (int32 FootY = 0; FootY < RotatedFootprint.Y; ++FootY)
 		{
-			// Stack on Middle2: Base → Middle1 → Middle2 → Top
-			// Calculate Middle1 position
-			FVector BaseToMiddle1Socket;
-			FRotator BaseToMiddle1Rot;
-			bool bHasBaseSocket = GetSocketTransform(Segment.BaseMesh, FName("TopBackCenter"), 
-			                                         BaseToMiddle1Socket, BaseToMiddle1Rot);
-			if (!bHasBaseSocket)
-			{
-				BaseToMiddle1Socket = FVector(0, 0, 100.0f);
-				BaseToMiddle1Rot = FRotator::ZeroRotator;
-			}
-			
-			FTransform BaseToMiddle1(BaseToMiddle1Rot, BaseToMiddle1Socket);
-			FTransform Middle1WorldTransform = BaseToMiddle1 * Segment.BaseTransform;
-			
-			// Calculate Middle2 position
-			FVector Middle1ToMiddle2Socket;
-			FRotator Middle1ToMiddle2Rot;
-			bool bHasMiddle1Socket = GetSocketTransform(Middle1Mesh, FName("TopBackCenter"), 
-			                                            Middle1ToMiddle2Socket, Middle1ToMiddle2Rot);
-			if (!bHasMiddle1Socket)
+			for (int32 FootX = 0; FootX < RotatedFootprint.X; ++FootX)
 			{
-				FBoxSphereBounds Bounds = Middle1Mesh->GetBounds();
-				Middle1ToMiddle2Socket = FVector(0, 0, Bounds.BoxExtent.Z * 2.0f);
-				Middle1ToMiddle2Rot = FRotator::ZeroRotator;
+				// Interior meshes block movement - pathfinding and clutter only use ECT_FloorMesh cells
+				InternalGridState[(StartCoord.Y + FootY) * GridSize.X + (StartCoord.X + FootX)] = EGridCellType::ECT_Interior;
 			}
-			
-			FTransform Middle1ToMiddle2(Middle1ToMiddle2Rot, Middle1ToMiddle2Socket);
-			FTransform Middle2WorldTransform = Middle1ToMiddle2 * Middle1WorldTransform;
-			
-			// Get Middle2's top socket for Top placement
-			bool bHasMiddle2Socket = GetSocketTransform(Middle2Mesh, FName("TopBackCenter"), 
-			                                            SocketLocation, SocketRotation);
-			if (!bHasMiddle2Socket)
-			{
-				FBoxSphereBounds Bounds = Middle2Mesh->GetBounds();
-				SocketLocation = FVector(0, 0, Bounds.BoxExtent.Z * 2.0f);
-				SocketRotation = FRotator::ZeroRotator;
-			}
-			
-			StackBaseTransform = Middle2WorldTransform;
 		}
-		else if (Middle1Mesh)
+		
+		CoveredCells += RotatedFootprint.X * RotatedFootprint.Y;
+		++NumPlaced;
+	}
+	
+	UE_LOG(LogTemp, Log, TEXT("%s: Interior packed %d pieces over %d of %d free cells (target %d, %d attempts)"),
+		*GetName(), NumPlaced, CoveredCells, FreeCells, TargetCells, Attempt);
+}
+
+void AMasterRoom::ReserveDoorPaths(FIntPoint GridSize, TConstArrayView<EGridCellType> CellStates, const TBitArray<>& ApproachCells,
+	TBitArray<>& OutReserved, TArray<int32>& OutUnreached)
+{
+	const int32 NumCells = GridSize.X * GridSize.Y;
+	OutReserved.Init(false, FMath::Max(NumCells, 0));
+	OutUnreached.Reset();
+	if (NumCells <= 0 || CellStates.Num() != NumCells || ApproachCells.Num() != NumCells) return;
+	
+	// Root at the first approach cell that is floor - a blocked first door must not disable the path for the rest
+	int32 Root = INDEX_NONE;
+	for (TConstSetBitIterator<> It(ApproachCells); It; ++It)
+	{
+		if (CellStates[It.GetIndex()] == EGridCellType::ECT_FloorMesh)
 		{
-			// Stack on Middle1: Base → Middle1 → Top
-			FVector BaseToMiddle1Socket;
-			FRotator BaseToMiddle1Rot;
-			bool bHasBaseSocket = GetSocketTransform(Segment.BaseMesh, FName("TopBackCenter"), 
-			                                         BaseToMiddle1Socket, BaseToMiddle1Rot);
-			if (!bHasBaseSocket)
-			{
-				BaseToMiddle1Socket = FVector(0, 0, 100.0f);
-				BaseToMiddle1Rot = FRotator::ZeroRotator;
-			}
+			Root = It.GetIndex();
+			break;
+		}
+	}
+	
+	// One BFS over the floor from the root; the parent chain back from every other approach cell is reserved
+	TArray<int32> Parent;
+	Parent.Init(INDEX_NONE, NumCells);
+	if (Root != INDEX_NONE)
+	{
+		Parent[Root] = Root;
+		
+		TArray<int32> Queue;
+		Queue.Reserve(NumCells);
+		Queue.Add(Root);
+		for (int32 Head = 0; Head < Queue.Num(); ++Head)
+		{
+			const int32 Index = Queue[Head];
+			const int32 X = Index % GridSize.X;
+			const int32 Y = Index / GridSize.X;
 			
-			// Get Middle1's top socket for Top placement
-			bool bHasMiddle1Socket = GetSocketTransform(Middle1Mesh, FName("TopBackCenter"), 
-			                                            SocketLocation, SocketRotation);
-			if (!bHasMiddle1Socket)
-			{
-				FBoxSphereBounds Bounds = Middle1Mesh->GetBounds();
-				SocketLocation = FVector(0, 0, Bounds.BoxExtent.Z * 2.0f);
-				SocketRotation = FRotator::ZeroRotator;
-			}
+			const int32 Neighbours[4] = {
+				X + 1 < GridSize.X ? Index + 1 : INDEX_NONE,
+				X > 0 ? Index - 1 : INDEX_NONE,
+				Y + 1 < GridSize.Y ? Index + GridSize.X : INDEX_NONE,
+				Y > 0 ? Index - GridSize.X : INDEX_NONE };
 			
-			FTransform BaseToMiddle1(BaseToMiddle1Rot, BaseToMiddle1Socket);
-			StackBaseTransform = BaseToMiddle1 * Segment.BaseTransform;
-		}
-		else
-		{
-			// Stack directly on Base: Base → Top
-			bool bHasBaseSocket = GetSocketTransform(Segment.BaseMesh, FName("TopBackCenter"), 
-			                                         SocketLocation, SocketRotation);
-			if (!bHasBaseSocket)
+			for (const int32 Next : Neighbours)
 			{
-				SocketLocation = FVector(0, 0, 100.0f);
-				SocketRotation = FRotator::ZeroRotator;
+				if (Next != INDEX_NONE && Parent[Next] == INDEX_NONE && CellStates[Next] == EGridCellType::ECT_FloorMesh)
+				{
+					Parent[Next] = Index;
+					Queue.Add(Next);
+				}
 			}
-			
-			StackBaseTransform = Segment.BaseTransform;
 		}
 		
-		// Calculate final world transform for Top
-		FTransform SocketTransform(SocketRotation, SocketLocation);
-		FTransform TopWorldTransform = SocketTransform * StackBaseTransform;
+		OutReserved[Root] = true;
+	}
+	
+	// Chains stop at the first reserved cell, so overlapping paths are walked once
+	for (TConstSetBitIterator<> It(ApproachCells); It; ++It)
+	{
+		if (Parent[It.GetIndex()] == INDEX_NONE)
+		{
+			OutUnreached.Add(It.GetIndex());
+			continue;
+		}
 		
-		// Spawn top mesh
-		UHierarchicalInstancedStaticMeshComponent* HISM = GetOrCreateHISM(TopMesh);
-		if (HISM)
+		for (int32 Index = It.GetIndex(); !OutReserved[Index]; Index = Parent[Index])
 		{
-			HISM->AddInstance(TopWorldTransform);
-			TopSpawned++;
+			OutReserved[Index] = true;
 		}
 	}
-	
-	UE_LOG(LogTemp, Warning, TEXT("Top walls spawned: %d"), TopSpawned);
-	UE_LOG(LogTemp, Warning, TEXT("Top walls skipped (no mesh): %d"), TopSkipped);
-	UE_LOG(LogTemp, Warning, TEXT("========================================"));
 }
 
-bool AMasterRoom::GetSocketTransform(UStaticMesh* Mesh, FName SocketName, FVector& OutLocation, FRotator& OutRotation) const
+// ==================================================================================
+// FLOOR CLUTTER (BLUE NOISE)
+// ==================================================================================
+
+void AMasterRoom::GenerateClutter()
 {
-	if (!Mesh) return false;
+	if (!RoomData || !SolverData) return;
 	
-	// Find socket in mesh
-	UStaticMeshSocket* Socket = Mesh->FindSocket(SocketName);
-	if (Socket)
-	{
-		OutLocation = Socket->RelativeLocation;
-		OutRotation = Socket->RelativeRotation;
-		return true;
-	}
+	const FCompiledRoomData& Compiled = *SolverData;
+	if (Compiled.Clutter.Entries.Num() == 0 || Compiled.ClutterPlacementChance <= 0.0f) return;
 	
-	return false;
-}
-
-void AMasterRoom::SpawnCorners()
-{
-	UE_LOG(LogTemp, Warning, TEXT("========================================"));
-	UE_LOG(LogTemp, Warning, TEXT("SpawnCorners() CALLED"));
+	const FIntPoint GridSize = RoomData->GridSize;
+	const int32 NumCells = GridSize.X * GridSize.Y;
+	if (NumCells <= 0 || InternalGridState.Num() != NumCells) return;
 	
-	if (!RoomData)
+	// Own sequence: clutter settings never reshuffle the floor, walls or doors
+	FRandomStream RandomStream(GenerationSeed + 2000);
+	
+	// --- Free Floor ---
+	// Clutter only sits on floor tiles (not interior meshes, carved cells or the cell in front of a door)
+	TBitArray<> Free(false, NumCells);
+	TBitArray<> DoorApproach(false, NumCells);
+	MarkDoorApproachCells(DoorApproach, 1);
+	
+	for (int32 Index = 0; Index < NumCells; ++Index)
 	{
-		UE_LOG(LogTemp, Error, TEXT("SpawnCorners FAILED: RoomData is NULL!"));
-		return;
+		Free[Index] = InternalGridState[Index] == EGridCellType::ECT_FloorMesh && !DoorApproach[Index];
 	}
-	UE_LOG(LogTemp, Warning, TEXT("RoomData valid: %s"), *RoomData->GetName());
+	const int32 NumFree = Free.CountSetBits();
+	
+	TArray<FClutterPlacement> Placements;
+	ScatterClutter(Compiled, GridSize, Free, [this](int32 MeshIndex) { return RoomData->GetCompiledMesh(MeshIndex); },
+		RandomStream, Placements);
 	
-	UWallData* WallData = RoomData->WallStyleData.LoadSynchronous();
-	if (!WallData)
+	for (const FClutterPlacement& Placement : Placements)
 	{
-		UE_LOG(LogTemp, Error, TEXT("SpawnCorners FAILED: WallData is NULL!"));
-		return;
+		CurrentLayout.AddPlacement(Placement.Mesh, Placement.Cell, Placement.Footprint, Placement.Quadrant * 90.0f,
+			ERoomLayoutLayer::Clutter, Placement.Entry->CustomData);
 	}
-	UE_LOG(LogTemp, Warning, TEXT("WallData valid: %s"), *WallData->GetName());
 	
-	// Attempt to load DefaultCornerMesh
-	// Note: TSoftObjectPtr::IsValid() can return false even when mesh is assigned
-	// So we skip the IsValid() check and directly attempt LoadSynchronous()
-	UE_LOG(LogTemp, Warning, TEXT("Attempting to load DefaultCornerMesh..."));
+	UE_LOG(LogTemp, Log, TEXT("%s: Clutter placed %d of %d free floor cells (spacing %.0f cm)"),
+		*GetName(), Placements.Num(), NumFree, Compiled.ClutterMinSpacing);
+}
+
+void AMasterRoom::ScatterClutter(const FCompiledRoomData& Compiled, FIntPoint GridSize, TBitArray<>& Free,
+	TFunctionRef<UStaticMesh*(int32 MeshIndex)> GetMesh, FRandomStream& RandomStream, TArray<FClutterPlacement>& OutPlacements)
+{
+	const int32 NumCells = GridSize.X * GridSize.Y;
+	if (NumCells <= 0 || Free.Num() != NumCells) return;
 	
-	UStaticMesh* CornerMesh = WallData->DefaultCornerMesh.LoadSynchronous();
-	if (!CornerMesh)
+	TArray<int32> Candidates;
+	Candidates.Reserve(NumCells);
+	for (TConstSetBitIterator<> It(Free); It; ++It)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("SpawnCorners: No DefaultCornerMesh assigned (LoadSynchronous returned NULL) - skipping corners"));
-		return;
+		Candidates.Add(It.GetIndex());
 	}
-	UE_LOG(LogTemp, Warning, TEXT("Corner Mesh loaded: %s"), *CornerMesh->GetName());
 	
-	const FIntPoint GridSize = RoomData->GridSize;
-	const FVector ActorLocation = GetActorLocation();
+	// Visit the free cells in random order (Fisher-Yates), so acceptance does not sweep across the room
+	for (int32 i = Candidates.Num() - 1; i > 0; --i)
+	{
+		Candidates.Swap(i, RandomStream.RandRange(0, i));
+	}
 	
-	UE_LOG(LogTemp, Warning, TEXT("Grid Size: %d x %d"), GridSize.X, GridSize.Y);
-	UE_LOG(LogTemp, Warning, TEXT("Actor Location: %s"), *ActorLocation.ToString());
+	// --- Background Grid (Poisson disk) ---
+	// Buckets are Spacing / sqrt(2) wide, so each holds at most one accepted centre and a candidate only
+	// checks the 5x5 buckets around it - constant work per cell, linear over the room.
+	// Non-overlapping footprints already keep centres a cell apart, so smaller spacings need no grid.
+	const float Spacing = Compiled.ClutterMinSpacing;
+	const bool bUseSpacing = Spacing > CELL_SIZE;
+	const float BucketSize = bUseSpacing ? Spacing / UE_SQRT_2 : CELL_SIZE;
+	const FIntPoint NumBuckets(
+		FMath::CeilToInt(GridSize.X * CELL_SIZE / BucketSize),
+		FMath::CeilToInt(GridSize.Y * CELL_SIZE / BucketSize));
 	
-	// Get HISM for corners
-	UHierarchicalInstancedStaticMeshComponent* HISM = GetOrCreateHISM(CornerMesh);
-	if (!HISM)
+	TArray<FVector2f> Samples;
+	TArray<int32> Buckets;
+	if (bUseSpacing)
 	{
-		UE_LOG(LogTemp, Error, TEXT("SpawnCorners FAILED: GetOrCreateHISM returned NULL!"));
-		return;
+		Buckets.Init(INDEX_NONE, NumBuckets.X * NumBuckets.Y);
 	}
-	UE_LOG(LogTemp, Warning, TEXT("HISM component created/retrieved: %s"), *HISM->GetName());
-	UE_LOG(LogTemp, Warning, TEXT("HISM instances BEFORE adding corners: %d"), HISM->GetInstanceCount());
 	
-	// Define the 4 corners with positions and rotations
-	struct FCornerInfo
+	auto GetBucket = [&](const FVector2f& Centre)
 	{
-		FVector Position;
-		FRotator Rotation;
-		FString Name;
+		return FIntPoint(
+			FMath::Clamp(FMath::FloorToInt(Centre.X / BucketSize), 0, NumBuckets.X - 1),
+			FMath::Clamp(FMath::FloorToInt(Centre.Y / BucketSize), 0, NumBuckets.Y - 1));
 	};
 	
-	TArray<FCornerInfo> Corners;
-	
-	// SouthWest Corner (0, 0) - Bottom-left, starting point (clockwise)
-	Corners.Add({
-		ActorLocation + FVector(0.0f, 0.0f, 0.0f),
-		FRotator(0.0f, 0.0f, 0.0f),
-		TEXT("SouthWest")
-	});
-	
-	// SouthEast Corner (0, GridSize.Y) - Bottom-right (Y+ is East)
-	Corners.Add({
-		ActorLocation + FVector(0.0f, GridSize.Y * CELL_SIZE, 0.0f),
-		FRotator(0.0f, 0.0f, 0.0f),
-		TEXT("SouthEast")
-	});
-	
-	// NorthEast Corner (GridSize.X, GridSize.Y) - Top-right (X+ is North, Y+ is East)
-	Corners.Add({
-		ActorLocation + FVector(GridSize.X * CELL_SIZE, GridSize.Y * CELL_SIZE, 0.0f),
-		FRotator(0.0f, 0.0f, 0.0f),
-		TEXT("NorthEast")
-	});
-	
-	// NorthWest Corner (GridSize.X, 0) - Top-left (X+ is North)
-	Corners.Add({
-		ActorLocation + FVector(GridSize.X * CELL_SIZE, 0.0f, 0.0f),
-		FRotator(0.0f, 0.0f, 0.0f),
-		TEXT("NorthWest")
-	});
-	
-	UE_LOG(LogTemp, Warning, TEXT("Corner positions calculated: %d corners"), Corners.Num());
-	UE_LOG(LogTemp, Warning, TEXT("Per-corner offsets:"));
-	UE_LOG(LogTemp, Warning, TEXT("  SouthWest: %s"), *WallData->SouthWestCornerOffset.ToString());
-	UE_LOG(LogTemp, Warning, TEXT("  SouthEast: %s"), *WallData->SouthEastCornerOffset.ToString());
-	UE_LOG(LogTemp, Warning, TEXT("  NorthEast: %s"), *WallData->NorthEastCornerOffset.ToString());
-	UE_LOG(LogTemp, Warning, TEXT("  NorthWest: %s"), *WallData->NorthWestCornerOffset.ToString());
-	
-	// Spawn all 4 corners with individual offsets
-	int32 CornersSpawned = 0;
-	
-	// Array of offsets matching corner order (SW, SE, NE, NW - clockwise from bottom-left)
-	TArray<FVector> CornerOffsets = {
-		WallData->SouthWestCornerOffset,
-		WallData->SouthEastCornerOffset,
-		WallData->NorthEastCornerOffset,
-		WallData->NorthWestCornerOffset
+	auto IsFarEnough = [&](const FVector2f& Centre)
+	{
+		const FIntPoint Bucket = GetBucket(Centre);
+		for (int32 BY = FMath::Max(Bucket.Y - 2, 0); BY <= FMath::Min(Bucket.Y + 2, NumBuckets.Y - 1); ++BY)
+		{
+			for (int32 BX = FMath::Max(Bucket.X - 2, 0); BX <= FMath::Min(Bucket.X + 2, NumBuckets.X - 1); ++BX)
+			{
+				const int32 Sample = Buckets[BY * NumBuckets.X + BX];
+				if (Sample != INDEX_NONE && FVector2f::DistSquared(Samples[Sample], Centre) < Spacing * Spacing)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
 	};
 	
-	for (int32 i = 0; i < Corners.Num(); i++)
+	// --- Dart Throwing ---
+	for (const int32 Index : Candidates)
 	{
-		const FCornerInfo& Corner = Corners[i];
-		const FVector& Offset = CornerOffsets[i];
+		// ClutterPlacementChance is the chance a free cell gets a clutter attempt at all
+		if (!Free[Index] || RandomStream.FRand() >= Compiled.ClutterPlacementChance) continue;
 		
-		// Apply per-corner offset from WallData
-		FVector FinalPosition = Corner.Position + Offset;
+		const FCompiledMeshEntry* Entry = Compiled.Clutter.Select(RandomStream);
+		UStaticMesh* Mesh = Entry ? GetMesh(Entry->MeshIndex) : nullptr;
+		if (!Mesh) continue;
 		
-		FTransform CornerTransform(Corner.Rotation, FinalPosition, FVector(1.0f));
+		const uint8 Quadrant = Entry->Quadrants[RandomStream.RandRange(0, Entry->NumQuadrants - 1)];
+		const FIntPoint RotatedFootprint = Entry->GetRotatedFootprint(Quadrant);
 		
-		UE_LOG(LogTemp, Warning, TEXT("  Adding %s corner..."), *Corner.Name);
-		UE_LOG(LogTemp, Warning, TEXT("    Base Position: %s"), *Corner.Position.ToString());
-		UE_LOG(LogTemp, Warning, TEXT("    Applied Offset: %s"), *Offset.ToString());
-		UE_LOG(LogTemp, Warning, TEXT("    Final Position: %s"), *FinalPosition.ToString());
-		UE_LOG(LogTemp, Warning, TEXT("    Rotation: %.1f°"), Corner.Rotation.Yaw);
+		// Footprint anchored at the candidate cell: in bounds and every cell still free
+		const int32 X = Index % GridSize.X;
+		const int32 Y = Index / GridSize.X;
+		if (X + RotatedFootprint.X > GridSize.X || Y + RotatedFootprint.Y > GridSize.Y) continue;
 		
-		int32 InstanceIndex = HISM->AddInstance(CornerTransform);
-		CornersSpawned++;
+		bool bFits = true;
+		for (int32 FootY = 0; FootY < RotatedFootprint.Y && bFits; ++FootY)
+		{
+			for (int32 FootX = 0; FootX < RotatedFootprint.X && bFits; ++FootX)
+			{
+				bFits = Free[(Y + FootY) * GridSize.X + (X + FootX)];
+			}
+		}
+		if (!bFits) continue;
+		
+		const FVector2f Centre((X + RotatedFootprint.X * 0.5f) * CELL_SIZE, (Y + RotatedFootprint.Y * 0.5f) * CELL_SIZE);
+		if (bUseSpacing && !IsFarEnough(Centre)) continue;
+		
+		// Accept: claim the footprint and register the centre
+		for (int32 FootY = 0; FootY < RotatedFootprint.Y; ++FootY)
+		{
+			for (int32 FootX = 0; FootX < RotatedFootprint.X; ++FootX)
+			{
+				Free[(Y + FootY) * GridSize.X + (X + FootX)] = false;
+			}
+		}
+		if (bUseSpacing)
+		{
+			const FIntPoint Bucket = GetBucket(Centre);
+			Buckets[Bucket.Y * NumBuckets.X + Bucket.X] = Samples.Add(Centre);
+		}
 		
-		UE_LOG(LogTemp, Warning, TEXT("    Instance added at index: %d"), InstanceIndex);
+		FClutterPlacement& Placement = OutPlacements.AddDefaulted_GetRef();
+		Placement.Entry = Entry;
+		Placement.Mesh = Mesh;
+		Placement.Cell = FIntPoint(X, Y);
+		Placement.Footprint = RotatedFootprint;
+		Placement.Quadrant = Quadrant;
 	}
+}
+
+void AMasterRoom::MarkDoorApproachCells(TBitArray<>& Mask, int32 Depth) const
+{
+	if (!RoomData) return;
 	
-	UE_LOG(LogTemp, Warning, TEXT("Corners spawned: %d"), CornersSpawned);
-	UE_LOG(LogTemp, Warning, TEXT("HISM instances AFTER adding corners: %d"), HISM->GetInstanceCount());
-	UE_LOG(LogTemp, Warning, TEXT("========================================"));
+	const FIntPoint GridSize = RoomData->GridSize;
+	if (Mask.Num() != GridSize.X * GridSize.Y) return;
+	
+	for (const FFixedDoorLocation& DoorLoc : FixedDoorLocations)
+	{
+		if (!DoorLoc.DoorData || IsDoorSealed(DoorLoc)) continue;
+		
+		const int32 DoorFootprint = FMath::Max(1, DoorLoc.DoorData->FrameFootprintY);
+		for (int32 Along = DoorLoc.StartCell; Along < DoorLoc.StartCell + DoorFootprint; ++Along)
+		{
+			for (int32 Step = 0; Step < Depth; ++Step)
+			{
+				// Walk from the door's interior cell into the room
+				FIntPoint Cell;
+				switch (DoorLoc.WallEdge)
+				{
+					case EWallEdge::North: Cell = FIntPoint(GridSize.X - 1 - Step, Along); break;
+					case EWallEdge::South: Cell = FIntPoint(Step, Along); break;
+					case EWallEdge::East:  Cell = FIntPoint(Along, GridSize.Y - 1 - Step); break;
+					default:               Cell = FIntPoint(Along, Step); break;
+				}
+				
+				if (Cell.X >= 0 && Cell.X < GridSize.X && Cell.Y >= 0 && Cell.Y < GridSize.Y)
+				{
+					Mask[Cell.Y * GridSize.X + Cell.X] = true;
+				}
+			}
+		}
+	}
 }
 
 // ==================================================================================
@@ -2169,16 +3633,15 @@ void AMasterRoom::GenerateCeiling()
 {
 	if (!RoomData) return;
 
-	UCeilingData* CeilingData = RoomData->CeilingStyleData.LoadSynchronous();
-	if (!CeilingData)
+	if (RoomData->CeilingStyleData.IsNull())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("No CeilingData assigned - skipping ceiling generation"));
 		return;
 	}
 
+	const FCompiledRoomData& Compiled = *SolverData;
 	const FIntPoint GridSize = RoomData->GridSize;
-	const FVector ActorLocation = GetActorLocation();
-	const float CeilingZ = CeilingData->CeilingHeight;
+	const float CeilingZ = Compiled.CeilingHeight;
 
 	UE_LOG(LogTemp, Warning, TEXT("========================================"));
 	UE_LOG(LogTemp, Warning, TEXT("GENERATING CEILING"));
@@ -2216,18 +3679,12 @@ void AMasterRoom::GenerateCeiling()
 	};
 
 	// PASS 1: Place large tiles (400x400 = 4x4 cells)
-	if (CeilingData->LargeTilePool.Num() > 0)
+	const FCompiledTilePool& LargeTiles = Compiled.LargeCeilingTiles;
+	if (LargeTiles.MeshIndices.Num() > 0)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("PASS 1: Placing large tiles (400x400)"));
 
-		// Calculate total weight for large tiles
-		float TotalWeight = 0.0f;
-		for (const FCeilingTile& Tile : CeilingData->LargeTilePool)
-		{
-			TotalWeight += Tile.PlacementWeight;
-		}
-
-		if (TotalWeight > 0.0f)
+		if (LargeTiles.Weights.GetTotal() > 0)
 		{
 			FRandomStream RandomStream(GenerationSeed);
 
@@ -2252,37 +3709,15 @@ void AMasterRoom::GenerateCeiling()
 					if (bCanPlace)
 					{
 						// Weighted random selection
-						float RandomValue = RandomStream.FRand() * TotalWeight;
-						float CurrentWeight = 0.0f;
-						UStaticMesh* SelectedMesh = nullptr;
-
-						for (const FCeilingTile& Tile : CeilingData->LargeTilePool)
-						{
-							CurrentWeight += Tile.PlacementWeight;
-							if (RandomValue <= CurrentWeight)
-							{
-								SelectedMesh = Tile.Mesh.LoadSynchronous();
-								break;
-							}
-						}
+						const int32 TileIndex = LargeTiles.Weights.Select(RandomStream);
+						UStaticMesh* SelectedMesh = RoomData->GetCompiledMesh(LargeTiles.MeshIndices[TileIndex]);
 
 						if (SelectedMesh)
 						{
-							// Calculate center position of 4x4 area
-							FVector TilePosition = ActorLocation + FVector(
-								(X + 2.0f) * CELL_SIZE,  // Center at X+2
-								(Y + 2.0f) * CELL_SIZE,  // Center at Y+2
-								CeilingZ
-							);
-
-							UHierarchicalInstancedStaticMeshComponent* HISM = GetOrCreateHISM(SelectedMesh);
-							if (HISM)
-							{
-								FTransform TileTransform(CeilingData->CeilingRotation, TilePosition, FVector(1.0f));
-								HISM->AddInstance(TileTransform);
-								MarkCellsOccupied(X, Y, 4);
-								LargeTilesPlaced++;
-							}
+							// Record the 4x4 tile - BuildFromLayout() centres it and lifts it to CeilingHeight
+							CurrentLayout.AddPlacement(SelectedMesh, FIntPoint(X, Y), FIntPoint(4, 4), 0.0f, ERoomLayoutLayer::Ceiling);
+							MarkCellsOccupied(X, Y, 4);
+							LargeTilesPlaced++;
 						}
 					}
 				}
@@ -2293,18 +3728,12 @@ void AMasterRoom::GenerateCeiling()
 	}
 
 	// PASS 2: Fill remaining cells with small tiles (100x100 = 1x1 cell)
-	if (CeilingData->SmallTilePool.Num() > 0)
+	const FCompiledTilePool& SmallTiles = Compiled.SmallCeilingTiles;
+	if (SmallTiles.MeshIndices.Num() > 0)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("PASS 2: Filling gaps with small tiles (100x100)"));
 
-		// Calculate total weight for small tiles
-		float TotalWeight = 0.0f;
-		for (const FCeilingTile& Tile : CeilingData->SmallTilePool)
-		{
-			TotalWeight += Tile.PlacementWeight;
-		}
-
-		if (TotalWeight > 0.0f)
+		if (SmallTiles.Weights.GetTotal() > 0)
 		{
 			FRandomStream RandomStream(GenerationSeed + 1000);  // Different seed for variety
 
@@ -2315,36 +3744,14 @@ void AMasterRoom::GenerateCeiling()
 					if (!IsCellOccupied(X, Y))
 					{
 						// Weighted random selection
-						float RandomValue = RandomStream.FRand() * TotalWeight;
-						float CurrentWeight = 0.0f;
-						UStaticMesh* SelectedMesh = nullptr;
-
-						for (const FCeilingTile& Tile : CeilingData->SmallTilePool)
-						{
-							CurrentWeight += Tile.PlacementWeight;
-							if (RandomValue <= CurrentWeight)
-							{
-								SelectedMesh = Tile.Mesh.LoadSynchronous();
-								break;
-							}
-						}
+						const int32 TileIndex = SmallTiles.Weights.Select(RandomStream);
+						UStaticMesh* SelectedMesh = RoomData->GetCompiledMesh(SmallTiles.MeshIndices[TileIndex]);
 
 						if (SelectedMesh)
 						{
-							FVector TilePosition = ActorLocation + FVector(
-								(X + 0.5f) * CELL_SIZE,  // Center of cell
-								(Y + 0.5f) * CELL_SIZE,  // Center of cell
-								CeilingZ
-							);
-
-							UHierarchicalInstancedStaticMeshComponent* HISM = GetOrCreateHISM(SelectedMesh);
-							if (HISM)
-							{
-								FTransform TileTransform(CeilingData->CeilingRotation, TilePosition, FVector(1.0f));
-								HISM->AddInstance(TileTransform);
-								MarkCellsOccupied(X, Y, 1);
-								SmallTilesPlaced++;
-							}
+							CurrentLayout.AddPlacement(SelectedMesh, FIntPoint(X, Y), FIntPoint(1, 1), 0.0f, ERoomLayoutLayer::Ceiling);
+							MarkCellsOccupied(X, Y, 1);
+							SmallTilesPlaced++;
 						}
 					}
 				}
@@ -2360,15 +3767,37 @@ void AMasterRoom::GenerateCeiling()
 	UE_LOG(LogTemp, Warning, TEXT("========================================"));
 }
 
-// Editor-only overrides for lifecycle management
-#if WITH_EDITOR
-void AMasterRoom::PostLoad()
+void AMasterRoom::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Hand doorways and shared instances back so a destroyed/unloaded room doesn't leak them into the world
+	ReleaseDoorways();
+	ReleaseSharedInstances();
+	
+	if (UDungeonPathfindingSubsystem* Pathfinding = GetWorld() ? GetWorld()->GetSubsystem<UDungeonPathfindingSubsystem>() : nullptr)
+	{
+		Pathfinding->RemoveRoom(this);
+	}
+	if (UDungeonVisibilitySubsystem* Visibility = GetWorld() ? GetWorld()->GetSubsystem<UDungeonVisibilitySubsystem>() : nullptr)
+	{
+		Visibility->RemoveRoom(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void AMasterRoom::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+	
+	// Overrides as saved in the map - the replicated blob only carries what changes after this
+	CaptureOverrideBaseline();
+}
+
+void AMasterRoom::PostRegisterAllComponents()
 {
-	Super::PostLoad();
-	// Draw the debug grid when the actor is loaded in the editor
+	Super::PostRegisterAllComponents();
+	// Show the debug grid once the actor is loaded/placed in the editor
 	if (GIsEditor)
 	{
 		DrawDebugGrid();
 	}
-}
-#endif
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Rooms/RoomBoundary.h"
+
+void FRoomBoundary::Trace(FIntPoint GridSize, const TBitArray<>& FloorMask)
+{
+	Reset();
+	if (GridSize.X <= 0 || GridSize.Y <= 0 || FloorMask.Num() != GridSize.X * GridSize.Y) return;
+
+	auto IsFloor = [&](int32 X, int32 Y)
+	{
+		return X >= 0 && Y >= 0 && X < GridSize.X && Y < GridSize.Y && FloorMask[Y * GridSize.X + X];
+	};
+
+	// --- Runs ---
+	// One row-major sweep. North/South runs advance along Y, so each column keeps its open run;
+	// East/West runs advance along X, so one open run per row is enough.
+	// Each edge collects into its own list so the result comes out grouped by edge without a sort.
+	TArray<FRoomBoundaryRun> EdgeRuns[4];
+	TArray<int32> OpenNorth;
+	TArray<int32> OpenSouth;
+	OpenNorth.Init(INDEX_NONE, GridSize.X);
+	OpenSouth.Init(INDEX_NONE, GridSize.X);
+
+	auto ExtendOrStart = [&EdgeRuns](int32& OpenRun, bool bHasEdge, EWallEdge Edge, int32 Line, int32 Along)
+	{
+		TArray<FRoomBoundaryRun>& List = EdgeRuns[(uint8)Edge];
+		if (!bHasEdge)
+		{
+			OpenRun = INDEX_NONE;
+			return;
+		}
+		if (OpenRun != INDEX_NONE)
+		{
+			++List[OpenRun].Length;
+			return;
+		}
+		OpenRun = List.Num();
+		List.Add({ Edge, Line, Along, 1 });
+	};
+
+	for (int32 Y = 0; Y < GridSize.Y; ++Y)
+	{
+		int32 OpenEast = INDEX_NONE;
+		int32 OpenWest = INDEX_NONE;
+
+		for (int32 X = 0; X < GridSize.X; ++X)
+		{
+			const bool bFloor = IsFloor(X, Y);
+			ExtendOrStart(OpenNorth[X], bFloor && !IsFloor(X + 1, Y), EWallEdge::North, X + 1, Y);
+			ExtendOrStart(OpenSouth[X], bFloor && !IsFloor(X - 1, Y), EWallEdge::South, X - 1, Y);
+			ExtendOrStart(OpenEast, bFloor && !IsFloor(X, Y + 1), EWallEdge::East, Y + 1, X);
+			ExtendOrStart(OpenWest, bFloor && !IsFloor(X, Y - 1), EWallEdge::West, Y - 1, X);
+		}
+	}
+
+	// Edge by edge in EWallEdge order, like the old four-edge pass
+	Runs.Reserve(EdgeRuns[0].Num() + EdgeRuns[1].Num() + EdgeRuns[2].Num() + EdgeRuns[3].Num());
+	for (const TArray<FRoomBoundaryRun>& List : EdgeRuns)
+	{
+		Runs.Append(List);
+	}
+
+	// --- Corners (marching squares) ---
+	// Case bits per vertex: SW = cell (X-1, Y-1), SE = (X-1, Y), NE = (X, Y), NW = (X, Y-1)
+	constexpr uint8 SW = 1 << (uint8)ERoomCornerQuadrant::SouthWest;
+	constexpr uint8 SE = 1 << (uint8)ERoomCornerQuadrant::SouthEast;
+	constexpr uint8 NE = 1 << (uint8)ERoomCornerQuadrant::NorthEast;
+	constexpr uint8 NW = 1 << (uint8)ERoomCornerQuadrant::NorthWest;
+
+	for (int32 Y = 0; Y <= GridSize.Y; ++Y)
+	{
+		for (int32 X = 0; X <= GridSize.X; ++X)
+		{
+			const uint8 Case = (IsFloor(X - 1, Y - 1) ? SW : 0) | (IsFloor(X - 1, Y) ? SE : 0)
+				| (IsFloor(X, Y) ? NE : 0) | (IsFloor(X, Y - 1) ? NW : 0);
+			const int32 NumFloor = FMath::CountBits(Case);
+			const FIntPoint Vertex(X, Y);
+
+			if (NumFloor == 1)
+			{
+				// Convex corner: the piece sits in the void quadrant diagonal to the floor cell
+				const uint8 FloorQuadrant = (uint8)FMath::CountTrailingZeros(Case);
+				Corners.Add({ Vertex, (ERoomCornerQuadrant)((FloorQuadrant + 2) & 0x3), false });
+			}
+			else if (NumFloor == 3)
+			{
+				// Concave corner: the piece sits in the single void quadrant
+				const uint8 VoidQuadrant = (uint8)FMath::CountTrailingZeros((uint8)(~Case & 0xF));
+				Corners.Add({ Vertex, (ERoomCornerQuadrant)VoidQuadrant, true });
+			}
+			else if (Case == (SW | NE) || Case == (SE | NW))
+			{
+				// Saddle: two floor cells touching diagonally - one convex corner per void quadrant
+				const uint8 Voids = ~Case & 0xF;
+				for (uint8 Quadrant = 0; Quadrant < 4; ++Quadrant)
+				{
+					if (Voids & (1 << Quadrant))
+					{
+						Corners.Add({ Vertex, (ERoomCornerQuadrant)Quadrant, false });
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,330 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Rooms/RoomLayout.h"
+#include "Engine/StaticMesh.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+void FRoomLayout::Reset(FIntPoint InGridSize, int32 InSeed)
+{
+	GridSize = InGridSize;
+	Seed = InSeed;
+	Meshes.Reset();
+	MeshCustomData.Reset();
+	Placements.Reset();
+	Walls.Reset();
+	Doors.Reset();
+	CellStates.Reset();
+	MeshLookup.Reset();
+}
+
+uint16 FRoomLayout::AddMesh(UStaticMesh* Mesh, TConstArrayView<float> CustomData)
+{
+	// A handful of variants per mesh at most - compare their custom data directly
+	for (auto It = MeshLookup.CreateConstKeyIterator(Mesh); It; ++It)
+	{
+		const TArray<float>& Existing = MeshCustomData[It.Value()];
+		if (Existing.Num() == CustomData.Num() && CompareItems(Existing.GetData(), CustomData.GetData(), CustomData.Num()))
+		{
+			return It.Value();
+		}
+	}
+	
+	check(Meshes.Num() < MAX_uint16);
+	const uint16 NewIndex = (uint16)Meshes.Add(FSoftObjectPath(Mesh));
+	MeshCustomData.Emplace(CustomData);
+	MeshLookup.Add(Mesh, NewIndex);
+	return NewIndex;
+}
+
+void FRoomLayout::AddPlacement(UStaticMesh* Mesh, FIntPoint Cell, FIntPoint RotatedFootprint, float Yaw, ERoomLayoutLayer Layer,
+	TConstArrayView<float> CustomData)
+{
+	const int32 Quadrant = ((FMath::RoundToInt(Yaw / 90.0f) % 4) + 4) % 4;
+	if (!FMath::IsNearlyEqual(Yaw, FMath::RoundToFloat(Yaw / 90.0f) * 90.0f))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RoomLayout: Rotation %.1f for %s is not a multiple of 90 - snapped to %d"),
+			Yaw, Mesh ? *Mesh->GetName() : TEXT("NULL"), Quadrant * 90);
+	}
+	
+	FRoomLayoutPlacement& Placement = Placements.AddDefaulted_GetRef();
+	Placement.MeshIndex = AddMesh(Mesh, CustomData);
+	Placement.CellX = (uint16)Cell.X;
+	Placement.CellY = (uint16)Cell.Y;
+	Placement.FootprintX = (uint8)FMath::Clamp(RotatedFootprint.X, 1, (int32)MAX_uint8);
+	Placement.FootprintY = (uint8)FMath::Clamp(RotatedFootprint.Y, 1, (int32)MAX_uint8);
+	Placement.Quadrant = (uint8)Quadrant;
+	Placement.Layer = Layer;
+}
+
+void FRoomLayout::AddWall(EWallEdge Edge, int32 Line, int32 StartCell, int32 ModuleIndex, bool bForced)
+{
+	FRoomLayoutWall& Wall = Walls.AddDefaulted_GetRef();
+	Wall.Edge = Edge;
+	Wall.bForced = bForced;
+	Wall.Line = (int16)Line;
+	Wall.StartCell = (uint16)StartCell;
+	Wall.ModuleIndex = (uint16)ModuleIndex;
+}
+
+void FRoomLayout::AddDoor(EWallEdge Edge, int32 StartCell, ERoomLayoutDoorSource Source, int32 Index)
+{
+	FRoomLayoutDoor& Door = Doors.AddDefaulted_GetRef();
+	Door.Edge = Edge;
+	Door.Source = Source;
+	Door.StartCell = (uint16)StartCell;
+	Door.Index = (uint16)Index;
+}
+
+namespace RoomLayoutSerialization
+{
+	// Encoded record sizes (lower bounds for the mesh table entries: empty path + custom data count)
+	static constexpr int64 MinMeshBytes = sizeof(int32) + sizeof(uint8);
+	static constexpr int64 PlacementBytes = 9;
+	static constexpr int64 WallBytes = 7;
+	static constexpr int64 DoorBytes = 5;
+
+	// A count read from the data must fit in what is left of it - rejects a tiny blob that claims
+	// millions of records before anything is allocated
+	static bool CanRead(FArchive& Ar, int64 Count, int64 BytesPerRecord)
+	{
+		if (Count < 0 || Count * BytesPerRecord > Ar.TotalSize() - Ar.Tell())
+		{
+			Ar.SetError();
+			return false;
+		}
+		return true;
+	}
+
+	static int32 GetEdgeLength(EWallEdge Edge, FIntPoint GridSize)
+	{
+		return (Edge == EWallEdge::North || Edge == EWallEdge::South) ? GridSize.Y : GridSize.X;
+	}
+
+	static int32 GetAcrossLength(EWallEdge Edge, FIntPoint GridSize)
+	{
+		return (Edge == EWallEdge::North || Edge == EWallEdge::South) ? GridSize.X : GridSize.Y;
+	}
+}
+
+bool FRoomLayout::Serialize(FArchive& Ar)
+{
+	using namespace RoomLayoutSerialization;
+	
+	auto Reject = [&Ar](const TCHAR* Reason)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RoomLayout: Rejecting layout data (%s)"), Reason);
+		Ar.SetError();
+		return false;
+	};
+	
+	// --- Header ---
+	uint32 FileMagic = Magic;
+	uint16 FileVersion = Version;
+	Ar << FileMagic;
+	Ar << FileVersion;
+	if (Ar.IsLoading() && (FileMagic != Magic || FileVersion != Version))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RoomLayout: Rejecting layout data (magic %08x, version %d, expected version %d)"),
+			FileMagic, FileVersion, Version);
+		Ar.SetError();
+		return false;
+	}
+	
+	uint16 SizeX = (uint16)GridSize.X;
+	uint16 SizeY = (uint16)GridSize.Y;
+	Ar << SizeX;
+	Ar << SizeY;
+	Ar << Seed;
+	if (Ar.IsLoading() && (SizeX > MaxGridSize || SizeY > MaxGridSize))
+	{
+		return Reject(TEXT("grid size above MaxGridSize"));
+	}
+	GridSize = FIntPoint(SizeX, SizeY);
+	const int64 NumCells = (int64)SizeX * SizeY;
+	
+	// --- Mesh Table ---
+	uint16 NumMeshes = (uint16)Meshes.Num();
+	Ar << NumMeshes;
+	if (Ar.IsLoading())
+	{
+		if (!CanRead(Ar, NumMeshes, MinMeshBytes)) return Reject(TEXT("mesh count past the end of the data"));
+		Meshes.SetNum(NumMeshes);
+		MeshCustomData.SetNum(NumMeshes);
+		MeshLookup.Reset();
+	}
+	for (int32 MeshIndex = 0; MeshIndex < NumMeshes; ++MeshIndex)
+	{
+		FString PathString = Meshes[MeshIndex].ToString();
+		Ar << PathString;
+		if (Ar.IsError()) return false;
+		if (Ar.IsLoading())
+		{
+			Meshes[MeshIndex].SetPath(PathString);
+		}
+		
+		// Variant custom data: count byte followed by the floats (almost always zero)
+		TArray<float>& CustomData = MeshCustomData[MeshIndex];
+		uint8 NumCustomData = (uint8)FMath::Min(CustomData.Num(), (int32)MAX_uint8);
+		Ar << NumCustomData;
+		if (Ar.IsLoading())
+		{
+			if (!CanRead(Ar, NumCustomData, sizeof(float))) return Reject(TEXT("custom data past the end of the data"));
+			CustomData.SetNum(NumCustomData);
+		}
+		for (int32 i = 0; i < NumCustomData; ++i)
+		{
+			Ar << CustomData[i];
+		}
+	}
+	
+	// --- Grid Placements ---
+	int32 NumPlacements = Placements.Num();
+	Ar << NumPlacements;
+	if (Ar.IsLoading())
+	{
+		// Floor, interior, clutter and ceiling can all stack on one cell
+		if (NumPlacements < 0 || NumPlacements > NumCells * RoomLayoutNumLayers)
+		{
+			return Reject(TEXT("more placements than cells x layers"));
+		}
+		if (!CanRead(Ar, NumPlacements, PlacementBytes)) return Reject(TEXT("placement count past the end of the data"));
+		Placements.SetNum(NumPlacements);
+	}
+	for (FRoomLayoutPlacement& Placement : Placements)
+	{
+		uint8 Flags = (Placement.Quadrant & 0x3) | ((uint8)Placement.Layer << 2);
+		Ar << Placement.MeshIndex;
+		Ar << Placement.CellX;
+		Ar << Placement.CellY;
+		Ar << Placement.FootprintX;
+		Ar << Placement.FootprintY;
+		Ar << Flags;
+		Placement.Quadrant = Flags & 0x3;
+		Placement.Layer = (ERoomLayoutLayer)((Flags >> 2) & 0x3);
+		
+		if (Ar.IsLoading())
+		{
+			if (Placement.MeshIndex >= NumMeshes) return Reject(TEXT("placement mesh index out of range"));
+			if (Placement.FootprintX == 0 || Placement.FootprintY == 0
+				|| Placement.CellX + Placement.FootprintX > SizeX || Placement.CellY + Placement.FootprintY > SizeY)
+			{
+				return Reject(TEXT("placement footprint leaves the grid"));
+			}
+		}
+	}
+	
+	// --- Walls ---
+	uint16 NumWalls = (uint16)Walls.Num();
+	Ar << NumWalls;
+	if (Ar.IsLoading())
+	{
+		if (!CanRead(Ar, NumWalls, WallBytes)) return Reject(TEXT("wall count past the end of the data"));
+		Walls.SetNum(NumWalls);
+	}
+	for (FRoomLayoutWall& Wall : Walls)
+	{
+		uint8 Flags = ((uint8)Wall.Edge & 0x3) | (Wall.bForced ? 0x4 : 0x0);
+		Ar << Flags;
+		Ar << Wall.Line;
+		Ar << Wall.StartCell;
+		Ar << Wall.ModuleIndex;
+		Wall.Edge = (EWallEdge)(Flags & 0x3);
+		Wall.bForced = (Flags & 0x4) != 0;
+		
+		// Walls stand on void cells: Line runs from -1 (South/West outer line) to the grid size (North/East outer line)
+		if (Ar.IsLoading() && (Wall.Line < -1 || Wall.Line > GetAcrossLength(Wall.Edge, GridSize)
+			|| Wall.StartCell >= GetEdgeLength(Wall.Edge, GridSize)))
+		{
+			return Reject(TEXT("wall outside its edge"));
+		}
+	}
+	
+	// --- Doors ---
+	uint16 NumDoors = (uint16)Doors.Num();
+	Ar << NumDoors;
+	if (Ar.IsLoading())
+	{
+		if (!CanRead(Ar, NumDoors, DoorBytes)) return Reject(TEXT("door count past the end of the data"));
+		Doors.SetNum(NumDoors);
+	}
+	for (FRoomLayoutDoor& Door : Doors)
+	{
+		uint8 Flags = ((uint8)Door.Edge & 0x3) | (((uint8)Door.Source & 0x3) << 2);
+		Ar << Flags;
+		Ar << Door.StartCell;
+		Ar << Door.Index;
+		Door.Edge = (EWallEdge)(Flags & 0x3);
+		Door.Source = (ERoomLayoutDoorSource)((Flags >> 2) & 0x3);
+		
+		if (Ar.IsLoading())
+		{
+			if ((uint8)Door.Source > (uint8)ERoomLayoutDoorSource::DoorStylePool) return Reject(TEXT("unknown door source"));
+			if (Door.StartCell >= GetEdgeLength(Door.Edge, GridSize)) return Reject(TEXT("door outside its edge"));
+		}
+	}
+	
+	// --- Cell States (two cells per byte) ---
+	if (Ar.IsLoading())
+	{
+		if (!CanRead(Ar, (NumCells + 1) / 2, 1)) return Reject(TEXT("cell states past the end of the data"));
+		CellStates.SetNum((int32)NumCells);
+	}
+	else
+	{
+		check(CellStates.Num() == NumCells);
+	}
+	for (int32 i = 0; i < NumCells; i += 2)
+	{
+		uint8 Packed = ((uint8)CellStates[i] & 0xF);
+		if (i + 1 < NumCells)
+		{
+			Packed |= ((uint8)CellStates[i + 1] & 0xF) << 4;
+		}
+		Ar << Packed;
+		
+		const uint8 Low = Packed & 0xF;
+		const uint8 High = Packed >> 4;
+		if (Ar.IsLoading() && (Low > (uint8)EGridCellType::ECT_Interior || (i + 1 < NumCells && High > (uint8)EGridCellType::ECT_Interior)))
+		{
+			return Reject(TEXT("unknown cell state"));
+		}
+		CellStates[i] = (EGridCellType)Low;
+		if (i + 1 < NumCells)
+		{
+			CellStates[i + 1] = (EGridCellType)High;
+		}
+	}
+	
+	return !Ar.IsError();
+}
+
+void FRoomLayout::Encode(TArray<uint8>& OutBytes) const
+{
+	OutBytes.Reset();
+	FMemoryWriter Writer(OutBytes);
+	const_cast<FRoomLayout*>(this)->Serialize(Writer);
+}
+
+bool FRoomLayout::Decode(const TArray<uint8>& Bytes)
+{
+	FMemoryReader Reader(Bytes);
+	
+	// Mesh path strings can't claim more characters than there are bytes
+	Reader.ArMaxSerializeSize = Bytes.Num();
+	return Serialize(Reader) && !Reader.IsError();
+}
+
+void FRoomLayout::ResolveMeshes(TArray<UStaticMesh*>& OutMeshes) const
+{
+	OutMeshes.SetNum(Meshes.Num());
+	for (int32 i = 0; i < Meshes.Num(); ++i)
+	{
+		OutMeshes[i] = Cast<UStaticMesh>(Meshes[i].TryLoad());
+		if (!OutMeshes[i])
+		{
+			UE_LOG(LogTemp, Warning, TEXT("RoomLayout: Mesh %s failed to load - its placements are skipped"), *Meshes[i].ToString());
+		}
+	}
+}
@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Rooms/RoomLayoutCache.h"
+#include "DungeonGen/Rooms/RoomLayout.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UnrealType.h"
+
+FString FRoomLayoutCache::GetCacheDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DungeonLayoutCache"));
+}
+
+FString FRoomLayoutCache::GetEntryPath(uint64 Key)
+{
+	return FPaths::Combine(GetCacheDirectory(), FString::Printf(TEXT("%016llx.rlyt"), Key));
+}
+
+uint64 FRoomLayoutCache::HashObjectProperties(const UObject* Object, uint64 Hash)
+{
+	if (!Object)
+	{
+		const uint8 NullMarker = 0;
+		return CityHash64WithSeed(reinterpret_cast<const char*>(&NullMarker), sizeof(NullMarker), Hash);
+	}
+
+	// Class name first, so two assets of different types with equal values don't collide
+	FString Text = Object->GetClass()->GetPathName();
+
+	for (TFieldIterator<FProperty> It(Object->GetClass()); It; ++It)
+	{
+		const FProperty* Property = *It;
+		if (Property->HasAnyPropertyFlags(CPF_Transient)) continue;
+
+		FString Value;
+		Property->ExportTextItem_InContainer(Value, Object, nullptr, nullptr, PPF_None);
+
+		Text += TEXT("|");
+		Text += Property->GetName();
+		Text += TEXT("=");
+		Text += Value;
+	}
+
+	const FTCHARToUTF8 Utf8(*Text);
+	return CityHash64WithSeed(Utf8.Get(), Utf8.Length(), Hash);
+}
+
+bool FRoomLayoutCache::Load(uint64 Key, FRoomLayout& OutLayout)
+{
+	const FString EntryPath = GetEntryPath(Key);
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *EntryPath, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	if (!OutLayout.Decode(Bytes))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RoomLayoutCache: Entry %s is corrupt or outdated - ignored"), *EntryPath);
+		return false;
+	}
+
+	// Timestamps order entries for Trim (least recently used first)
+	IFileManager::Get().SetTimeStamp(*EntryPath, FDateTime::UtcNow());
+	return true;
+}
+
+bool FRoomLayoutCache::Store(uint64 Key, const FRoomLayout& Layout)
+{
+	// One directory scan per session keeps the cache bounded without a cost per store
+	static bool bTrimmed = false;
+	if (!bTrimmed)
+	{
+		bTrimmed = true;
+		Trim();
+	}
+
+	TArray<uint8> Bytes;
+	Layout.Encode(Bytes);
+
+	// Write to a temp file and move it into place so readers never see a partial entry
+	const FString EntryPath = GetEntryPath(Key);
+	const FString TempPath = EntryPath + TEXT(".tmp");
+
+	if (!FFileHelper::SaveArrayToFile(Bytes, *TempPath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RoomLayoutCache: Failed to write %s"), *TempPath);
+		return false;
+	}
+
+	if (!IFileManager::Get().Move(*EntryPath, *TempPath, true, true))
+	{
+		IFileManager::Get().Delete(*TempPath, false, false, true);
+		UE_LOG(LogTemp, Warning, TEXT("RoomLayoutCache: Failed to move %s into place"), *EntryPath);
+		return false;
+	}
+
+	return true;
+}
+
+void FRoomLayoutCache::Trim()
+{
+	TArray<TPair<FDateTime, FString>> Entries;
+	IFileManager::Get().IterateDirectoryStat(*GetCacheDirectory(), [&Entries](const TCHAR* Path, const FFileStatData& Stat)
+	{
+		if (!Stat.bIsDirectory && FPaths::GetExtension(Path) == TEXT("rlyt"))
+		{
+			Entries.Emplace(Stat.ModificationTime, Path);
+		}
+		return true;
+	});
+
+	// Most recently used first
+	Entries.Sort([](const TPair<FDateTime, FString>& A, const TPair<FDateTime, FString>& B)
+	{
+		return A.Key > B.Key;
+	});
+
+	const FDateTime Cutoff = FDateTime::UtcNow() - FTimespan::FromDays(MaxEntryAgeDays);
+	int32 NumDeleted = 0;
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		if (i >= MaxEntries || Entries[i].Key < Cutoff)
+		{
+			NumDeleted += IFileManager::Get().Delete(*Entries[i].Value, false, false, true) ? 1 : 0;
+		}
+	}
+
+	if (NumDeleted > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("RoomLayoutCache: Trimmed %d of %d entries"), NumDeleted, Entries.Num());
+	}
+}
+
+void FRoomLayoutCache::Clear()
+{
+	IFileManager::Get().DeleteDirectory(*GetCacheDirectory(), false, true);
+	UE_LOG(LogTemp, Log, TEXT("RoomLayoutCache: Cleared %s"), *GetCacheDirectory());
+}
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Rooms/WallSegments.h"
+#include "Data/Room/RoomData.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshSocket.h"
+
+namespace WallSegments
+{
+	// Transform of the TopBackCenter socket of a layer (where the next layer sits)
+	// Fallback without a socket: straight up by FallbackHeight, or by the mesh height if FallbackHeight is 0
+	static FTransform GetStackSocket(const UStaticMesh* Mesh, float FallbackHeight)
+	{
+		if (const UStaticMeshSocket* Socket = Mesh->FindSocket(FName("TopBackCenter")))
+		{
+			return FTransform(Socket->RelativeRotation, Socket->RelativeLocation);
+		}
+		
+		const float Height = FallbackHeight > 0.0f ? FallbackHeight : Mesh->GetBounds().BoxExtent.Z * 2.0f;
+		return FTransform(FVector(0.0f, 0.0f, Height));
+	}
+	
+	// Stack the layers of a module whose meshes are set (a module without a BaseMesh places nothing)
+	static void ResolveStack(FCompiledWallModule& Module)
+	{
+		if (!Module.BaseMesh) return;
+		
+		// Base walls are 100cm tall when they have no socket; middle layers fall back to their bounds
+		const FTransform BaseSocket = GetStackSocket(Module.BaseMesh, 100.0f);
+		
+		// Middle stack: Base -> Middle1 -> Middle2 (Middle2 needs Middle1)
+		if (Module.Middle1Mesh)
+		{
+			Module.Middle1Relative = BaseSocket;
+			if (Module.Middle2Mesh)
+			{
+				Module.Middle2Relative = GetStackSocket(Module.Middle1Mesh, 0.0f) * Module.Middle1Relative;
+			}
+		}
+		
+		// Top sits on the highest layer: Middle2 > Middle1 > Base
+		if (Module.Middle1Mesh && Module.Middle2Mesh)
+		{
+			Module.TopRelative = GetStackSocket(Module.Middle2Mesh, 0.0f) * Module.Middle2Relative;
+		}
+		else if (Module.Middle1Mesh)
+		{
+			Module.TopRelative = GetStackSocket(Module.Middle1Mesh, 0.0f) * Module.Middle1Relative;
+		}
+		else
+		{
+			Module.TopRelative = BaseSocket;
+		}
+	}
+}
+
+void FCompiledWallStyle::Compile(URoomData& RoomData, const TArray<FForcedWallPlacement>& ForcedWalls)
+{
+	Reset();
+	
+	for (const FCompiledWallModuleData& Source : RoomData.GetCompiledData().WallModules)
+	{
+		FCompiledWallModule& Module = Modules.AddDefaulted_GetRef();
+		Module.BaseMesh = RoomData.GetCompiledMesh(Source.BaseMesh);
+		Module.Middle1Mesh = RoomData.GetCompiledMesh(Source.Middle1Mesh);
+		Module.Middle2Mesh = RoomData.GetCompiledMesh(Source.Middle2Mesh);
+		Module.TopMesh = RoomData.GetCompiledMesh(Source.TopMesh);
+		Module.Footprint = Source.Footprint;
+		Module.CustomData = Source.CustomData;
+		WallSegments::ResolveStack(Module);
+	}
+	NumDataModules = Modules.Num();
+	
+	for (const FForcedWallPlacement& Forced : ForcedWalls)
+	{
+		const FWallModule& Source = Forced.WallModule;
+		FCompiledWallModule& Module = Modules.AddDefaulted_GetRef();
+		Module.BaseMesh = Source.BaseMesh.LoadSynchronous();
+		Module.Middle1Mesh = Source.Middle1Mesh.LoadSynchronous();
+		Module.Middle2Mesh = Source.Middle2Mesh.LoadSynchronous();
+		Module.TopMesh = Source.TopMesh.LoadSynchronous();
+		Module.Footprint = Source.Y_AxisFootprint;
+		Module.CustomData = Source.CustomData;
+		WallSegments::ResolveStack(Module);
+	}
+}
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Stats/DungeonMemory.h"
+#include "DungeonGen/Rooms/MasterRoom.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+LLM_DEFINE_TAG(DungeonGen);
+LLM_DEFINE_TAG(DungeonGen_Layout, TEXT("Layout"), TEXT("DungeonGen"));
+LLM_DEFINE_TAG(DungeonGen_Instances, TEXT("Instances"), TEXT("DungeonGen"));
+LLM_DEFINE_TAG(DungeonGen_Collision, TEXT("Collision"), TEXT("DungeonGen"));
+LLM_DEFINE_TAG(DungeonGen_Navigation, TEXT("Navigation"), TEXT("DungeonGen"));
+LLM_DEFINE_TAG(DungeonGen_Debug, TEXT("Debug"), TEXT("DungeonGen"));
+
+FRoomMemoryStats& FRoomMemoryStats::operator+=(const FRoomMemoryStats& Other)
+{
+	GridStateBytes += Other.GridStateBytes;
+	OccupancyGridBytes += Other.OccupancyGridBytes;
+	WallSegmentBytes += Other.WallSegmentBytes;
+	LayoutBytes += Other.LayoutBytes;
+	InstanceBytes += Other.InstanceBytes;
+	CollisionBytes += Other.CollisionBytes;
+	ProxyBytes += Other.ProxyBytes;
+	NavigationBytes += Other.NavigationBytes;
+	DebugBytes += Other.DebugBytes;
+	NumInstanceComponents += Other.NumInstanceComponents;
+	NumInstances += Other.NumInstances;
+	return *this;
+}
+
+FString FRoomMemoryStats::ToString() const
+{
+	auto KB = [](int64 Bytes) { return Bytes / 1024.0; };
+	
+	return FString::Printf(TEXT("Total %.1f KB | Grid %.1f, Occupancy %.1f, Walls %.1f, Layout %.1f, Instances %.1f (%d in %d HISMs), Collision %.1f, Proxy %.1f, Nav %.1f, Debug %.1f"),
+		KB(GetTotalBytes()), KB(GridStateBytes), KB(OccupancyGridBytes), KB(WallSegmentBytes), KB(LayoutBytes),
+		KB(InstanceBytes), NumInstances, NumInstanceComponents, KB(CollisionBytes), KB(ProxyBytes), KB(NavigationBytes), KB(DebugBytes));
+}
+
+int64 DungeonMemory::GetComponentBytes(UActorComponent* Component)
+{
+	return IsValid(Component) ? (int64)Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive) : 0;
+}
+
+// ==================================================================================
+// CONSOLE REPORT
+// ==================================================================================
+
+// Dungeon.MemoryReport - per-room summary for every generated room in the world, largest first
+// Meant for benchmark runs and budget checks: the lines are stable and easy to scrape from the log
+static FAutoConsoleCommandWithWorld GDungeonMemoryReportCommand(
+	TEXT("Dungeon.MemoryReport"),
+	TEXT("Log the memory held by every generated room (and the dungeon total)"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (!World) return;
+		
+		TArray<TPair<AMasterRoom*, FRoomMemoryStats>> Reports;
+		for (TActorIterator<AMasterRoom> It(World); It; ++It)
+		{
+			if (It->IsRoomGenerated())
+			{
+				Reports.Emplace(*It, It->GetMemoryStats());
+			}
+		}
+		
+		Reports.Sort([](const TPair<AMasterRoom*, FRoomMemoryStats>& A, const TPair<AMasterRoom*, FRoomMemoryStats>& B)
+		{
+			return A.Value.GetTotalBytes() > B.Value.GetTotalBytes();
+		});
+		
+		FRoomMemoryStats Total;
+		for (const auto& Report : Reports)
+		{
+			UE_LOG(LogTemp, Display, TEXT("DungeonMemory: %s - %s"), *Report.Key->GetName(), *Report.Value.ToString());
+			Total += Report.Value;
+		}
+		
+		UE_LOG(LogTemp, Display, TEXT("DungeonMemory: %d rooms - %s"), Reports.Num(), *Total.ToString());
+	}));
@@ -0,0 +1,304 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonGen/Visibility/DungeonVisibility.h"
+#include "DungeonGen/Rooms/MasterRoom.h"
+#include "DungeonGen/Manager/DungeonConnection.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+// ==================================================================================
+// FRUSTUM HELPERS
+// ==================================================================================
+
+namespace DungeonVisibility
+{
+	// Portals closer than this to the eye plane don't narrow the frustum (edge planes degenerate)
+	static constexpr float MinPortalDistance = 1.0f;
+
+	// Upper bound on portal tests per view and pass (guards against pathological portal loops)
+	static constexpr int32 MaxPortalTestsPerView = 4096;
+
+	// Planes through the eye and each edge of a convex polygon, with normals pointing inward (towards InsidePoint)
+	// A point is inside the frustum if PlaneDot >= 0 for every plane
+	static void AddEdgePlanes(const FVector& Eye, const FVector* Points, int32 NumPoints, const FVector& InsidePoint, TArray<FPlane>& OutPlanes)
+	{
+		for (int32 i = 0; i < NumPoints; ++i)
+		{
+			const FVector& A = Points[i];
+			const FVector& B = Points[(i + 1) % NumPoints];
+			
+			FVector Normal = ((A - Eye) ^ (B - Eye)).GetSafeNormal();
+			if (Normal.IsNearlyZero()) continue;
+			
+			if ((Normal | (InsidePoint - Eye)) < 0.0f)
+			{
+				Normal = -Normal;
+			}
+			OutPlanes.Emplace(Eye, Normal);
+		}
+	}
+
+	// Conservative: culled only if all corners are outside one plane
+	static bool IsQuadInFrustum(const FDungeonPortalQuad& Quad, const TArray<FPlane>& Frustum)
+	{
+		for (const FPlane& Plane : Frustum)
+		{
+			bool bAllOutside = true;
+			for (int32 i = 0; i < 4 && bAllOutside; ++i)
+			{
+				bAllOutside = Plane.PlaneDot(Quad.Corners[i]) < 0.0f;
+			}
+			if (bAllOutside) return false;
+		}
+		return true;
+	}
+}
+
+// ==================================================================================
+// ROOM CELLS
+// ==================================================================================
+
+bool UDungeonVisibilitySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDungeonVisibilitySubsystem::UpdateRoom(AMasterRoom* Room)
+{
+	if (!Room || !Room->RoomData) return;
+	
+	LLM_SCOPE_BYTAG(DungeonGen);
+	
+	int32& CellIndex = CellIndices.FindOrAdd(Room, INDEX_NONE);
+	if (CellIndex == INDEX_NONE)
+	{
+		CellIndex = Cells.AddDefaulted();
+	}
+	
+	FDungeonVisibilityCell& Cell = Cells[CellIndex];
+	Cell.Room = Room;
+	Cell.Transform = Room->GetActorTransform();
+	Cell.LocalBounds = Room->GetRoomBounds().TransformBy(Cell.Transform.Inverse());
+	
+	TArray<FDungeonPortalQuad> Quads;
+	Room->GetPortalQuads(Quads);
+	Cell.Portals.Reset(Quads.Num());
+	for (const FDungeonPortalQuad& Quad : Quads)
+	{
+		Cell.Portals.AddDefaulted_GetRef().Quad = Quad;
+	}
+	
+	// The regeneration may have created new (visible) HISMs - re-apply the last decision
+	Room->SetPortalCulled(!Cell.bVisible);
+	
+	ResolvePortalLinks();
+}
+
+void UDungeonVisibilitySubsystem::RemoveRoom(AMasterRoom* Room)
+{
+	int32 CellIndex = INDEX_NONE;
+	if (!CellIndices.RemoveAndCopyValue(Room, CellIndex)) return;
+	
+	Cells.RemoveAtSwap(CellIndex);
+	if (Cells.IsValidIndex(CellIndex))
+	{
+		CellIndices.Add(Cells[CellIndex].Room.Get(), CellIndex);
+	}
+	
+	ResolvePortalLinks();
+}
+
+FDungeonPortalQuad FDungeonPortalQuad::FromConnectionPoint(const FDoorConnectionPoint& Point, const FVector& WorldUp, float OpeningHeight)
+{
+	const FVector Across = (WorldUp ^ Point.WorldFacing).GetSafeNormal() * (Point.Footprint * CELL_SIZE * 0.5f);
+	const FVector Up = WorldUp.GetSafeNormal() * OpeningHeight;
+	
+	FDungeonPortalQuad Quad;
+	Quad.Corners[0] = Point.WorldLocation - Across;
+	Quad.Corners[1] = Point.WorldLocation + Across;
+	Quad.Corners[2] = Point.WorldLocation + Across + Up;
+	Quad.Corners[3] = Point.WorldLocation - Across + Up;
+	Quad.Center = Point.WorldLocation + Up * 0.5f;
+	Quad.Normal = Point.WorldFacing;
+	Quad.Connection = Point;
+	return Quad;
+}
+
+void UDungeonVisibilitySubsystem::SetConnectionQuantization(float InQuantization)
+{
+	if (InQuantization == ConnectionQuantization) return;
+	
+	ConnectionQuantization = InQuantization;
+	ResolvePortalLinks();
+}
+
+void UDungeonVisibilitySubsystem::ResolvePortalLinks()
+{
+	// Same pairing as ADungeonManager::ConnectRoomDoors (cell index is the owner)
+	TArray<TPair<int32, int32>> PortalRefs;
+	TArray<DungeonConnection::FCandidate> Candidates;
+	for (int32 CellIndex = 0; CellIndex < Cells.Num(); ++CellIndex)
+	{
+		TArray<FDungeonVisibilityPortal>& Portals = Cells[CellIndex].Portals;
+		for (int32 PortalIndex = 0; PortalIndex < Portals.Num(); ++PortalIndex)
+		{
+			Portals[PortalIndex].LinkedRoom = INDEX_NONE;
+			Portals[PortalIndex].LinkedPortal = INDEX_NONE;
+			Candidates.Add({ CellIndex, &Portals[PortalIndex].Quad.Connection });
+			PortalRefs.Emplace(CellIndex, PortalIndex);
+		}
+	}
+	
+	TArray<TPair<int32, int32>> Pairs;
+	DungeonConnection::PairConnectionPoints(Candidates, ConnectionQuantization, Pairs);
+	
+	for (const TPair<int32, int32>& Pair : Pairs)
+	{
+		const TPair<int32, int32>& A = PortalRefs[Pair.Key];
+		const TPair<int32, int32>& B = PortalRefs[Pair.Value];
+		
+		FDungeonVisibilityPortal& PortalA = Cells[A.Key].Portals[A.Value];
+		FDungeonVisibilityPortal& PortalB = Cells[B.Key].Portals[B.Value];
+		PortalA.LinkedRoom = B.Key;
+		PortalA.LinkedPortal = B.Value;
+		PortalB.LinkedRoom = A.Key;
+		PortalB.LinkedPortal = A.Value;
+	}
+}
+
+// ==================================================================================
+// VISIBILITY PASS
+// ==================================================================================
+
+void UDungeonVisibilitySubsystem::UpdateVisibility(int32 MaxPortalDepth)
+{
+	UWorld* World = GetWorld();
+	if (!World || Cells.Num() == 0) return;
+	
+	float AspectRatio = 16.0f / 9.0f;
+	if (World->GetGameViewport())
+	{
+		FVector2D ViewportSize;
+		World->GetGameViewport()->GetViewportSize(ViewportSize);
+		if (ViewportSize.X > 0.0f && ViewportSize.Y > 0.0f)
+		{
+			AspectRatio = ViewportSize.X / ViewportSize.Y;
+		}
+	}
+	
+	TBitArray<> Visible(false, Cells.Num());
+	TBitArray<> OnPath(false, Cells.Num());
+	bool bAnyViewInside = false;
+	
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (!PC || !PC->IsLocalController() || !PC->PlayerCameraManager) continue;
+		
+		const FVector Eye = PC->PlayerCameraManager->GetCameraLocation();
+		const FRotationMatrix ViewRotation(PC->PlayerCameraManager->GetCameraRotation());
+		const FVector Forward = ViewRotation.GetUnitAxis(EAxis::X);
+		const FVector Right = ViewRotation.GetUnitAxis(EAxis::Y);
+		const FVector Up = ViewRotation.GetUnitAxis(EAxis::Z);
+		
+		// View frustum side planes (horizontal FOV, vertical derived from the aspect ratio)
+		const float TanHalfX = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(PC->PlayerCameraManager->GetFOVAngle(), 1.0f, 170.0f) * 0.5f));
+		const float TanHalfY = TanHalfX / AspectRatio;
+		const FVector FarCorners[4] =
+		{
+			Eye + Forward - Right * TanHalfX - Up * TanHalfY,
+			Eye + Forward + Right * TanHalfX - Up * TanHalfY,
+			Eye + Forward + Right * TanHalfX + Up * TanHalfY,
+			Eye + Forward - Right * TanHalfX + Up * TanHalfY
+		};
+		TArray<FPlane> Frustum;
+		DungeonVisibility::AddEdgePlanes(Eye, FarCorners, 4, Eye + Forward, Frustum);
+		
+		// Start in every room containing the eye (standing in a doorway puts it in both rooms' boundary rings)
+		for (int32 CellIndex = 0; CellIndex < Cells.Num(); ++CellIndex)
+		{
+			const FDungeonVisibilityCell& Cell = Cells[CellIndex];
+			if (!Cell.LocalBounds.IsInsideOrOn(Cell.Transform.InverseTransformPosition(Eye))) continue;
+			
+			bAnyViewInside = true;
+			int32 Budget = DungeonVisibility::MaxPortalTestsPerView;
+			TraversePortals(CellIndex, INDEX_NONE, Eye, Frustum, 0, MaxPortalDepth, OnPath, Visible, Budget);
+		}
+	}
+	
+	// Outside the dungeon (spectating, flying camera) nothing can be culled through portals
+	if (!bAnyViewInside)
+	{
+		ShowAllRooms();
+		return;
+	}
+	
+	ApplyVisibility(Visible);
+}
+
+void UDungeonVisibilitySubsystem::TraversePortals(int32 RoomIndex, int32 EntryPortal, const FVector& Eye, const TArray<FPlane>& Frustum,
+	int32 Depth, int32 MaxDepth, TBitArray<>& OnPath, TBitArray<>& OutVisible, int32& Budget) const
+{
+	OutVisible[RoomIndex] = true;
+	OnPath[RoomIndex] = true;
+	
+	const TArray<FDungeonVisibilityPortal>& Portals = Cells[RoomIndex].Portals;
+	for (int32 PortalIndex = 0; PortalIndex < Portals.Num() && Budget > 0; ++PortalIndex)
+	{
+		const FDungeonVisibilityPortal& Portal = Portals[PortalIndex];
+		if (PortalIndex == EntryPortal || Portal.LinkedRoom == INDEX_NONE || OnPath[Portal.LinkedRoom]) continue;
+		
+		// Only portals we look out through (the eye is on the owning room's side of the opening)
+		const float EyeDistance = (Portal.Quad.Center - Eye) | Portal.Quad.Normal;
+		if (EyeDistance <= 0.0f) continue;
+		
+		--Budget;
+		if (!DungeonVisibility::IsQuadInFrustum(Portal.Quad, Frustum)) continue;
+		
+		// Too deep to keep narrowing - show the room without walking further
+		if (Depth + 1 >= MaxDepth)
+		{
+			OutVisible[Portal.LinkedRoom] = true;
+			continue;
+		}
+		
+		// Narrow the frustum to the opening: its edge planes, plus the portal plane as the new near plane
+		TArray<FPlane> Narrowed(Frustum);
+		if (EyeDistance > DungeonVisibility::MinPortalDistance)
+		{
+			DungeonVisibility::AddEdgePlanes(Eye, Portal.Quad.Corners, 4, Portal.Quad.Center, Narrowed);
+			Narrowed.Emplace(Portal.Quad.Center, Portal.Quad.Normal);
+		}
+		
+		TraversePortals(Portal.LinkedRoom, Portal.LinkedPortal, Eye, Narrowed, Depth + 1, MaxDepth, OnPath, OutVisible, Budget);
+	}
+	
+	OnPath[RoomIndex] = false;
+}
+
+void UDungeonVisibilitySubsystem::ApplyVisibility(const TBitArray<>& Visible)
+{
+	NumCulledRooms = 0;
+	for (int32 CellIndex = 0; CellIndex < Cells.Num(); ++CellIndex)
+	{
+		FDungeonVisibilityCell& Cell = Cells[CellIndex];
+		const bool bVisible = Visible[CellIndex];
+		NumCulledRooms += bVisible ? 0 : 1;
+		
+		if (Cell.bVisible == bVisible) continue;
+		
+		Cell.bVisible = bVisible;
+		if (AMasterRoom* Room = Cell.Room.Get())
+		{
+			Room->SetPortalCulled(!bVisible);
+		}
+	}
+}
+
+void UDungeonVisibilitySubsystem::ShowAllRooms()
+{
+	ApplyVisibility(TBitArray<>(true, Cells.Num()));
+}
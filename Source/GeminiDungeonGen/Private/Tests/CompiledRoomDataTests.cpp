@@ -0,0 +1,272 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "Data/Room/CompiledRoomData.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CompiledRoomDataTests
+{
+	// Tables of a small room using every section: pools, a rejected wall module, corners, two doors and ceiling tiles
+	static void MakeValidTables(FCompiledRoomData& Compiled)
+	{
+		Compiled.GridSize = FIntPoint(10, 8);
+		Compiled.Meshes.Add(FSoftObjectPath(TEXT("/Game/Dungeon/SM_Floor.SM_Floor")));
+		Compiled.Meshes.Add(FSoftObjectPath(TEXT("/Game/Dungeon/SM_Wall.SM_Wall")));
+		Compiled.Meshes.Add(FSoftObjectPath(TEXT("/Game/Dungeon/SM_Corner.SM_Corner")));
+
+		FCompiledMeshEntry& Floor = Compiled.FloorTiles.Entries.AddDefaulted_GetRef();
+		Floor.MeshIndex = 0;
+		Floor.NumQuadrants = 4;
+		Floor.Quadrants[1] = 1;
+		Floor.Quadrants[2] = 2;
+		Floor.Quadrants[3] = 3;
+		Compiled.FloorTiles.Weights.Add(1000);
+
+		FCompiledMeshEntry& Clutter = Compiled.Clutter.Entries.AddDefaulted_GetRef();
+		Clutter.MeshIndex = 0;
+		Clutter.FootprintX = 2;
+		Clutter.CustomData = { 0.25f, 0.75f };
+		Compiled.Clutter.Weights.Add(500);
+		Compiled.ClutterPlacementChance = 0.3f;
+		Compiled.ClutterMinSpacing = 250.0f;
+		Compiled.ClutterCullDistance = 4000.0f;
+
+		// Module 0 is valid, module 1 was rejected by the compiler (no base mesh) but keeps its slot
+		FCompiledWallModuleData& Wall = Compiled.WallModules.AddDefaulted_GetRef();
+		Wall.BaseMesh = 1;
+		Wall.TopMesh = 1;
+		Wall.Footprint = 2;
+		Compiled.WallModules.AddDefaulted();
+		Compiled.WallFillOrder.Add(0);
+		Compiled.WallFillFootprints.Add(2);
+		Compiled.WallHeight = 400.0f;
+		Compiled.NorthWallOffset = 12.5f;
+
+		Compiled.CornerMeshIndex = 2;
+		Compiled.CornerOffsets[2] = FVector(10.0f, -10.0f, 0.0f);
+
+		// The door style itself (1 cell) and pool door 0 (2 cells), smallest first
+		Compiled.DoorPoolIndices = { INDEX_NONE, 0 };
+		Compiled.DoorFootprints = { 1, 2 };
+		for (int32 i = 0; i < 2; ++i)
+		{
+			FCompiledDoorFrameData& Frame = Compiled.DoorFrames.AddDefaulted_GetRef();
+			Frame.FrameMesh = i == 0 ? 1 : INDEX_NONE;
+			Frame.ConnectionBoxExtent = FVector(50.0f, 100.0f * (i + 1), 150.0f);
+			Frame.DoorData = FSoftObjectPath(TEXT("/Game/Dungeon/DA_Door.DA_Door"));
+			Compiled.DoorWeights.Add(1000);
+		}
+
+		Compiled.SmallCeilingTiles.MeshIndices.Add(0);
+		Compiled.SmallCeilingTiles.Weights.Add(1000);
+		Compiled.CeilingHeight = 500.0f;
+	}
+
+	// The tables must encode but fail to decode
+	static void ExpectRejected(FAutomationTestBase& Test, const TCHAR* What, const FCompiledRoomData& Compiled)
+	{
+		TArray<uint8> Bytes;
+		Compiled.Encode(Bytes);
+
+		FCompiledRoomData Decoded;
+		Test.TestFalse(What, Decoded.Decode(Bytes));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCompiledRoomDataRoundTripTest, "DungeonGen.CompiledRoomData.RoundTrip.AllTables",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCompiledRoomDataRoundTripTest::RunTest(const FString& Parameters)
+{
+	FCompiledRoomData Compiled;
+	CompiledRoomDataTests::MakeValidTables(Compiled);
+
+	TArray<uint8> Bytes;
+	Compiled.Encode(Bytes);
+
+	FCompiledRoomData Decoded;
+	if (!TestTrue(TEXT("Tables decode"), Decoded.Decode(Bytes)))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("Grid size"), Decoded.GridSize == Compiled.GridSize);
+	TestTrue(TEXT("Mesh table"), Decoded.Meshes == Compiled.Meshes);
+
+	// Pools: rotations, footprints, custom data and weights
+	if (TestEqual(TEXT("Floor entries"), Decoded.FloorTiles.Entries.Num(), 1))
+	{
+		const FCompiledMeshEntry& Floor = Decoded.FloorTiles.Entries[0];
+		TestEqual(TEXT("Floor quadrant count"), (int32)Floor.NumQuadrants, 4);
+		TestEqual(TEXT("Floor last quadrant"), (int32)Floor.Quadrants[3], 3);
+	}
+	if (TestEqual(TEXT("Clutter entries"), Decoded.Clutter.Entries.Num(), 1))
+	{
+		TestEqual(TEXT("Clutter footprint"), (int32)Decoded.Clutter.Entries[0].FootprintX, 2);
+		TestTrue(TEXT("Clutter custom data"), Decoded.Clutter.Entries[0].CustomData == Compiled.Clutter.Entries[0].CustomData);
+	}
+	TestTrue(TEXT("Clutter weights"), Decoded.Clutter.Weights.Cumulative == Compiled.Clutter.Weights.Cumulative);
+	TestEqual(TEXT("Clutter spacing"), Decoded.ClutterMinSpacing, Compiled.ClutterMinSpacing);
+	TestEqual(TEXT("Clutter cull distance"), Decoded.ClutterCullDistance, Compiled.ClutterCullDistance);
+
+	// Walls: the rejected module keeps its slot, so layout wall records still index the same modules
+	if (TestEqual(TEXT("Wall modules"), Decoded.WallModules.Num(), 2))
+	{
+		TestEqual(TEXT("Wall base mesh"), Decoded.WallModules[0].BaseMesh, 1);
+		TestEqual(TEXT("Wall middle mesh unused"), Decoded.WallModules[0].Middle1Mesh, (int32)INDEX_NONE);
+		TestEqual(TEXT("Rejected module has no base mesh"), Decoded.WallModules[1].BaseMesh, (int32)INDEX_NONE);
+	}
+	TestTrue(TEXT("Wall fill order"), Decoded.WallFillOrder == Compiled.WallFillOrder);
+	TestEqual(TEXT("Wall height"), Decoded.WallHeight, Compiled.WallHeight);
+	TestEqual(TEXT("North wall offset"), Decoded.NorthWallOffset, Compiled.NorthWallOffset);
+
+	TestEqual(TEXT("Corner mesh"), Decoded.CornerMeshIndex, 2);
+	TestEqual(TEXT("Corner offset"), Decoded.CornerOffsets[2], Compiled.CornerOffsets[2]);
+
+	// Doors: sorted tables and one frame per door
+	TestTrue(TEXT("Door pool indices"), Decoded.DoorPoolIndices == Compiled.DoorPoolIndices);
+	if (TestEqual(TEXT("Door frames"), Decoded.DoorFrames.Num(), 2))
+	{
+		TestEqual(TEXT("Door frame mesh"), Decoded.DoorFrames[0].FrameMesh, 1);
+		TestEqual(TEXT("Door connection box"), Decoded.DoorFrames[1].ConnectionBoxExtent, Compiled.DoorFrames[1].ConnectionBoxExtent);
+		TestTrue(TEXT("Door data path"), Decoded.DoorFrames[1].DoorData == Compiled.DoorFrames[1].DoorData);
+	}
+	TestEqual(TEXT("Door style found"), Decoded.FindDoor(INDEX_NONE), 0);
+	TestEqual(TEXT("Pool door found"), Decoded.FindDoor(0), 1);
+	TestEqual(TEXT("Unknown door"), Decoded.FindDoor(5), (int32)INDEX_NONE);
+	TestEqual(TEXT("Doors fitting one cell"), Decoded.GetNumDoorsFitting(1), 1);
+	TestEqual(TEXT("Doors fitting three cells"), Decoded.GetNumDoorsFitting(3), 2);
+
+	TestTrue(TEXT("Small ceiling tiles"), Decoded.SmallCeilingTiles.MeshIndices == Compiled.SmallCeilingTiles.MeshIndices);
+	TestEqual(TEXT("Ceiling height"), Decoded.CeilingHeight, Compiled.CeilingHeight);
+
+	// Re-encoding the decoded tables gives the same bytes
+	TArray<uint8> Reencoded;
+	Decoded.Encode(Reencoded);
+	TestTrue(TEXT("Encoding is stable"), Reencoded == Bytes);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCompiledRoomDataRejectTest, "DungeonGen.CompiledRoomData.Decode.RejectsCorruptData",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCompiledRoomDataRejectTest::RunTest(const FString& Parameters)
+{
+	AddExpectedError(TEXT("CompiledRoomData: Rejecting blob"), EAutomationExpectedErrorFlags::Contains, 0);
+
+	FCompiledRoomData Valid;
+	CompiledRoomDataTests::MakeValidTables(Valid);
+
+	// Header
+	{
+		TArray<uint8> Bytes;
+		Valid.Encode(Bytes);
+		Bytes[0] ^= 0xFF;
+
+		FCompiledRoomData Decoded;
+		TestFalse(TEXT("Bad magic is rejected"), Decoded.Decode(Bytes));
+	}
+	{
+		TArray<uint8> Bytes;
+		Valid.Encode(Bytes);
+		Bytes[4] ^= 0xFF;
+
+		FCompiledRoomData Decoded;
+		TestFalse(TEXT("Other version is rejected"), Decoded.Decode(Bytes));
+	}
+	{
+		TArray<uint8> Bytes;
+		Valid.Encode(Bytes);
+		Bytes.SetNum(Bytes.Num() - 1);
+
+		FCompiledRoomData Decoded;
+		TestFalse(TEXT("Truncated data is rejected"), Decoded.Decode(Bytes));
+	}
+
+	// Mesh indices past the mesh table
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.FloorTiles.Entries[0].MeshIndex = (uint16)Compiled.Meshes.Num();
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Pool entry past the mesh table is rejected"), Compiled);
+	}
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.WallModules[0].Middle1Mesh = Compiled.Meshes.Num();
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Wall module mesh past the mesh table is rejected"), Compiled);
+	}
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.CornerMeshIndex = -2;
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Negative corner mesh is rejected"), Compiled);
+	}
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.DoorFrames[1].FrameMesh = Compiled.Meshes.Num();
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Door frame mesh past the mesh table is rejected"), Compiled);
+	}
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.SmallCeilingTiles.MeshIndices[0] = (uint16)Compiled.Meshes.Num();
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Ceiling tile past the mesh table is rejected"), Compiled);
+	}
+
+	// Wall fill order
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.WallFillOrder[0] = (uint16)Compiled.WallModules.Num();
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Fill order past the wall modules is rejected"), Compiled);
+	}
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.WallFillOrder.Add(1);
+		Compiled.WallFillFootprints.Add(1);
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Fill order picking a rejected module is rejected"), Compiled);
+	}
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.WallFillFootprints[0] = 3;
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Fill footprint not matching its module is rejected"), Compiled);
+	}
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.WallModules[0].Footprint = 0;
+		Compiled.WallFillFootprints[0] = 0;
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Zero wall footprint is rejected"), Compiled);
+	}
+
+	// Door tables
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.DoorFootprints = { 2, 1 };
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Unsorted door footprints are rejected"), Compiled);
+	}
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.DoorFrames.SetNum(1);
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Missing door frame is rejected"), Compiled);
+	}
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.DoorPoolIndices[1] = -2;
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Door pool index below INDEX_NONE is rejected"), Compiled);
+	}
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.DoorWeights.Cumulative.SetNum(1);
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Door weights not matching the doors are rejected"), Compiled);
+	}
+
+	// Pool weights
+	{
+		FCompiledRoomData Compiled = Valid;
+		Compiled.Clutter.Weights.Add(0);
+		CompiledRoomDataTests::ExpectRejected(*this, TEXT("Weights not matching the pool are rejected"), Compiled);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "DungeonGen/Manager/DungeonConnection.h"
+#include "Algo/Reverse.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DungeonConnectionTests
+{
+	static constexpr float Quantum = CELL_SIZE / 2.0f;
+
+	static FDoorConnectionPoint MakePoint(const FVector& Location, const FVector& Facing)
+	{
+		FDoorConnectionPoint Point;
+		Point.WorldLocation = Location;
+		Point.WorldFacing = Facing;
+		return Point;
+	}
+
+	// Pairs as sorted (point, point) pairs, so results of differently ordered candidates compare equal
+	static TArray<TPair<const FDoorConnectionPoint*, const FDoorConnectionPoint*>> PairPoints(TConstArrayView<DungeonConnection::FCandidate> Candidates)
+	{
+		TArray<TPair<int32, int32>> Pairs;
+		DungeonConnection::PairConnectionPoints(Candidates, Quantum, Pairs);
+
+		TArray<TPair<const FDoorConnectionPoint*, const FDoorConnectionPoint*>> Result;
+		for (const TPair<int32, int32>& Pair : Pairs)
+		{
+			const FDoorConnectionPoint* A = Candidates[Pair.Key].Point;
+			const FDoorConnectionPoint* B = Candidates[Pair.Value].Point;
+			Result.Emplace(FMath::Min(A, B), FMath::Max(A, B));
+		}
+		Result.Sort([](const auto& L, const auto& R) { return L.Key != R.Key ? L.Key < R.Key : L.Value < R.Value; });
+		return Result;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonConnectionOrderTest, "DungeonGen.Connection.Pairing.IndependentOfOrder",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDungeonConnectionOrderTest::RunTest(const FString& Parameters)
+{
+	using namespace DungeonConnectionTests;
+
+	// A row of three rooms along X, 10 cm apart, plus a door on room 1 facing the same way as room 0's (never pairs)
+	const FDoorConnectionPoint Points[] =
+	{
+		MakePoint(FVector(1000.0f, 300.0f, 0.0f), FVector(1.0f, 0.0f, 0.0f)),		// Room 0 North
+		MakePoint(FVector(1010.0f, 300.0f, 0.0f), FVector(-1.0f, 0.0f, 0.0f)),		// Room 1 South
+		MakePoint(FVector(2010.0f, 300.0f, 0.0f), FVector(1.0f, 0.0f, 0.0f)),		// Room 1 North
+		MakePoint(FVector(2020.0f, 300.0f, 0.0f), FVector(-1.0f, 0.0f, 0.0f)),		// Room 2 South
+		MakePoint(FVector(1500.0f, 900.0f, 0.0f), FVector(0.0f, 1.0f, 0.0f)),		// Room 1 East (nothing there)
+	};
+	const int32 Owners[] = { 0, 1, 1, 2, 1 };
+
+	TArray<DungeonConnection::FCandidate> Candidates;
+	for (int32 i = 0; i < UE_ARRAY_COUNT(Points); ++i)
+	{
+		Candidates.Add({ Owners[i], &Points[i] });
+	}
+
+	const auto Expected = PairPoints(Candidates);
+	TestEqual(TEXT("Both room gaps connect"), Expected.Num(), 2);
+
+	// Every rotation and the reverse of the candidate list pairs the same doors
+	for (int32 Rotation = 1; Rotation < Candidates.Num(); ++Rotation)
+	{
+		TArray<DungeonConnection::FCandidate> Rotated;
+		for (int32 i = 0; i < Candidates.Num(); ++i)
+		{
+			Rotated.Add(Candidates[(i + Rotation) % Candidates.Num()]);
+		}
+		TestTrue(FString::Printf(TEXT("Rotation %d pairs the same doors"), Rotation), PairPoints(Rotated) == Expected);
+	}
+
+	TArray<DungeonConnection::FCandidate> Reversed = Candidates;
+	Algo::Reverse(Reversed);
+	TestTrue(TEXT("Reversed order pairs the same doors"), PairPoints(Reversed) == Expected);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonConnectionDuplicateTest, "DungeonGen.Connection.Pairing.DuplicatesNeverConnect",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDungeonConnectionDuplicateTest::RunTest(const FString& Parameters)
+{
+	using namespace DungeonConnectionTests;
+
+	// Rooms 0 and 1 both publish a door in the same bucket; the only door facing them belongs to room 0.
+	// The kept door (room 0) cannot pair with its own room, and the dropped one (room 1) must not pair at all.
+	const FDoorConnectionPoint Kept = MakePoint(FVector(500.0f, 0.0f, 0.0f), FVector(1.0f, 0.0f, 0.0f));
+	const FDoorConnectionPoint Dropped = MakePoint(FVector(505.0f, 0.0f, 0.0f), FVector(1.0f, 0.0f, 0.0f));
+	const FDoorConnectionPoint Facing = MakePoint(FVector(510.0f, 0.0f, 0.0f), FVector(-1.0f, 0.0f, 0.0f));
+
+	for (const bool bReversed : { false, true })
+	{
+		TArray<DungeonConnection::FCandidate> Candidates = { { 0, &Kept }, { 1, &Dropped }, { 0, &Facing } };
+		if (bReversed)
+		{
+			Algo::Reverse(Candidates);
+		}
+
+		TArray<TPair<int32, int32>> Pairs;
+		TArray<TPair<int32, int32>> Duplicates;
+		DungeonConnection::PairConnectionPoints(Candidates, Quantum, Pairs, &Duplicates);
+
+		const TCHAR* Order = bReversed ? TEXT("reversed") : TEXT("forward");
+		TestEqual(FString::Printf(TEXT("No pairs (%s)"), Order), Pairs.Num(), 0);
+		if (TestEqual(FString::Printf(TEXT("One duplicate (%s)"), Order), Duplicates.Num(), 1))
+		{
+			TestTrue(FString::Printf(TEXT("Lowest owner is kept (%s)"), Order), Candidates[Duplicates[0].Key].Point == &Kept);
+			TestTrue(FString::Printf(TEXT("Other owner is dropped (%s)"), Order), Candidates[Duplicates[0].Value].Point == &Dropped);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonConnectionOffGridTest, "DungeonGen.Connection.Pairing.OffGridLateralOffset",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDungeonConnectionOffGridTest::RunTest(const FString& Parameters)
+{
+	using namespace DungeonConnectionTests;
+
+	// 25 cm apart sideways, straddling a quantum boundary (20 rounds down, 45 rounds up): the boxes overlap
+	for (const FVector& Facing : { FVector(1.0f, 0.0f, 0.0f), FVector(0.0f, 1.0f, 0.0f) })
+	{
+		const FVector Across(-Facing.Y, Facing.X, 0.0f);
+		const FDoorConnectionPoint A = MakePoint(FVector(1000.0f, 1000.0f, 0.0f) + Across * 20.0f, Facing);
+		const FDoorConnectionPoint B = MakePoint(FVector(1000.0f, 1000.0f, 0.0f) + Across * 45.0f, -Facing);
+
+		const DungeonConnection::FCandidate Candidates[] = { { 0, &A }, { 1, &B } };
+		TArray<TPair<int32, int32>> Pairs;
+		DungeonConnection::PairConnectionPoints(Candidates, Quantum, Pairs);
+		TestEqual(FString::Printf(TEXT("Doors 25 cm apart connect (facing %s)"), *Facing.ToString()), Pairs.Num(), 1);
+	}
+
+	// Too far apart sideways for the boxes to overlap: no pair, even though the neighbouring bucket is probed
+	{
+		const FDoorConnectionPoint A = MakePoint(FVector(1000.0f, 0.0f, 0.0f), FVector(1.0f, 0.0f, 0.0f));
+		const FDoorConnectionPoint B = MakePoint(FVector(1000.0f, 120.0f, 0.0f), FVector(-1.0f, 0.0f, 0.0f));
+
+		const DungeonConnection::FCandidate Candidates[] = { { 0, &A }, { 1, &B } };
+		TArray<TPair<int32, int32>> Pairs;
+		DungeonConnection::PairConnectionPoints(Candidates, Quantum, Pairs);
+		TestEqual(TEXT("Doors 120 cm apart do not connect"), Pairs.Num(), 0);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
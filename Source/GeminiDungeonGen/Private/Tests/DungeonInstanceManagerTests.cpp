@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "DungeonGen/Instances/DungeonInstanceManager.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DungeonInstanceManagerTests
+{
+	static constexpr int32 NumInstances = 8;
+
+	// Instance i sits at Y = i * 100; the first six share chunk 0, the last two go to the next chunk along X.
+	// Its single custom data float is i as well, so a moved instance can be checked against its transform.
+	static void MakeInstances(float ChunkSize, TArray<FTransform>& OutTransforms, TArray<float>& OutCustomData)
+	{
+		for (int32 i = 0; i < NumInstances; ++i)
+		{
+			OutTransforms.Emplace(FVector(i < 6 ? 0.0f : ChunkSize + 100.0f, i * 100.0f, 0.0f));
+			OutCustomData.Add((float)i);
+		}
+	}
+
+	// Instance ids (see MakeInstances) currently held by the owner's HISMs. Adds an error if an instance's custom
+	// data no longer matches its transform.
+	static TArray<int32> GetLiveInstances(FAutomationTestBase& Test, const AActor* Owner)
+	{
+		TArray<int32> Ids;
+		TInlineComponentArray<UHierarchicalInstancedStaticMeshComponent*> Components(Owner);
+		for (const UHierarchicalInstancedStaticMeshComponent* Component : Components)
+		{
+			for (int32 Index = 0; Index < Component->GetInstanceCount(); ++Index)
+			{
+				FTransform Transform;
+				Component->GetInstanceTransform(Index, Transform, true);
+				const int32 Id = FMath::RoundToInt(Transform.GetLocation().Y / 100.0f);
+				if (!FMath::IsNearlyEqual(Component->PerInstanceSMCustomData[Index], (float)Id))
+				{
+					Test.AddError(FString::Printf(TEXT("Instance %d carries the custom data of another instance"), Id));
+				}
+				Ids.Add(Id);
+			}
+		}
+		Ids.Sort();
+		return Ids;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonInstanceHandleTest, "DungeonGen.Instances.Handles.StableAcrossRemoval",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDungeonInstanceHandleTest::RunTest(const FString& Parameters)
+{
+	UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!TestNotNull(TEXT("Engine cube mesh"), Mesh))
+	{
+		return false;
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	AActor* Owner = World->SpawnActor<AActor>();
+	UDungeonInstanceManager* Manager = NewObject<UDungeonInstanceManager>(Owner);
+	Owner->SetRootComponent(Manager);
+	Manager->RegisterComponent();
+
+	TArray<FTransform> Transforms;
+	TArray<float> CustomData;
+	DungeonInstanceManagerTests::MakeInstances(Manager->ChunkSize, Transforms, CustomData);
+
+	TArray<FDungeonInstanceHandle> Handles;
+	Manager->AddInstances(Mesh, FDungeonInstanceSettings(), Transforms, CustomData, 1, Handles);
+	TestEqual(TEXT("One handle per instance"), Handles.Num(), DungeonInstanceManagerTests::NumInstances);
+	TestEqual(TEXT("One HISM per chunk"), Manager->GetNumComponents(), 2);
+	TestEqual(TEXT("Every instance added"), Manager->GetNumInstances(), DungeonInstanceManagerTests::NumInstances);
+
+	// Holes in the middle of chunk 0 are filled from its tail
+	Manager->RemoveInstances({ Handles[1], Handles[2] });
+	TestEqual(TEXT("Two instances removed"), Manager->GetNumInstances(), DungeonInstanceManagerTests::NumInstances - 2);
+	TestTrue(TEXT("The removed instances are gone, the moved ones kept their data"),
+		DungeonInstanceManagerTests::GetLiveInstances(*this, Owner) == TArray<int32>({ 0, 3, 4, 5, 6, 7 }));
+
+	// Stale handles are ignored, even once their slot is reused by a new instance
+	Manager->RemoveInstances({ Handles[1] });
+	TestEqual(TEXT("Removing twice is ignored"), Manager->GetNumInstances(), DungeonInstanceManagerTests::NumInstances - 2);
+
+	TArray<FDungeonInstanceHandle> NewHandles;
+	Manager->AddInstances(Mesh, FDungeonInstanceSettings(), { Transforms[2] }, { CustomData[2] }, 1, NewHandles);
+	Manager->RemoveInstances({ Handles[2] });
+	TestEqual(TEXT("Stale handle does not remove the slot's new instance"), Manager->GetNumInstances(), DungeonInstanceManagerTests::NumInstances - 1);
+
+	// Every remaining handle, moved or not, still removes exactly its own instance
+	for (const int32 Id : { 5, 0, 7, 3, 6, 4 })
+	{
+		const int32 NumBefore = Manager->GetNumInstances();
+		Manager->RemoveInstances({ Handles[Id] });
+		TestEqual(FString::Printf(TEXT("Handle %d removes one instance"), Id), Manager->GetNumInstances(), NumBefore - 1);
+		TestFalse(FString::Printf(TEXT("Handle %d removes its own instance"), Id),
+			DungeonInstanceManagerTests::GetLiveInstances(*this, Owner).Contains(Id));
+	}
+	TestTrue(TEXT("Only the re-added instance is left"), DungeonInstanceManagerTests::GetLiveInstances(*this, Owner) == TArray<int32>({ 2 }));
+
+	Manager->RemoveInstances(NewHandles);
+	TestEqual(TEXT("All instances removed"), Manager->GetNumInstances(), 0);
+
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,189 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "DungeonGen/Navigation/DungeonPathfinding.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DungeonPathfindingTests
+{
+	// Open room of GridSize at the world origin
+	static FDungeonPathRoom MakeRoom(FIntPoint GridSize)
+	{
+		FDungeonPathRoom Room;
+		Room.GridSize = GridSize;
+		Room.Walkable.Init(true, GridSize.X * GridSize.Y);
+		return Room;
+	}
+
+	static void Block(FDungeonPathRoom& Room, int32 X, int32 Y)
+	{
+		Room.Walkable[Y * Room.GridSize.X + X] = false;
+	}
+
+	static FVector CellCentre(FIntPoint Cell)
+	{
+		return FVector((Cell.X + 0.5f) * CELL_SIZE, (Cell.Y + 0.5f) * CELL_SIZE, 0.0f);
+	}
+
+	// A point lies on walkable ground if any cell touching it is walkable (points on cell borders touch two or four)
+	static bool IsPointWalkable(const FDungeonPathRoom& Room, const FVector& Point)
+	{
+		for (const float OffsetX : { -0.01f, 0.01f })
+		{
+			for (const float OffsetY : { -0.01f, 0.01f })
+			{
+				if (Room.IsWalkable(FMath::FloorToInt((Point.X + OffsetX) / CELL_SIZE), FMath::FloorToInt((Point.Y + OffsetY) / CELL_SIZE)))
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	// Path runs from the start to the goal cell centre and every segment stays on walkable cells. Returns its length.
+	static float CheckPath(FAutomationTestBase& Test, const TCHAR* What, const FDungeonPathRoom& Room, FIntPoint Start, FIntPoint Goal,
+		const TArray<FVector>& Points)
+	{
+		if (Points.Num() == 0)
+		{
+			Test.AddError(FString::Printf(TEXT("%s: empty path"), What));
+			return 0.0f;
+		}
+		Test.TestEqual(FString::Printf(TEXT("%s: starts at the start cell"), What), Points[0], CellCentre(Start));
+		Test.TestEqual(FString::Printf(TEXT("%s: ends at the goal cell"), What), Points.Last(), CellCentre(Goal));
+
+		float Length = 0.0f;
+		for (int32 i = 1; i < Points.Num(); ++i)
+		{
+			const float SegmentLength = (float)FVector::Dist(Points[i - 1], Points[i]);
+			const int32 NumSamples = FMath::CeilToInt(SegmentLength / 10.0f);
+			for (int32 Sample = 0; Sample <= NumSamples; ++Sample)
+			{
+				const FVector Point = FMath::Lerp(Points[i - 1], Points[i], (float)Sample / FMath::Max(NumSamples, 1));
+				if (!IsPointWalkable(Room, Point))
+				{
+					Test.AddError(FString::Printf(TEXT("%s: segment %d crosses a blocked cell at %s"), What, i, *Point.ToString()));
+					return Length;
+				}
+			}
+			Length += SegmentLength;
+		}
+		return Length;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonPathfindingRoomLegTest, "DungeonGen.Pathfinding.RoomLeg.SmoothedGridPath",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDungeonPathfindingRoomLegTest::RunTest(const FString& Parameters)
+{
+	// Open room: line of sight all the way, so smoothing leaves only the two end points
+	{
+		const FDungeonPathRoom Room = DungeonPathfindingTests::MakeRoom(FIntPoint(10, 6));
+		const FIntPoint Start(0, 0);
+		const FIntPoint Goal(9, 5);
+
+		TArray<FVector> Points;
+		if (TestTrue(TEXT("Open room: path found"), DungeonPathfinding::FindRoomLeg(Room, Start, Goal, Points)))
+		{
+			TestEqual(TEXT("Open room: straight line"), Points.Num(), 2);
+			DungeonPathfindingTests::CheckPath(*this, TEXT("Open room"), Room, Start, Goal, Points);
+		}
+	}
+
+	// Wall across the room with a single gap at the East end: the path bends through the gap
+	{
+		FDungeonPathRoom Room = DungeonPathfindingTests::MakeRoom(FIntPoint(10, 6));
+		for (int32 Y = 0; Y < 5; ++Y)
+		{
+			DungeonPathfindingTests::Block(Room, 5, Y);
+		}
+		const FIntPoint Start(1, 0);
+		const FIntPoint Goal(9, 0);
+
+		TArray<FVector> Points;
+		if (TestTrue(TEXT("Wall with gap: path found"), DungeonPathfinding::FindRoomLeg(Room, Start, Goal, Points)))
+		{
+			TestTrue(TEXT("Wall with gap: path bends"), Points.Num() > 2);
+			const float Length = DungeonPathfindingTests::CheckPath(*this, TEXT("Wall with gap"), Room, Start, Goal, Points);
+
+			// The wall's X band (500 - 600 cm) can only be crossed at Y >= 500 cm, through the gap cell
+			const FVector GapSouth(5.0f * CELL_SIZE, 5.0f * CELL_SIZE, 0.0f);
+			const FVector GapNorth(6.0f * CELL_SIZE, 5.0f * CELL_SIZE, 0.0f);
+			const float LowerBound = (float)(FVector::Dist(Points[0], GapSouth) + CELL_SIZE + FVector::Dist(GapNorth, Points.Last()));
+			TestTrue(TEXT("Wall with gap: goes around the wall"), Length >= LowerBound - 1.0f);
+		}
+	}
+
+	// Full wall: no path
+	{
+		FDungeonPathRoom Room = DungeonPathfindingTests::MakeRoom(FIntPoint(10, 6));
+		for (int32 Y = 0; Y < 6; ++Y)
+		{
+			DungeonPathfindingTests::Block(Room, 5, Y);
+		}
+
+		TArray<FVector> Points;
+		TestFalse(TEXT("Full wall: no path"), DungeonPathfinding::FindRoomLeg(Room, FIntPoint(1, 1), FIntPoint(8, 1), Points));
+	}
+
+	// Two cells touching only at a corner: diagonal steps never cut corners
+	{
+		FDungeonPathRoom Room = DungeonPathfindingTests::MakeRoom(FIntPoint(2, 2));
+		DungeonPathfindingTests::Block(Room, 1, 0);
+		DungeonPathfindingTests::Block(Room, 0, 1);
+
+		TArray<FVector> Points;
+		TestFalse(TEXT("Diagonal gap: no corner cutting"), DungeonPathfinding::FindRoomLeg(Room, FIntPoint(0, 0), FIntPoint(1, 1), Points));
+	}
+
+	// Start or goal off the walkable cells
+	{
+		FDungeonPathRoom Room = DungeonPathfindingTests::MakeRoom(FIntPoint(4, 4));
+		DungeonPathfindingTests::Block(Room, 3, 3);
+
+		TArray<FVector> Points;
+		TestFalse(TEXT("Blocked start: no path"), DungeonPathfinding::FindRoomLeg(Room, FIntPoint(3, 3), FIntPoint(0, 0), Points));
+		TestFalse(TEXT("Blocked goal: no path"), DungeonPathfinding::FindRoomLeg(Room, FIntPoint(0, 0), FIntPoint(3, 3), Points));
+		TestFalse(TEXT("Start outside the grid: no path"), DungeonPathfinding::FindRoomLeg(Room, FIntPoint(-1, 0), FIntPoint(0, 0), Points));
+	}
+
+	// Same cell: a single point
+	{
+		const FDungeonPathRoom Room = DungeonPathfindingTests::MakeRoom(FIntPoint(4, 4));
+
+		TArray<FVector> Points;
+		if (TestTrue(TEXT("Same cell: path found"), DungeonPathfinding::FindRoomLeg(Room, FIntPoint(2, 1), FIntPoint(2, 1), Points)))
+		{
+			TestEqual(TEXT("Same cell: one point"), Points.Num(), 1);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonPathfindingTransformTest, "DungeonGen.Pathfinding.RoomLeg.RoomTransform",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDungeonPathfindingTransformTest::RunTest(const FString& Parameters)
+{
+	// Points come out in world space: the room transform is applied to the cell centres
+	FDungeonPathRoom Room = DungeonPathfindingTests::MakeRoom(FIntPoint(6, 4));
+	Room.Transform = FTransform(FRotator(0.0f, 90.0f, 0.0f), FVector(1000.0f, -500.0f, 200.0f));
+
+	TArray<FVector> Points;
+	if (!TestTrue(TEXT("Path found"), DungeonPathfinding::FindRoomLeg(Room, FIntPoint(0, 0), FIntPoint(5, 3), Points)))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("Start in world space"), Points[0], Room.Transform.TransformPosition(DungeonPathfindingTests::CellCentre(FIntPoint(0, 0))));
+	TestEqual(TEXT("Goal in world space"), Points.Last(), Room.Transform.TransformPosition(DungeonPathfindingTests::CellCentre(FIntPoint(5, 3))));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
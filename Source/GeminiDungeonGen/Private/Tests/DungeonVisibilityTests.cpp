@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "DungeonGen/Visibility/DungeonVisibility.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonPortalQuadTest, "DungeonGen.Visibility.PortalQuad.CentredOnConnectionPoint",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDungeonPortalQuadTest::RunTest(const FString& Parameters)
+{
+	const float OpeningHeight = 300.0f;
+
+	// Odd and even footprints, both axes - an even footprint used to land half a cell off
+	for (int32 Footprint = 1; Footprint <= 4; ++Footprint)
+	{
+		for (const FVector& Facing : { FVector(1.0f, 0.0f, 0.0f), FVector(0.0f, -1.0f, 0.0f) })
+		{
+			FDoorConnectionPoint Point;
+			Point.WorldLocation = FVector(1250.0f, -375.0f, 40.0f);
+			Point.WorldFacing = Facing;
+			Point.Footprint = Footprint;
+
+			const FDungeonPortalQuad Quad = FDungeonPortalQuad::FromConnectionPoint(Point, FVector::UpVector, OpeningHeight);
+			const FString Context = FString::Printf(TEXT("Footprint %d, facing %s"), Footprint, *Facing.ToString());
+
+			// The opening sits on the boundary plane, centred on the connection point
+			const FVector BottomCenter = (Quad.Corners[0] + Quad.Corners[1]) * 0.5f;
+			TestTrue(Context + TEXT(": bottom edge centred on the connection point"), BottomCenter.Equals(Point.WorldLocation, KINDA_SMALL_NUMBER));
+			TestTrue(Context + TEXT(": centre above the connection point"),
+				Quad.Center.Equals(Point.WorldLocation + FVector(0.0f, 0.0f, OpeningHeight * 0.5f), KINDA_SMALL_NUMBER));
+			TestTrue(Context + TEXT(": every corner on the boundary plane"),
+				FMath::IsNearlyZero((Quad.Corners[2] - Point.WorldLocation) | Facing, KINDA_SMALL_NUMBER));
+			TestEqual(Context + TEXT(": width"), (float)FVector::Dist(Quad.Corners[0], Quad.Corners[1]), Footprint * CELL_SIZE, KINDA_SMALL_NUMBER);
+			TestTrue(Context + TEXT(": normal is the door facing"), Quad.Normal.Equals(Facing));
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "DungeonGen/Rooms/MasterRoom.h"
+#include "Engine/StaticMesh.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FloorClutterTests
+{
+	// Clutter pool of a 1x1 entry (plus a 2x1 entry in either yaw quadrant), every free cell gets an attempt
+	static void MakeClutterTables(FCompiledRoomData& Compiled, float MinSpacing, bool bMixedFootprints)
+	{
+		FCompiledMeshEntry& Small = Compiled.Clutter.Entries.AddDefaulted_GetRef();
+		Small.MeshIndex = 0;
+		Compiled.Clutter.Weights.Add(1000);
+
+		if (bMixedFootprints)
+		{
+			FCompiledMeshEntry& Long = Compiled.Clutter.Entries.AddDefaulted_GetRef();
+			Long.MeshIndex = 0;
+			Long.FootprintX = 2;
+			Long.NumQuadrants = 2;
+			Long.Quadrants[1] = 1;
+			Compiled.Clutter.Weights.Add(1000);
+		}
+
+		Compiled.ClutterPlacementChance = 1.0f;
+		Compiled.ClutterMinSpacing = MinSpacing;
+	}
+
+	// 20 x 16 floor with a carved 6 x 4 block
+	static TBitArray<> MakeFreeFloor(FIntPoint GridSize)
+	{
+		TBitArray<> Free(true, GridSize.X * GridSize.Y);
+		for (int32 Y = 5; Y < 9; ++Y)
+		{
+			for (int32 X = 8; X < 14; ++X)
+			{
+				Free[Y * GridSize.X + X] = false;
+			}
+		}
+		return Free;
+	}
+
+	static FVector2f GetCentre(const FClutterPlacement& Placement)
+	{
+		return FVector2f((Placement.Cell.X + Placement.Footprint.X * 0.5f) * CELL_SIZE, (Placement.Cell.Y + Placement.Footprint.Y * 0.5f) * CELL_SIZE);
+	}
+
+	// Every footprint lies on cells that were free and no two footprints share a cell; the claimed cells leave Free
+	static void CheckFootprints(FAutomationTestBase& Test, FIntPoint GridSize, const TBitArray<>& FreeBefore, const TBitArray<>& FreeAfter,
+		const TArray<FClutterPlacement>& Placements)
+	{
+		TBitArray<> Claimed(false, FreeBefore.Num());
+		for (const FClutterPlacement& Placement : Placements)
+		{
+			if (Placement.Cell.X < 0 || Placement.Cell.Y < 0
+				|| Placement.Cell.X + Placement.Footprint.X > GridSize.X || Placement.Cell.Y + Placement.Footprint.Y > GridSize.Y)
+			{
+				Test.AddError(FString::Printf(TEXT("Placement at %s leaves the grid"), *Placement.Cell.ToString()));
+				continue;
+			}
+
+			for (int32 Y = Placement.Cell.Y; Y < Placement.Cell.Y + Placement.Footprint.Y; ++Y)
+			{
+				for (int32 X = Placement.Cell.X; X < Placement.Cell.X + Placement.Footprint.X; ++X)
+				{
+					const int32 Index = Y * GridSize.X + X;
+					if (!FreeBefore[Index] || Claimed[Index])
+					{
+						Test.AddError(FString::Printf(TEXT("Placement at %s covers cell (%d, %d), which was not free"), *Placement.Cell.ToString(), X, Y));
+					}
+					Claimed[Index] = true;
+				}
+			}
+		}
+
+		for (int32 Index = 0; Index < FreeBefore.Num(); ++Index)
+		{
+			if (FreeAfter[Index] != (FreeBefore[Index] && !Claimed[Index]))
+			{
+				Test.AddError(FString::Printf(TEXT("Free cell %d does not match the claimed footprints"), Index));
+				return;
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFloorClutterSpacingTest, "DungeonGen.Clutter.Scatter.MinSpacing",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFloorClutterSpacingTest::RunTest(const FString& Parameters)
+{
+	UStaticMesh* Mesh = NewObject<UStaticMesh>(GetTransientPackage());
+	const FIntPoint GridSize(20, 16);
+
+	for (const float Spacing : { 150.0f, 250.0f, 420.0f })
+	{
+		for (const bool bMixedFootprints : { false, true })
+		{
+			FCompiledRoomData Compiled;
+			FloorClutterTests::MakeClutterTables(Compiled, Spacing, bMixedFootprints);
+
+			const TBitArray<> FreeBefore = FloorClutterTests::MakeFreeFloor(GridSize);
+			TBitArray<> Free = FreeBefore;
+			FRandomStream Stream(1234);
+			TArray<FClutterPlacement> Placements;
+			AMasterRoom::ScatterClutter(Compiled, GridSize, Free, [Mesh](int32) { return Mesh; }, Stream, Placements);
+
+			TestTrue(FString::Printf(TEXT("Spacing %.0f: clutter is placed"), Spacing), Placements.Num() > 0);
+			FloorClutterTests::CheckFootprints(*this, GridSize, FreeBefore, Free, Placements);
+
+			// Poisson disk: no two footprint centres closer than the spacing
+			for (int32 i = 0; i < Placements.Num(); ++i)
+			{
+				for (int32 j = i + 1; j < Placements.Num(); ++j)
+				{
+					const float Distance = FVector2f::Distance(FloorClutterTests::GetCentre(Placements[i]), FloorClutterTests::GetCentre(Placements[j]));
+					if (Distance < Spacing)
+					{
+						AddError(FString::Printf(TEXT("Spacing %.0f: placements at %s and %s are %.1f cm apart"),
+							Spacing, *Placements[i].Cell.ToString(), *Placements[j].Cell.ToString(), Distance));
+					}
+				}
+			}
+
+			// Every free cell gets a dart, so with 1x1 clutter no free cell is left that a sample could still take
+			// (a 2x1 dart that does not fit can leave its cell free)
+			if (bMixedFootprints) continue;
+
+			for (TConstSetBitIterator<> It(Free); It; ++It)
+			{
+				const FVector2f Centre((It.GetIndex() % GridSize.X + 0.5f) * CELL_SIZE, (It.GetIndex() / GridSize.X + 0.5f) * CELL_SIZE);
+				const bool bFarEnough = !Placements.ContainsByPredicate([&Centre, Spacing](const FClutterPlacement& Placement)
+				{
+					return FVector2f::Distance(FloorClutterTests::GetCentre(Placement), Centre) < Spacing;
+				});
+				if (bFarEnough)
+				{
+					AddError(FString::Printf(TEXT("Spacing %.0f: free cell %d could still take a sample"), Spacing, It.GetIndex()));
+					break;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFloorClutterFootprintTest, "DungeonGen.Clutter.Scatter.FootprintsOnly",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFloorClutterFootprintTest::RunTest(const FString& Parameters)
+{
+	UStaticMesh* Mesh = NewObject<UStaticMesh>(GetTransientPackage());
+	const FIntPoint GridSize(20, 16);
+
+	// No spacing and 1x1 clutter only: every free cell is taken
+	{
+		FCompiledRoomData Compiled;
+		FloorClutterTests::MakeClutterTables(Compiled, 0.0f, false);
+
+		const TBitArray<> FreeBefore = FloorClutterTests::MakeFreeFloor(GridSize);
+		TBitArray<> Free = FreeBefore;
+		FRandomStream Stream(99);
+		TArray<FClutterPlacement> Placements;
+		AMasterRoom::ScatterClutter(Compiled, GridSize, Free, [Mesh](int32) { return Mesh; }, Stream, Placements);
+
+		TestEqual(TEXT("One placement per free cell"), Placements.Num(), FreeBefore.CountSetBits());
+		TestEqual(TEXT("No free cell left"), Free.CountSetBits(), 0);
+		FloorClutterTests::CheckFootprints(*this, GridSize, FreeBefore, Free, Placements);
+	}
+
+	// Mixed footprints: the same seed gives the same scatter
+	{
+		FCompiledRoomData Compiled;
+		FloorClutterTests::MakeClutterTables(Compiled, 0.0f, true);
+
+		TArray<FClutterPlacement> Runs[2];
+		for (TArray<FClutterPlacement>& Placements : Runs)
+		{
+			const TBitArray<> FreeBefore = FloorClutterTests::MakeFreeFloor(GridSize);
+			TBitArray<> Free = FreeBefore;
+			FRandomStream Stream(5);
+			AMasterRoom::ScatterClutter(Compiled, GridSize, Free, [Mesh](int32) { return Mesh; }, Stream, Placements);
+			FloorClutterTests::CheckFootprints(*this, GridSize, FreeBefore, Free, Placements);
+		}
+
+		TestEqual(TEXT("Deterministic placement count"), Runs[0].Num(), Runs[1].Num());
+		for (int32 i = 0; i < FMath::Min(Runs[0].Num(), Runs[1].Num()); ++i)
+		{
+			if (Runs[0][i].Cell != Runs[1][i].Cell || Runs[0][i].Footprint != Runs[1][i].Footprint)
+			{
+				AddError(FString::Printf(TEXT("Placement %d differs between runs with the same seed"), i));
+				break;
+			}
+		}
+	}
+
+	// Entries whose mesh is missing are skipped and leave the floor free
+	{
+		FCompiledRoomData Compiled;
+		FloorClutterTests::MakeClutterTables(Compiled, 0.0f, true);
+
+		const TBitArray<> FreeBefore = FloorClutterTests::MakeFreeFloor(GridSize);
+		TBitArray<> Free = FreeBefore;
+		FRandomStream Stream(5);
+		TArray<FClutterPlacement> Placements;
+		AMasterRoom::ScatterClutter(Compiled, GridSize, Free, [](int32) { return (UStaticMesh*)nullptr; }, Stream, Placements);
+
+		TestEqual(TEXT("Nothing placed without meshes"), Placements.Num(), 0);
+		TestEqual(TEXT("Floor stays free"), Free.CountSetBits(), FreeBefore.CountSetBits());
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,203 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "DungeonGen/Rooms/MasterRoom.h"
+#include "DungeonGen/Rooms/FreeRectIndex.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace InteriorFurnitureTests
+{
+	static bool IsRectFree(FIntPoint GridSize, const TBitArray<>& Blocked, const FIntRect& Rect)
+	{
+		if (Rect.Min.X < 0 || Rect.Min.Y < 0 || Rect.Max.X > GridSize.X || Rect.Max.Y > GridSize.Y) return false;
+
+		for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+		{
+			for (int32 X = Rect.Min.X; X < Rect.Max.X; ++X)
+			{
+				if (Blocked[Y * GridSize.X + X]) return false;
+			}
+		}
+		return true;
+	}
+
+	// The index invariants against the blocked cells: every rectangle is free and maximal (grows into a blocked
+	// cell or the grid edge on every side), none contains another, and every free cell is covered
+	static void CheckFreeRects(FAutomationTestBase& Test, const FFreeRectIndex& Index, FIntPoint GridSize, const TBitArray<>& Blocked)
+	{
+		for (int32 i = 0; i < Index.Num(); ++i)
+		{
+			const FIntRect& Rect = Index.FreeRects[i];
+			if (!IsRectFree(GridSize, Blocked, Rect))
+			{
+				Test.AddError(FString::Printf(TEXT("Rect %s covers a blocked cell or leaves the grid"), *Rect.ToString()));
+				continue;
+			}
+
+			const bool bGrows = IsRectFree(GridSize, Blocked, FIntRect(Rect.Min - FIntPoint(1, 0), Rect.Max))
+				|| IsRectFree(GridSize, Blocked, FIntRect(Rect.Min - FIntPoint(0, 1), Rect.Max))
+				|| IsRectFree(GridSize, Blocked, FIntRect(Rect.Min, Rect.Max + FIntPoint(1, 0)))
+				|| IsRectFree(GridSize, Blocked, FIntRect(Rect.Min, Rect.Max + FIntPoint(0, 1)));
+			Test.TestFalse(FString::Printf(TEXT("Rect %s is maximal"), *Rect.ToString()), bGrows);
+
+			for (int32 j = 0; j < Index.Num(); ++j)
+			{
+				const FIntRect& Other = Index.FreeRects[j];
+				if (i != j && Other.Min.X <= Rect.Min.X && Other.Min.Y <= Rect.Min.Y && Other.Max.X >= Rect.Max.X && Other.Max.Y >= Rect.Max.Y)
+				{
+					Test.AddError(FString::Printf(TEXT("Rect %s is contained in %s"), *Rect.ToString(), *Other.ToString()));
+				}
+			}
+		}
+
+		for (int32 Y = 0; Y < GridSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < GridSize.X; ++X)
+			{
+				if (Blocked[Y * GridSize.X + X]) continue;
+
+				const bool bCovered = Index.FreeRects.ContainsByPredicate([X, Y](const FIntRect& Rect)
+				{
+					return X >= Rect.Min.X && X < Rect.Max.X && Y >= Rect.Min.Y && Y < Rect.Max.Y;
+				});
+				Test.TestTrue(FString::Printf(TEXT("Free cell (%d, %d) is covered"), X, Y), bCovered);
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteriorDoorPathBlockedDoorTest, "DungeonGen.Interior.DoorPath.BlockedFirstDoor",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FInteriorDoorPathBlockedDoorTest::RunTest(const FString& Parameters)
+{
+	// 6 x 4 floor; the first door's approach cell (0, 0) is not floor, two more doors sit on the far side
+	const FIntPoint GridSize(6, 4);
+	const int32 NumCells = GridSize.X * GridSize.Y;
+	auto CellIndex = [&GridSize](int32 X, int32 Y) { return Y * GridSize.X + X; };
+
+	TArray<EGridCellType> Cells;
+	Cells.Init(EGridCellType::ECT_FloorMesh, NumCells);
+	Cells[CellIndex(0, 0)] = EGridCellType::ECT_Wall;
+
+	// A floor cell walled off from the rest: (0, 3), cut off by (0, 2) and (1, 3)
+	Cells[CellIndex(0, 2)] = EGridCellType::ECT_Empty;
+	Cells[CellIndex(1, 3)] = EGridCellType::ECT_Empty;
+
+	TBitArray<> Approach(false, NumCells);
+	Approach[CellIndex(0, 0)] = true;
+	Approach[CellIndex(5, 0)] = true;
+	Approach[CellIndex(5, 3)] = true;
+	Approach[CellIndex(0, 3)] = true;
+
+	TBitArray<> Reserved;
+	TArray<int32> Unreached;
+	AMasterRoom::ReserveDoorPaths(GridSize, Cells, Approach, Reserved, Unreached);
+
+	// The path between the two reachable doors is still reserved, and it is a connected floor path
+	TestTrue(TEXT("Second door is reserved"), Reserved[CellIndex(5, 0)]);
+	TestTrue(TEXT("Third door is reserved"), Reserved[CellIndex(5, 3)]);
+	TestEqual(TEXT("Shortest path between the reachable doors"), Reserved.CountSetBits(), 4);
+	for (int32 Y = 0; Y < GridSize.Y; ++Y)
+	{
+		TestTrue(FString::Printf(TEXT("Path cell (5, %d) is reserved"), Y), Reserved[CellIndex(5, Y)]);
+	}
+
+	// The blocked door and the walled-off one are reported, not silently dropped
+	TestEqual(TEXT("Unreached approach cells"), Unreached.Num(), 2);
+	TestTrue(TEXT("Blocked first door is reported"), Unreached.Contains(CellIndex(0, 0)));
+	TestTrue(TEXT("Walled-off door is reported"), Unreached.Contains(CellIndex(0, 3)));
+	TestFalse(TEXT("Blocked door is not reserved"), Reserved[CellIndex(0, 0)]);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteriorFreeRectsBlockTest, "DungeonGen.Interior.FreeRects.BlockSplitsIntoSides",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FInteriorFreeRectsBlockTest::RunTest(const FString& Parameters)
+{
+	const FIntPoint GridSize(8, 6);
+	TBitArray<> Blocked(false, GridSize.X * GridSize.Y);
+
+	FFreeRectIndex Index;
+	Index.Init(GridSize);
+	TestEqual(TEXT("Empty grid is one rectangle"), Index.Num(), 1);
+
+	// A 2 x 2 obstacle in the middle leaves its four sides: two full-height strips, two full-width strips
+	const FIntRect Obstacle(FIntPoint(2, 2), FIntPoint(4, 4));
+	Index.Block(Obstacle);
+	for (int32 Y = Obstacle.Min.Y; Y < Obstacle.Max.Y; ++Y)
+	{
+		for (int32 X = Obstacle.Min.X; X < Obstacle.Max.X; ++X)
+		{
+			Blocked[Y * GridSize.X + X] = true;
+		}
+	}
+	TestEqual(TEXT("Obstacle splits the grid into four sides"), Index.Num(), 4);
+	InteriorFurnitureTests::CheckFreeRects(*this, Index, GridSize, Blocked);
+
+	TArray<int32> Fitting;
+	Index.FindFitting(FIntPoint(8, 2), Fitting);
+	TestEqual(TEXT("Full-width footprint fits the two strips beside the obstacle"), Fitting.Num(), 2);
+
+	Fitting.Reset();
+	Index.FindFitting(FIntPoint(3, 3), Fitting);
+	TestEqual(TEXT("3 x 3 footprint only fits the wide strip"), Fitting.Num(), 1);
+	if (Fitting.Num() == 1)
+	{
+		TestTrue(TEXT("Wide strip"), Index.FreeRects[Fitting[0]] == FIntRect(FIntPoint(4, 0), FIntPoint(8, 6)));
+	}
+
+	Fitting.Reset();
+	Index.FindFitting(FIntPoint(9, 1), Fitting);
+	TestEqual(TEXT("Footprint wider than the grid fits nowhere"), Fitting.Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteriorFreeRectsMaskTest, "DungeonGen.Interior.FreeRects.BlockMaskMatchesCells",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FInteriorFreeRectsMaskTest::RunTest(const FString& Parameters)
+{
+	// Scattered obstacles (about a quarter of the cells)
+	const FIntPoint GridSize(12, 9);
+	FRandomStream Stream(7);
+	TBitArray<> Blocked(false, GridSize.X * GridSize.Y);
+	for (int32 Cell = 0; Cell < Blocked.Num(); ++Cell)
+	{
+		Blocked[Cell] = Stream.FRand() < 0.25f;
+	}
+
+	FFreeRectIndex Index;
+	Index.Init(GridSize);
+	Index.BlockMask(GridSize, Blocked);
+	InteriorFurnitureTests::CheckFreeRects(*this, Index, GridSize, Blocked);
+
+	// A footprint fits some rectangle exactly when a free placement of it exists anywhere on the grid
+	for (int32 SizeY = 1; SizeY <= 4; ++SizeY)
+	{
+		for (int32 SizeX = 1; SizeX <= 4; ++SizeX)
+		{
+			bool bPlaceable = false;
+			for (int32 Y = 0; Y + SizeY <= GridSize.Y && !bPlaceable; ++Y)
+			{
+				for (int32 X = 0; X + SizeX <= GridSize.X && !bPlaceable; ++X)
+				{
+					bPlaceable = InteriorFurnitureTests::IsRectFree(GridSize, Blocked, FIntRect(FIntPoint(X, Y), FIntPoint(X + SizeX, Y + SizeY)));
+				}
+			}
+
+			TArray<int32> Fitting;
+			Index.FindFitting(FIntPoint(SizeX, SizeY), Fitting);
+			TestEqual(FString::Printf(TEXT("%d x %d footprint fits"), SizeX, SizeY), Fitting.Num() > 0, bPlaceable);
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
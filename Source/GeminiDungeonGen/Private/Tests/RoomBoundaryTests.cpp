@@ -0,0 +1,189 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "DungeonGen/Rooms/RoomBoundary.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace RoomBoundaryTests
+{
+	static bool IsFloor(FIntPoint GridSize, const TBitArray<>& FloorMask, FIntPoint Cell)
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < GridSize.X && Cell.Y < GridSize.Y && FloorMask[Cell.Y * GridSize.X + Cell.X];
+	}
+
+	// Floor cell a wall cell of a run faces back into
+	static FIntPoint GetFloorCell(EWallEdge Edge, FIntPoint WallCell)
+	{
+		switch (Edge)
+		{
+			case EWallEdge::North: return WallCell - FIntPoint(1, 0);
+			case EWallEdge::South: return WallCell + FIntPoint(1, 0);
+			case EWallEdge::East:  return WallCell - FIntPoint(0, 1);
+			default:               return WallCell + FIntPoint(0, 1);
+		}
+	}
+
+	// Every run cell is a void cell facing floor, runs come grouped by edge, and the runs cover the whole
+	// perimeter exactly once (total length = number of floor sides facing a void)
+	static void CheckRuns(FAutomationTestBase& Test, FIntPoint GridSize, const TBitArray<>& FloorMask, const FRoomBoundary& Boundary)
+	{
+		int32 RunCells = 0;
+		for (int32 i = 0; i < Boundary.Runs.Num(); ++i)
+		{
+			const FRoomBoundaryRun& Run = Boundary.Runs[i];
+			if (i > 0 && (uint8)Run.Edge < (uint8)Boundary.Runs[i - 1].Edge)
+			{
+				Test.AddError(FString::Printf(TEXT("Run %d is out of edge order"), i));
+			}
+
+			for (int32 Along = Run.Start; Along < Run.Start + Run.Length; ++Along)
+			{
+				const FIntPoint WallCell = FRoomBoundary::GetWallCell(Run.Edge, Run.Line, Along);
+				if (IsFloor(GridSize, FloorMask, WallCell) || !IsFloor(GridSize, FloorMask, GetFloorCell(Run.Edge, WallCell)))
+				{
+					Test.AddError(FString::Printf(TEXT("Run %d cell %s does not separate floor from void"), i, *WallCell.ToString()));
+				}
+				++RunCells;
+			}
+		}
+
+		int32 VoidSides = 0;
+		for (int32 Y = 0; Y < GridSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < GridSize.X; ++X)
+			{
+				if (!IsFloor(GridSize, FloorMask, FIntPoint(X, Y))) continue;
+
+				VoidSides += !IsFloor(GridSize, FloorMask, FIntPoint(X + 1, Y)) + !IsFloor(GridSize, FloorMask, FIntPoint(X - 1, Y))
+					+ !IsFloor(GridSize, FloorMask, FIntPoint(X, Y + 1)) + !IsFloor(GridSize, FloorMask, FIntPoint(X, Y - 1));
+			}
+		}
+		Test.TestEqual(TEXT("Runs cover the perimeter once"), RunCells, VoidSides);
+	}
+
+	static const FRoomBoundaryCorner* FindCorner(const FRoomBoundary& Boundary, FIntPoint Vertex)
+	{
+		return Boundary.Corners.FindByPredicate([&Vertex](const FRoomBoundaryCorner& Corner) { return Corner.Vertex == Vertex; });
+	}
+
+	// Exactly one corner at a vertex, with the expected piece quadrant and kind
+	static void ExpectCorner(FAutomationTestBase& Test, const FRoomBoundary& Boundary, FIntPoint Vertex, ERoomCornerQuadrant Quadrant, bool bInner)
+	{
+		const FRoomBoundaryCorner* Corner = FindCorner(Boundary, Vertex);
+		if (!Corner)
+		{
+			Test.AddError(FString::Printf(TEXT("No corner at %s"), *Vertex.ToString()));
+			return;
+		}
+		Test.TestEqual(FString::Printf(TEXT("Corner quadrant at %s"), *Vertex.ToString()), (uint8)Corner->Quadrant, (uint8)Quadrant);
+		Test.TestTrue(FString::Printf(TEXT("Corner kind at %s"), *Vertex.ToString()), Corner->bInner == bInner);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRoomBoundaryRectangleTest, "DungeonGen.RoomBoundary.Trace.Rectangle",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRoomBoundaryRectangleTest::RunTest(const FString& Parameters)
+{
+	const FIntPoint GridSize(6, 4);
+	const TBitArray<> FloorMask(true, GridSize.X * GridSize.Y);
+
+	FRoomBoundary Boundary;
+	Boundary.Trace(GridSize, FloorMask);
+
+	// One run per outer edge, on the outer line
+	if (!TestEqual(TEXT("Four runs"), Boundary.Runs.Num(), 4))
+	{
+		return false;
+	}
+	for (const EWallEdge Edge : { EWallEdge::North, EWallEdge::South, EWallEdge::East, EWallEdge::West })
+	{
+		const FRoomBoundaryRun& Run = Boundary.Runs[(uint8)Edge];
+		const FString Context = FString::Printf(TEXT("Edge %d"), (uint8)Edge);
+		TestEqual(Context + TEXT(": edge"), (uint8)Run.Edge, (uint8)Edge);
+		TestEqual(Context + TEXT(": outer line"), Run.Line, FRoomBoundary::GetOuterLine(Edge, GridSize));
+		TestEqual(Context + TEXT(": starts at the first cell"), Run.Start, 0);
+		TestEqual(Context + TEXT(": full edge length"), Run.Length, FRoomBoundary::GetEdgeLength(Edge, GridSize));
+	}
+	RoomBoundaryTests::CheckRuns(*this, GridSize, FloorMask, Boundary);
+
+	// Four convex corners, each piece diagonal to the room
+	TestEqual(TEXT("Four corners"), Boundary.Corners.Num(), 4);
+	RoomBoundaryTests::ExpectCorner(*this, Boundary, FIntPoint(0, 0), ERoomCornerQuadrant::SouthWest, false);
+	RoomBoundaryTests::ExpectCorner(*this, Boundary, FIntPoint(0, GridSize.Y), ERoomCornerQuadrant::SouthEast, false);
+	RoomBoundaryTests::ExpectCorner(*this, Boundary, FIntPoint(GridSize.X, GridSize.Y), ERoomCornerQuadrant::NorthEast, false);
+	RoomBoundaryTests::ExpectCorner(*this, Boundary, FIntPoint(GridSize.X, 0), ERoomCornerQuadrant::NorthWest, false);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRoomBoundaryCarvedTest, "DungeonGen.RoomBoundary.Trace.CarvedShapes",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRoomBoundaryCarvedTest::RunTest(const FString& Parameters)
+{
+	// L shape: 4 x 4 with the North-East 2 x 2 quarter carved
+	{
+		const FIntPoint GridSize(4, 4);
+		TBitArray<> FloorMask(true, GridSize.X * GridSize.Y);
+		for (int32 Y = 2; Y < 4; ++Y)
+		{
+			for (int32 X = 2; X < 4; ++X)
+			{
+				FloorMask[Y * GridSize.X + X] = false;
+			}
+		}
+
+		FRoomBoundary Boundary;
+		Boundary.Trace(GridSize, FloorMask);
+
+		// North and East are split by the notch, South and West stay whole
+		TestEqual(TEXT("L shape: six runs"), Boundary.Runs.Num(), 6);
+		RoomBoundaryTests::CheckRuns(*this, GridSize, FloorMask, Boundary);
+
+		TestEqual(TEXT("L shape: six corners"), Boundary.Corners.Num(), 6);
+		RoomBoundaryTests::ExpectCorner(*this, Boundary, FIntPoint(2, 2), ERoomCornerQuadrant::NorthEast, true);
+		RoomBoundaryTests::ExpectCorner(*this, Boundary, FIntPoint(2, 4), ERoomCornerQuadrant::NorthEast, false);
+		RoomBoundaryTests::ExpectCorner(*this, Boundary, FIntPoint(4, 2), ERoomCornerQuadrant::NorthEast, false);
+		RoomBoundaryTests::ExpectCorner(*this, Boundary, FIntPoint(0, 0), ERoomCornerQuadrant::SouthWest, false);
+	}
+
+	// Two floor cells touching only diagonally: the shared vertex is a saddle with a convex piece in each void quadrant
+	{
+		const FIntPoint GridSize(2, 2);
+		TBitArray<> FloorMask(false, GridSize.X * GridSize.Y);
+		FloorMask[0] = true;
+		FloorMask[3] = true;
+
+		FRoomBoundary Boundary;
+		Boundary.Trace(GridSize, FloorMask);
+		RoomBoundaryTests::CheckRuns(*this, GridSize, FloorMask, Boundary);
+
+		int32 SaddleCorners = 0;
+		for (const FRoomBoundaryCorner& Corner : Boundary.Corners)
+		{
+			if (Corner.Vertex == FIntPoint(1, 1))
+			{
+				TestFalse(TEXT("Saddle corners are convex"), Corner.bInner);
+				TestTrue(TEXT("Saddle corner sits in a void quadrant"),
+					Corner.Quadrant == ERoomCornerQuadrant::SouthEast || Corner.Quadrant == ERoomCornerQuadrant::NorthWest);
+				++SaddleCorners;
+			}
+		}
+		TestEqual(TEXT("Two saddle corners"), SaddleCorners, 2);
+	}
+
+	// Malformed input leaves the boundary empty
+	{
+		FRoomBoundary Boundary;
+		Boundary.Trace(FIntPoint(3, 3), TBitArray<>(true, 4));
+		TestEqual(TEXT("Mask of the wrong size: no runs"), Boundary.Runs.Num(), 0);
+		TestEqual(TEXT("Mask of the wrong size: no corners"), Boundary.Corners.Num(), 0);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "DungeonGen/Rooms/RoomLayout.h"
+#include "Engine/StaticMesh.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace RoomLayoutTests
+{
+	// Cover every cell of the grid with one 1x1 placement on a layer
+	static void FillLayer(FRoomLayout& Layout, UStaticMesh* Mesh, ERoomLayoutLayer Layer)
+	{
+		for (int32 Y = 0; Y < Layout.GridSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < Layout.GridSize.X; ++X)
+			{
+				Layout.AddPlacement(Mesh, FIntPoint(X, Y), FIntPoint(1, 1), 0.0f, Layer);
+			}
+		}
+	}
+
+	// Encode, decode into a fresh layout and compare the placements
+	static bool RoundTrip(FAutomationTestBase& Test, const FRoomLayout& Layout)
+	{
+		TArray<uint8> Bytes;
+		Layout.Encode(Bytes);
+
+		FRoomLayout Decoded;
+		if (!Test.TestTrue(TEXT("Layout decodes"), Decoded.Decode(Bytes)))
+		{
+			return false;
+		}
+
+		Test.TestEqual(TEXT("Grid size"), Decoded.GridSize, Layout.GridSize);
+		Test.TestEqual(TEXT("Placement count"), Decoded.Placements.Num(), Layout.Placements.Num());
+		for (int32 i = 0; i < FMath::Min(Decoded.Placements.Num(), Layout.Placements.Num()); ++i)
+		{
+			if (Decoded.Placements[i].Layer != Layout.Placements[i].Layer)
+			{
+				Test.AddError(FString::Printf(TEXT("Placement %d changed layer"), i));
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// A small valid room: floor everywhere, one wall and one door on the North edge
+	static void MakeValidLayout(FRoomLayout& Layout, UStaticMesh* Mesh)
+	{
+		Layout.Reset(FIntPoint(8, 6), 42);
+		FillLayer(Layout, Mesh, ERoomLayoutLayer::Floor);
+		Layout.AddWall(EWallEdge::North, Layout.GridSize.X, 0, 0, false);
+		Layout.AddDoor(EWallEdge::North, 2, ERoomLayoutDoorSource::DoorStyle, 0);
+		Layout.CellStates.Init(EGridCellType::ECT_FloorMesh, Layout.GridSize.X * Layout.GridSize.Y);
+	}
+
+	// The layout must encode but fail to decode
+	static void ExpectRejected(FAutomationTestBase& Test, const TCHAR* What, const FRoomLayout& Layout)
+	{
+		TArray<uint8> Bytes;
+		Layout.Encode(Bytes);
+
+		FRoomLayout Decoded;
+		Test.TestFalse(What, Decoded.Decode(Bytes));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRoomLayoutClutterRoundTripTest, "DungeonGen.RoomLayout.RoundTrip.FloorClutterCeiling",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRoomLayoutClutterRoundTripTest::RunTest(const FString& Parameters)
+{
+	UStaticMesh* Mesh = NewObject<UStaticMesh>(GetTransientPackage());
+
+	// A full room: floor, clutter on every cell and a full ceiling (3 placements per cell)
+	FRoomLayout Layout;
+	Layout.Reset(FIntPoint(16, 12), 1234);
+	RoomLayoutTests::FillLayer(Layout, Mesh, ERoomLayoutLayer::Floor);
+	RoomLayoutTests::FillLayer(Layout, Mesh, ERoomLayoutLayer::Clutter);
+	RoomLayoutTests::FillLayer(Layout, Mesh, ERoomLayoutLayer::Ceiling);
+	Layout.CellStates.Init(EGridCellType::ECT_FloorMesh, Layout.GridSize.X * Layout.GridSize.Y);
+
+	return RoomLayoutTests::RoundTrip(*this, Layout);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRoomLayoutFurnitureRoundTripTest, "DungeonGen.RoomLayout.RoundTrip.FurnishedRoom",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRoomLayoutFurnitureRoundTripTest::RunTest(const FString& Parameters)
+{
+	UStaticMesh* Mesh = NewObject<UStaticMesh>(GetTransientPackage());
+
+	// Packed furniture sits on floor tiles - a furnished room with a ceiling goes past 2 placements per cell even without clutter
+	FRoomLayout Layout;
+	Layout.Reset(FIntPoint(16, 12), 1234);
+	RoomLayoutTests::FillLayer(Layout, Mesh, ERoomLayoutLayer::Floor);
+	RoomLayoutTests::FillLayer(Layout, Mesh, ERoomLayoutLayer::Interior);
+	RoomLayoutTests::FillLayer(Layout, Mesh, ERoomLayoutLayer::Ceiling);
+	Layout.CellStates.Init(EGridCellType::ECT_Interior, Layout.GridSize.X * Layout.GridSize.Y);
+	if (!RoomLayoutTests::RoundTrip(*this, Layout))
+	{
+		return false;
+	}
+
+	// Every layer on every cell is the largest valid layout
+	RoomLayoutTests::FillLayer(Layout, Mesh, ERoomLayoutLayer::Clutter);
+	return RoomLayoutTests::RoundTrip(*this, Layout);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRoomLayoutRejectTest, "DungeonGen.RoomLayout.Decode.RejectsCorruptData",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRoomLayoutRejectTest::RunTest(const FString& Parameters)
+{
+	AddExpectedError(TEXT("RoomLayout: Rejecting layout data"), EAutomationExpectedErrorFlags::Contains, 0);
+
+	UStaticMesh* Mesh = NewObject<UStaticMesh>(GetTransientPackage());
+	FRoomLayout Valid;
+	RoomLayoutTests::MakeValidLayout(Valid, Mesh);
+	if (!RoomLayoutTests::RoundTrip(*this, Valid))
+	{
+		return false;
+	}
+
+	// Header claiming a huge grid and billions of placements in a 20-byte blob
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		uint32 Magic = FRoomLayout::Magic;
+		uint16 Version = FRoomLayout::Version;
+		uint16 Size = MAX_uint16;
+		int32 Seed = 0;
+		uint16 NumMeshes = 0;
+		int32 NumPlacements = MAX_int32;
+		Writer << Magic << Version << Size << Size << Seed << NumMeshes << NumPlacements;
+
+		FRoomLayout Decoded;
+		TestFalse(TEXT("Oversized grid is rejected"), Decoded.Decode(Bytes));
+	}
+
+	// Same, inside the grid cap: the placement count must fit in the remaining bytes
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		uint32 Magic = FRoomLayout::Magic;
+		uint16 Version = FRoomLayout::Version;
+		uint16 Size = (uint16)FRoomLayout::MaxGridSize;
+		int32 Seed = 0;
+		uint16 NumMeshes = 0;
+		int32 NumPlacements = FRoomLayout::MaxGridSize * FRoomLayout::MaxGridSize;
+		Writer << Magic << Version << Size << Size << Seed << NumMeshes << NumPlacements;
+
+		FRoomLayout Decoded;
+		TestFalse(TEXT("Placement count past the end of the data is rejected"), Decoded.Decode(Bytes));
+	}
+
+	// Truncated valid data
+	{
+		TArray<uint8> Bytes;
+		Valid.Encode(Bytes);
+		Bytes.SetNum(Bytes.Num() - 1);
+
+		FRoomLayout Decoded;
+		TestFalse(TEXT("Truncated data is rejected"), Decoded.Decode(Bytes));
+	}
+
+	// Unknown cell state
+	{
+		FRoomLayout Layout = Valid;
+		Layout.CellStates[3] = (EGridCellType)9;
+		RoomLayoutTests::ExpectRejected(*this, TEXT("Cell state above ECT_Interior is rejected"), Layout);
+	}
+
+	// Placement footprint leaving the grid
+	{
+		FRoomLayout Layout = Valid;
+		Layout.AddPlacement(Mesh, FIntPoint(Layout.GridSize.X - 1, 0), FIntPoint(2, 1), 0.0f, ERoomLayoutLayer::Interior);
+		RoomLayoutTests::ExpectRejected(*this, TEXT("Placement leaving the grid is rejected"), Layout);
+	}
+
+	// Walls off their line or past their edge
+	{
+		FRoomLayout Layout = Valid;
+		Layout.AddWall(EWallEdge::North, Layout.GridSize.X + 1, 0, 0, false);
+		RoomLayoutTests::ExpectRejected(*this, TEXT("Wall beyond the outer line is rejected"), Layout);
+	}
+	{
+		FRoomLayout Layout = Valid;
+		Layout.AddWall(EWallEdge::East, Layout.GridSize.Y, Layout.GridSize.X, 0, false);
+		RoomLayoutTests::ExpectRejected(*this, TEXT("Wall past the edge length is rejected"), Layout);
+	}
+
+	// Door past its edge
+	{
+		FRoomLayout Layout = Valid;
+		Layout.AddDoor(EWallEdge::West, Layout.GridSize.X, ERoomLayoutDoorSource::DoorStyle, 0);
+		RoomLayoutTests::ExpectRejected(*this, TEXT("Door past the edge length is rejected"), Layout);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
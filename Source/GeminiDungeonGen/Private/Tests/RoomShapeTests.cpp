@@ -0,0 +1,208 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "Data/Room/RoomShapePreset.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace RoomShapeTests
+{
+	// Row strings, South (X = 0) first within a row: '.' = carved, '#' = kept
+	static FString RowToString(const FRoomShapeMask& Mask, int32 Y)
+	{
+		FString Row;
+		for (int32 X = 0; X < Mask.GridSize.X; ++X)
+		{
+			Row.AppendChar(Mask.Contains(X, Y) ? TEXT('.') : TEXT('#'));
+		}
+		return Row;
+	}
+
+	static void ExpectRows(FAutomationTestBase& Test, const TCHAR* What, const FRoomShapeMask& Mask, const TArray<const TCHAR*>& Rows)
+	{
+		if (!Test.TestEqual(FString::Printf(TEXT("%s: row count"), What), Mask.GridSize.Y, Rows.Num())) return;
+
+		for (int32 Y = 0; Y < Rows.Num(); ++Y)
+		{
+			Test.TestEqual(FString::Printf(TEXT("%s: row %d"), What, Y), RowToString(Mask, Y), FString(Rows[Y]));
+		}
+	}
+
+	// Every row keeps one contiguous span of cells (or none), as a convex shape must
+	static void CheckConvexRows(FAutomationTestBase& Test, const TCHAR* What, const FRoomShapeMask& Mask)
+	{
+		for (int32 Y = 0; Y < Mask.GridSize.Y; ++Y)
+		{
+			int32 NumSpans = 0;
+			for (int32 X = 0; X < Mask.GridSize.X; ++X)
+			{
+				NumSpans += !Mask.Contains(X, Y) && (X == 0 || Mask.Contains(X - 1, Y));
+			}
+			Test.TestTrue(FString::Printf(TEXT("%s: row %d is one span"), What, Y), NumSpans <= 1);
+		}
+	}
+
+	// The mask is unchanged by mirroring X (South <-> North) and / or Y (West <-> East)
+	static void CheckSymmetry(FAutomationTestBase& Test, const TCHAR* What, const FRoomShapeMask& Mask, bool bMirrorX, bool bMirrorY)
+	{
+		for (int32 Y = 0; Y < Mask.GridSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < Mask.GridSize.X; ++X)
+			{
+				const int32 MirrorX = bMirrorX ? Mask.GridSize.X - 1 - X : X;
+				const int32 MirrorY = bMirrorY ? Mask.GridSize.Y - 1 - Y : Y;
+				if (Mask.Contains(X, Y) != Mask.Contains(MirrorX, MirrorY))
+				{
+					Test.AddError(FString::Printf(TEXT("%s: cell (%d, %d) breaks the symmetry"), What, X, Y));
+					return;
+				}
+			}
+		}
+	}
+
+	static URoomShapePreset* MakePreset(ERoomShapeType ShapeType)
+	{
+		URoomShapePreset* Preset = NewObject<URoomShapePreset>(GetTransientPackage());
+		Preset->ShapeType = ShapeType;
+		return Preset;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRoomShapeMaskRegionTest, "DungeonGen.RoomShape.Mask.RegionsAndCells",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRoomShapeMaskRegionTest::RunTest(const FString& Parameters)
+{
+	const FIntPoint GridSize(6, 5);
+
+	// Region with its corners swapped and partly outside the grid
+	FRoomShapeMask Mask;
+	Mask.Init(GridSize);
+	FForcedEmptyRegion Region;
+	Region.StartCell = FIntPoint(7, 1);
+	Region.EndCell = FIntPoint(4, -3);
+	Mask.AddRegion(Region);
+
+	// Full rows take the contiguous range path
+	FForcedEmptyRegion FullRows;
+	FullRows.StartCell = FIntPoint(-1, 4);
+	FullRows.EndCell = FIntPoint(GridSize.X, 4);
+	Mask.AddRegion(FullRows);
+
+	Mask.AddCell(FIntPoint(0, 2));
+	Mask.AddCell(FIntPoint(-1, 2));
+	Mask.AddCell(FIntPoint(GridSize.X, 0));
+	Mask.AddRowSpan(3, -2, 1);
+	Mask.AddRowSpan(GridSize.Y, 0, 2);
+
+	RoomShapeTests::ExpectRows(*this, TEXT("Regions"), Mask, {
+		TEXT("####.."),
+		TEXT("####.."),
+		TEXT(".#####"),
+		TEXT("..####"),
+		TEXT("......") });
+
+	TArray<FIntPoint> Cells;
+	Mask.GetCells(Cells);
+	TestEqual(TEXT("GetCells matches the set bits"), Cells.Num(), Mask.CountSetCells());
+	TestTrue(TEXT("GetCells is row-major"), Cells.Num() > 0 && Cells[0] == FIntPoint(4, 0));
+
+	// Combine is a union of same-size masks
+	FRoomShapeMask Other;
+	Other.Init(GridSize);
+	Other.AddCell(FIntPoint(2, 2));
+	Other.AddCell(FIntPoint(4, 0));
+	const int32 NumBefore = Mask.CountSetCells();
+	Mask.Combine(Other);
+	TestEqual(TEXT("Combine adds only the new cell"), Mask.CountSetCells(), NumBefore + 1);
+	TestTrue(TEXT("Combined cell is set"), Mask.Contains(2, 2));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRoomShapeAnalyticTest, "DungeonGen.RoomShape.Preset.AnalyticShapes",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRoomShapeAnalyticTest::RunTest(const FString& Parameters)
+{
+	// Small grids, checked cell by cell (cells are kept when their centre is inside the shape)
+	const FIntPoint Small(5, 5);
+
+	const FRoomShapeMask& Diamond = RoomShapeTests::MakePreset(ERoomShapeType::Diamond)->GetShapeMask(Small);
+	RoomShapeTests::ExpectRows(*this, TEXT("Diamond 5x5"), Diamond, {
+		TEXT("..#.."),
+		TEXT(".###."),
+		TEXT("#####"),
+		TEXT(".###."),
+		TEXT("..#..") });
+
+	// Base along the South edge (X = 0), apex at the middle of the North edge
+	const FRoomShapeMask& Triangle = RoomShapeTests::MakePreset(ERoomShapeType::Triangle)->GetShapeMask(Small);
+	RoomShapeTests::ExpectRows(*this, TEXT("Triangle 5x5"), Triangle, {
+		TEXT("#...."),
+		TEXT("###.."),
+		TEXT("#####"),
+		TEXT("###.."),
+		TEXT("#....") });
+
+	// Larger and non-square grids: convex rows and the symmetry of each shape
+	for (const FIntPoint GridSize : { FIntPoint(16, 16), FIntPoint(21, 13), FIntPoint(10, 24) })
+	{
+		for (const ERoomShapeType ShapeType : { ERoomShapeType::Triangle, ERoomShapeType::Diamond, ERoomShapeType::Hexagon, ERoomShapeType::Octagon })
+		{
+			const FString What = FString::Printf(TEXT("Shape %d on %s"), (int32)ShapeType, *GridSize.ToString());
+			const FRoomShapeMask& Mask = RoomShapeTests::MakePreset(ShapeType)->GetShapeMask(GridSize);
+
+			TestTrue(What + TEXT(": mask size"), Mask.GridSize == GridSize);
+			TestFalse(What + TEXT(": room centre is kept"), Mask.Contains(GridSize.X / 2, GridSize.Y / 2));
+			TestTrue(What + TEXT(": carves something"), Mask.CountSetCells() > 0);
+			RoomShapeTests::CheckConvexRows(*this, *What, Mask);
+			RoomShapeTests::CheckSymmetry(*this, *What, Mask, ShapeType != ERoomShapeType::Triangle, true);
+		}
+	}
+
+	// Octagon: the four corners are cut, the edge midpoints are kept
+	const FIntPoint OctagonSize(12, 12);
+	const FRoomShapeMask& Octagon = RoomShapeTests::MakePreset(ERoomShapeType::Octagon)->GetShapeMask(OctagonSize);
+	TestTrue(TEXT("Octagon: corner cut"), Octagon.Contains(0, 0) && Octagon.Contains(11, 0) && Octagon.Contains(0, 11) && Octagon.Contains(11, 11));
+	TestFalse(TEXT("Octagon: South edge midpoint kept"), Octagon.Contains(0, 6));
+	TestFalse(TEXT("Octagon: East edge midpoint kept"), Octagon.Contains(6, 11));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRoomShapePresetCacheTest, "DungeonGen.RoomShape.Preset.RegionsAndCache",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRoomShapePresetCacheTest::RunTest(const FString& Parameters)
+{
+	// L shape: one region, plus a single cell carved on top
+	URoomShapePreset* Preset = RoomShapeTests::MakePreset(ERoomShapeType::L_Shape);
+	FForcedEmptyRegion& Region = Preset->EmptyRegions.AddDefaulted_GetRef();
+	Region.StartCell = FIntPoint(2, 2);
+	Region.EndCell = FIntPoint(3, 3);
+	Preset->EmptyCells.Add(FIntPoint(0, 0));
+
+	const FRoomShapeMask& Mask = Preset->GetShapeMask(FIntPoint(4, 4));
+	RoomShapeTests::ExpectRows(*this, TEXT("L shape"), Mask, {
+		TEXT(".###"),
+		TEXT("####"),
+		TEXT("##.."),
+		TEXT("##..") });
+
+	// Built once per grid size
+	TestTrue(TEXT("Same size returns the cached mask"), &Preset->GetShapeMask(FIntPoint(4, 4)) == &Mask);
+	TestTrue(TEXT("Other size gets its own mask"), Preset->GetShapeMask(FIntPoint(6, 6)).GridSize == FIntPoint(6, 6));
+
+	// Turning bAnalyticShape off leaves only the regions (none here) once the cache is dropped
+	URoomShapePreset* Diamond = RoomShapeTests::MakePreset(ERoomShapeType::Diamond);
+	TestTrue(TEXT("Analytic diamond carves cells"), Diamond->GetShapeMask(FIntPoint(5, 5)).CountSetCells() > 0);
+	Diamond->bAnalyticShape = false;
+	Diamond->InvalidateShapeMasks();
+	TestEqual(TEXT("Diamond without analytic shape carves nothing"), Diamond->GetShapeMask(FIntPoint(5, 5)).CountSetCells(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -24,7 +24,8 @@ enum class EGridCellType : uint8
 	ECT_Empty 		UMETA(DisplayName = "Empty"),
 	ECT_FloorMesh 	UMETA(DisplayName = "Floor Mesh"),
 	ECT_Wall 		UMETA(DisplayName = "Wall Boundary"),
-	ECT_Doorway 	UMETA(DisplayName = "Doorway Slot")
+	ECT_Doorway 	UMETA(DisplayName = "Doorway Slot"),
+	ECT_Interior 	UMETA(DisplayName = "Interior Mesh")	// Designer-forced interior mesh (blocks pathfinding)
 };
 
 // Defines the four edges of a room for wall placement
@@ -61,6 +62,11 @@ struct FMeshPlacementInfo
 	// If the mesh is non-square, define allowed rotations (e.g., 0 and 90)
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Info")
 	TArray<int32> AllowedRotations = {0}; 
+
+	// Per-instance custom data written to every instance of this entry (PerInstanceCustomData[0..N) in the material)
+	// Entries that share MeshAsset but differ here are variants of one mesh (tint, wear, ...) and share a single HISM
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mesh Info")
+	TArray<float> CustomData;
 };
 
 // --- Wall Module Info ---
@@ -94,6 +100,11 @@ struct FWallModule
 	// Placement weight (NEW: Clamped between 0.0 and 10.0)
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wall Info", meta=(ClampMin="0.0", ClampMax="10.0", UIMin="0.0", UIMax="10.0"))
 	float PlacementWeight = 1.0f;
+
+	// Per-instance custom data written to every layer of this module (base, middle and top instances)
+	// Modules that reuse the same meshes with different values are variants and share the meshes' HISMs
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wall Info")
+	TArray<float> CustomData;
 };
 
 // --- Forced Wall Placement (Designer Override System) ---
@@ -186,4 +197,59 @@ struct FFixedDoorLocation
 	// If left at zero, no additional offset is applied (beyond base wall alignment)
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Door Placement")
 	FDoorPositionOffsets DoorPositionOffsets;
-};
\ No newline at end of file
+};
+// --- Sealed Door Slot (DungeonManager Connection System) ---
+
+// Identifies a door slot that the DungeonManager sealed because it had no partner door
+// Sealed doors are skipped during generation, so the wall filler closes the gap
+USTRUCT(BlueprintType)
+struct FSealedDoorSlot
+{
+	GENERATED_BODY()
+
+	// Which wall edge the sealed door was on
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Door Placement")
+	EWallEdge WallEdge = EWallEdge::North;
+
+	// Starting cell of the sealed door along the wall edge
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Door Placement")
+	int32 StartCell = 0;
+};
+
+// --- Door Connection Point (DungeonManager Connection System) ---
+
+// World-space connection point published by a MasterRoom for every placed door
+// The DungeonManager pairs facing connection points across adjacent rooms
+USTRUCT(BlueprintType)
+struct FDoorConnectionPoint
+{
+	GENERATED_BODY()
+
+	// Center of the door opening on the room boundary plane (floor level, world space)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Connection")
+	FVector WorldLocation = FVector::ZeroVector;
+
+	// Outward direction of the door (pointing away from the owning room, world space)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Connection")
+	FVector WorldFacing = FVector::ForwardVector;
+
+	// Which wall edge the door sits on
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Connection")
+	EWallEdge WallEdge = EWallEdge::North;
+
+	// Starting cell of the door along the wall edge
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Connection")
+	int32 StartCell = 0;
+
+	// Width of the door opening in cells
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Connection")
+	int32 Footprint = 1;
+
+	// Connection box half-extent copied from the door's DoorData (X = along facing, Y = across, Z = up)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Connection")
+	FVector ConnectionBoxExtent = FVector(50.0f, 50.0f, 200.0f);
+
+	// Door asset that produced this connection point
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Connection")
+	UDoorData* DoorData = nullptr;
+};
@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/BinarySearch.h"
+#include "Data/Grid/GridData.h"
+
+class URoomData;
+class UStaticMesh;
+class UDoorData;
+struct FCeilingTile;
+
+// Integer weight table: cumulative weights over a pool, sampled with one RandRange and a binary search
+struct FCompiledWeightTable
+{
+	// Running sum of the entry weights (Cumulative[i] = weight of entries 0..i)
+	TArray<uint32> Cumulative;
+
+	int32 Num() const { return Cumulative.Num(); }
+	uint32 GetTotal() const { return Cumulative.Num() > 0 ? Cumulative.Last() : 0; }
+
+	// Append an entry (weights are pre-scaled integers, see FCompiledRoomData::WeightScale)
+	void Add(uint32 Weight) { Cumulative.Add(GetTotal() + Weight); }
+
+	// Pick an entry among the first NumEntries (all entries if INDEX_NONE). Returns INDEX_NONE if the range is empty.
+	int32 Select(FRandomStream& Stream, int32 NumEntries = INDEX_NONE) const;
+};
+
+// Grid-aligned pool entry (floor tile, clutter or interior mesh) with its rotations resolved
+struct FCompiledMeshEntry
+{
+	uint16 MeshIndex = 0;		// Into FCompiledRoomData::Meshes
+	uint8 FootprintX = 1;		// Unrotated footprint in cells
+	uint8 FootprintY = 1;
+	uint8 NumQuadrants = 1;		// Allowed yaw quadrants (Quadrants[0, NumQuadrants))
+	uint8 Quadrants[4] = { 0, 0, 0, 0 };
+	TArray<float> CustomData;
+
+	FIntPoint GetRotatedFootprint(uint8 Quadrant) const
+	{
+		return (Quadrant & 1) ? FIntPoint(FootprintY, FootprintX) : FIntPoint(FootprintX, FootprintY);
+	}
+};
+
+// Weighted pool of grid-aligned entries
+struct FCompiledMeshPool
+{
+	TArray<FCompiledMeshEntry> Entries;
+	FCompiledWeightTable Weights;
+
+	const FCompiledMeshEntry* Select(FRandomStream& Stream) const
+	{
+		const int32 Index = Weights.Select(Stream);
+		return Index != INDEX_NONE ? &Entries[Index] : nullptr;
+	}
+};
+
+// Weighted pool of ceiling tiles (mesh index only - size is fixed per pool)
+struct FCompiledTilePool
+{
+	TArray<uint16> MeshIndices;
+	FCompiledWeightTable Weights;
+};
+
+// Wall module stack (mesh indices, INDEX_NONE = layer not used). A module without a BaseMesh was rejected by the compiler.
+struct FCompiledWallModuleData
+{
+	int32 BaseMesh = INDEX_NONE;
+	int32 Middle1Mesh = INDEX_NONE;
+	int32 Middle2Mesh = INDEX_NONE;		// Only stacked when Middle1Mesh exists
+	int32 TopMesh = INDEX_NONE;
+	uint8 Footprint = 1;
+	TArray<float> CustomData;
+};
+
+// Door frame of one door candidate: frame mesh, doorway actor class and connection box
+struct FCompiledDoorFrameData
+{
+	int32 FrameMesh = INDEX_NONE;
+	FRotator RotationOffset = FRotator::ZeroRotator;
+	FVector ConnectionBoxExtent = FVector::ZeroVector;
+	FSoftClassPath DoorwayClass;
+	FSoftObjectPath DoorData;			// Identity of the door (connection points, replicated overrides)
+};
+
+// A door frame with its assets loaded - from the compiled tables, or from a designer-placed door's own asset
+struct GEMINIDUNGEONGEN_API FCompiledDoorFrame
+{
+	UStaticMesh* FrameMesh = nullptr;
+	UClass* DoorwayClass = nullptr;
+	UDoorData* DoorData = nullptr;
+	int32 Footprint = 1;
+	FRotator RotationOffset = FRotator::ZeroRotator;
+	FVector ConnectionBoxExtent = FVector::ZeroVector;
+
+	// Frame of a designer-placed door (FFixedDoorLocation), which is an actor override rather than part of the room data
+	static FCompiledDoorFrame FromDoorData(UDoorData* DoorData);
+};
+
+/**
+ * Compiled Room Data - immutable runtime form of a URoomData and every style asset it references
+ *
+ * The editor-facing assets (nested FMeshPlacementInfo arrays, soft pointer chains, float weights,
+ * AllowedRotations arrays) are validated and flattened once into index and integer weight tables.
+ * The layout solver only reads these tables, so it never touches the style assets while solving.
+ *
+ * The room build reads them too: wall module stacks, door frames, the corner mesh and the wall and
+ * ceiling dimensions are all part of the tables, so a cooked room is built from the blob alone.
+ *
+ * COOKING:
+ * - URoomData::PreSave compiles the tables and stores the encoded blob on the asset
+ * - Invalid entries (empty AllowedRotations, missing meshes, zero footprints...) are reported as errors
+ *   and fail the cook; the editor leaves them out of the tables, so the solver can index everything
+ *   without bounds checks
+ * - Cooked builds decode the blob in PostLoad; the editor compiles on demand and recompiles after edits
+ * - Decoding validates every index (mesh table, wall modules, door frames), so a corrupt blob is
+ *   rejected rather than indexed
+ *
+ * ENCODING (see Serialize): magic, version, grid size, mesh table (soft paths), then each pool.
+ * Entries are compact (mesh index, footprint, quadrant list) with weights scaled by WeightScale.
+ */
+struct GEMINIDUNGEONGEN_API FCompiledRoomData
+{
+	// 'RCMP'
+	static constexpr uint32 Magic = 0x504D4352;
+
+	// Bumped whenever the encoding changes (stale blobs are rejected and recompiled in the editor)
+	static constexpr uint16 Version = 4;
+
+	// Float placement weights (0-10) are stored as integers with three decimals
+	static constexpr float WeightScale = 1000.0f;
+
+	FIntPoint GridSize = FIntPoint::ZeroValue;
+
+	// Every mesh the tables reference (entries store indices into this)
+	TArray<FSoftObjectPath> Meshes;
+
+	// --- Floor ---
+	FCompiledMeshPool FloorTiles;
+	FCompiledMeshPool Clutter;
+	float ClutterPlacementChance = 0.0f;
+	float ClutterMinSpacing = 0.0f;		// Poisson disk radius in cm (0 = footprints only)
+	float ClutterCullDistance = 0.0f;	// 0 = no limit
+	int32 FillerMeshIndex = INDEX_NONE;
+
+	// --- Interior ---
+	FCompiledMeshPool Interior;
+	float InteriorFillRatio = 0.0f;
+	int32 InteriorDoorClearance = 1;
+	int32 InteriorMaxAttempts = 0;
+
+	// --- Walls ---
+	// Index-aligned with WallData->AvailableWallModules (layout wall records refer to modules by this index)
+	TArray<FCompiledWallModuleData> WallModules;
+
+	// WallModules indices, sorted by footprint (largest first, ties keep asset order)
+	TArray<uint16> WallFillOrder;
+	TArray<uint8> WallFillFootprints;	// Index-aligned with WallFillOrder
+	float WallHeight = 0.0f;
+	float NorthWallOffset = 0.0f;		// WallData position adjustments (X for North/South, Y for East/West)
+	float SouthWallOffset = 0.0f;
+	float EastWallOffset = 0.0f;
+	float WestWallOffset = 0.0f;
+
+	// --- Corners ---
+	int32 CornerMeshIndex = INDEX_NONE;
+
+	// Per-corner offsets by the void quadrant the corner piece sits in (SW, SE, NE, NW - ERoomCornerQuadrant order)
+	FVector CornerOffsets[4] = { FVector::ZeroVector, FVector::ZeroVector, FVector::ZeroVector, FVector::ZeroVector };
+
+	// --- Doors ---
+	// DoorStyleData->DoorStylePool indices (INDEX_NONE = the door style itself in single door mode),
+	// sorted by footprint (smallest first) so the doors fitting a gap are always a prefix
+	TArray<int32> DoorPoolIndices;
+	TArray<uint8> DoorFootprints;		// Index-aligned with DoorPoolIndices
+	TArray<FCompiledDoorFrameData> DoorFrames;	// Index-aligned with DoorPoolIndices
+	FCompiledWeightTable DoorWeights;	// Cumulative over the sorted order
+
+	// --- Ceiling ---
+	FCompiledTilePool LargeCeilingTiles;	// 4x4 cells
+	FCompiledTilePool SmallCeilingTiles;	// 1x1 cell
+	float CeilingHeight = 0.0f;
+	FRotator CeilingRotation = FRotator::ZeroRotator;
+
+	// Flatten a room data asset (loads its style assets). Invalid entries are skipped and reported in OutErrors.
+	void Compile(const URoomData* RoomData, TArray<FString>& OutErrors);
+
+	void Reset();
+
+	// Symmetric binary serialization. Returns false (and sets the archive error) on bad magic/version or corrupt data.
+	bool Serialize(FArchive& Ar);
+
+	// Convenience wrappers around Serialize for byte buffers
+	void Encode(TArray<uint8>& OutBytes) const;
+	bool Decode(const TArray<uint8>& Bytes);
+
+	// Load every mesh in the table (index-aligned with Meshes, nullptr for meshes that failed to load)
+	void ResolveMeshes(TArray<UStaticMesh*>& OutMeshes) const;
+
+	// Position of a door pool index (INDEX_NONE = the door style itself) in the sorted door tables, INDEX_NONE if not compiled
+	int32 FindDoor(int32 PoolIndex) const { return DoorPoolIndices.IndexOfByKey(PoolIndex); }
+
+	// Number of doors (in sorted order) whose footprint fits in MaxFootprint cells
+	int32 GetNumDoorsFitting(int32 MaxFootprint) const
+	{
+		return Algo::UpperBound(DoorFootprints, (uint8)FMath::Clamp(MaxFootprint, 0, (int32)MAX_uint8));
+	}
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	// Transient lookup used while compiling (not serialized)
+	TMap<FSoftObjectPath, uint16> MeshLookup;
+
+	uint16 AddMesh(const FSoftObjectPath& Path);
+	int32 AddOptionalMesh(const TSoftObjectPtr<UStaticMesh>& Mesh);	// INDEX_NONE if no mesh is assigned
+	void CompileMeshPool(const TArray<FMeshPlacementInfo>& Source, const TCHAR* PoolName, FCompiledMeshPool& OutPool, TArray<FString>& OutErrors);
+	void CompileTilePool(const TArray<FCeilingTile>& Source, const TCHAR* PoolName, FCompiledTilePool& OutPool, TArray<FString>& OutErrors);
+};
@@ -30,6 +30,16 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Floor Clutter")
 	float ClutterPlacementChance = 0.25f;
 
+	// Minimum distance (cm) between clutter centres - clutter is scattered as blue noise (Poisson disk),
+	// so it never clumps. 0 = only the footprints keep clutter apart.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Floor Clutter", meta = (ClampMin = "0.0", UIMax = "1000.0"))
+	float ClutterMinSpacing = 150.0f;
+
+	// Camera distance (cm) beyond which clutter is not drawn (its own instance components, tighter than
+	// the rest of the room). 0 = same as the room.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Floor Clutter", meta = (ClampMin = "0.0"))
+	float ClutterCullDistance = 3000.0f;
+
 	// --- GAP FILLER TILE (NEW) ---
 	// A specific 1x1 mesh used to fill any remaining empty cells after the main randomized pass.
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Floor Tiles")
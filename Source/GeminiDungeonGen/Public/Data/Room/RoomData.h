@@ -5,12 +5,14 @@
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
 #include "Data/Room/WallData.h"
+#include "Data/Room/CompiledRoomData.h"
 #include "RoomData.generated.h"
 
 class UFloorData;
 class UWallData;
 class UDoorData;
 class UCeilingData;
+class UStaticMesh;
 struct FMeshPlacementInfo;
 
 UCLASS()
@@ -43,4 +45,81 @@ public:
 	// Meshes used to fill the interior of the room grid (clutter, furniture, etc.)
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Interior Meshes")
 	TArray<FMeshPlacementInfo> InteriorMeshPool;
+
+	// Fraction (0-1) of the free floor the interior pass tries to cover with InteriorMeshPool furniture
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Interior Meshes", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float InteriorFillRatio = 0.2f;
+
+	// Cells kept clear in front of every door (depth into the room), so furniture never blocks a doorway
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Interior Meshes", meta = (ClampMin = "1", ClampMax = "16"))
+	int32 InteriorDoorClearance = 2;
+
+	// Per-room budget: placement attempts before the interior pass gives up
+	// (each attempt is one weighted pick plus one scan of the free rectangle index)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Interior Meshes", meta = (ClampMin = "0", UIMax = "512"))
+	int32 MaxInteriorPlacementAttempts = 64;
+
+	// --- Compiled Runtime Data ---
+
+	// Solver and build tables for this room (decoded from the cooked blob in packaged builds, compiled from the
+	// assets above otherwise). Cached; the meshes and door frames are loaded on the first call, not while the asset loads.
+	const FCompiledRoomData& GetCompiledData();
+
+	// The same tables without loading anything they reference (wall height, offsets and footprints of unbuilt rooms)
+	const FCompiledRoomData& GetCompiledTables();
+
+	// Drop the cached tables so the next GetCompiledData recompiles (after edits to this or a style asset)
+	void InvalidateCompiledData();
+
+	// Mesh of a compiled table entry (nullptr if it failed to load). Valid after GetCompiledData.
+	UStaticMesh* GetCompiledMesh(int32 MeshIndex) const
+	{
+		return CompiledMeshes.IsValidIndex(MeshIndex) ? CompiledMeshes[MeshIndex] : nullptr;
+	}
+
+	// Loaded frame of a compiled door (DoorPoolIndices entry, INDEX_NONE = the door style itself), nullptr if the
+	// door was not compiled. Loads the door data and doorway class only - FrameMesh is set once GetCompiledData
+	// has loaded the meshes, so solving a room's doors never loads its meshes.
+	const FCompiledDoorFrame* GetCompiledDoorFrame(int32 PoolIndex);
+
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostInitProperties() override;
+	virtual void BeginDestroy() override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+
+	// Reports every entry the compiler would reject (empty AllowedRotations, missing meshes, ...)
+	virtual EDataValidationResult IsDataValid(FDataValidationContext& Context) const override;
+#endif
+
+private:
+	// Encoded FCompiledRoomData, written at cook time only (empty in editor assets)
+	UPROPERTY()
+	TArray<uint8> CompiledBlob;
+
+	FCompiledRoomData CompiledData;
+	bool bHasCompiledData = false;
+	bool bHasResolvedMeshes = false;
+	bool bHasResolvedDoorFrames = false;
+
+#if WITH_EDITOR
+	// Style assets (floor, wall, ceiling, door data) are compiled into the tables - their edits invalidate them too
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+
+	FDelegateHandle ObjectPropertyChangedHandle;
+#endif
+
+	// Loaded meshes of CompiledData.Meshes (index-aligned, keeps them alive while the room data is)
+	UPROPERTY(Transient)
+	TArray<UStaticMesh*> CompiledMeshes;
+
+	// Loaded CompiledData.DoorFrames (index-aligned); their doorway classes and door data are kept alive by CompiledDoorAssets
+	TArray<FCompiledDoorFrame> CompiledDoorFrames;
+
+	UPROPERTY(Transient)
+	TArray<UObject*> CompiledDoorAssets;
+
+	void ResolveDoorFrames();
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/Grid/GridData.h"
+
+/**
+ * Room Shape Mask - one bit per grid cell, set for cells that are forced empty (carved out)
+ *
+ * Row-major by Y like every other room grid (bit Y * GridSize.X + X). Regions are written one row
+ * at a time with ranged bit sets, and masks are combined with word-wide ORs, so building a mask
+ * costs O(rows) per region instead of O(cells^2) for an AddUnique cell list.
+ */
+struct GEMINIDUNGEONGEN_API FRoomShapeMask
+{
+	FIntPoint GridSize = FIntPoint::ZeroValue;
+	TBitArray<> Bits;
+
+	// Clear to an all-zero mask of GridSize
+	void Init(FIntPoint InGridSize);
+
+	// Set every cell of a region (any corner order, clamped to the grid)
+	void AddRegion(const FForcedEmptyRegion& Region);
+
+	// Set a single cell (ignored outside the grid)
+	void AddCell(const FIntPoint& Cell);
+
+	// Set every cell of an inclusive column span on one row (clamped to the grid)
+	void AddRowSpan(int32 Y, int32 MinX, int32 MaxX);
+
+	// OR another mask of the same size into this one
+	void Combine(const FRoomShapeMask& Other);
+
+	bool Contains(int32 X, int32 Y) const
+	{
+		return X >= 0 && Y >= 0 && X < GridSize.X && Y < GridSize.Y && Bits[Y * GridSize.X + X];
+	}
+
+	int32 CountSetCells() const { return Bits.CountSetBits(); }
+
+	// Append the coordinates of every set cell (row-major order, no duplicates)
+	void GetCells(TArray<FIntPoint>& OutCells) const;
+
+	SIZE_T GetAllocatedSize() const { return Bits.GetAllocatedSize(); }
+};
@@ -1,10 +1,11 @@
-﻿// Fill out your copyright notice in the Description page of Project Settings.
+// Fill out your copyright notice in the Description page of Project Settings.
 
 #pragma once
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
 #include "Data/Grid/GridData.h"
+#include "Data/Room/RoomShapeMask.h"
 #include "RoomShapePreset.generated.h"
 
 // Enum for common room shapes (for designer clarity)
@@ -33,8 +34,12 @@ enum class ERoomShapeType : uint8
  * 1. Create RoomShapePreset asset
  * 2. Set ShapeType (L-Shape, T-Shape, etc.)
  * 3. Define EmptyRegions to carve out the shape
+ *    (Triangle/Diamond/Hexagon/Octagon are computed for any grid size - no regions needed)
  * 4. Assign to MasterRoom's ShapePreset property
  * 5. Generate room - shape is automatically applied!
+ * 
+ * The expanded shape is cached as a bit mask per target grid size (GetShapeMask), built on first
+ * use and dropped whenever the asset is edited.
  */
 UCLASS(BlueprintType)
 class GEMINIDUNGEONGEN_API URoomShapePreset : public UDataAsset
@@ -73,6 +78,27 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Shape Definition")
 	TArray<FIntPoint> EmptyCells;
 
+	// Triangle/Diamond/Hexagon/Octagon: rasterize the shape analytically for the room's GridSize
+	// (scanline per row, so it scales to any size). EmptyRegions/EmptyCells are still carved on top.
+	// Triangle: base along the South edge, apex at the middle of the North edge
+	// Diamond: corners at the middle of each edge
+	// Hexagon: flat North/South edges, points at the middle of the East/West edges
+	// Octagon: square with all four corners cut
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Shape Definition")
+	bool bAnalyticShape = true;
+
+	// Hexagon/Octagon: fraction of each half edge removed by the corner cuts
+	// (Octagon 0.586 = regular octagon on a square room, Hexagon 1.0 = points reach the room centre line)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Shape Definition", meta=(ClampMin="0.05", ClampMax="1.0", UIMin="0.05", UIMax="1.0"))
+	float CornerCut = 0.5f;
+
+	// True for the shape types bAnalyticShape applies to
+	static bool IsAnalyticShapeType(ERoomShapeType Type)
+	{
+		return Type == ERoomShapeType::Triangle || Type == ERoomShapeType::Diamond
+			|| Type == ERoomShapeType::Hexagon || Type == ERoomShapeType::Octagon;
+	}
+
 	// ========================================================================
 	// VISUAL PREVIEW INFO (optional - for future editor visualization)
 	// ========================================================================
@@ -81,4 +107,28 @@ public:
 	// Helps designers visually identify shapes in editor
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Visual")
 	TSoftObjectPtr<UTexture2D> PreviewThumbnail;
+
+	// ========================================================================
+	// SHAPE MASK CACHE
+	// ========================================================================
+
+	// Forced-empty cells of this shape for a room of GridSize (built once per size, game thread only)
+	const FRoomShapeMask& GetShapeMask(FIntPoint GridSize) const;
+
+	// Drop every cached mask (the next GetShapeMask rebuilds)
+	void InvalidateShapeMasks() const { CachedMasks.Reset(); }
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	// Expand EmptyRegions/EmptyCells (and the analytic shape) into a mask of GridSize
+	void BuildShapeMask(FIntPoint GridSize, FRoomShapeMask& OutMask) const;
+
+	// Carve everything outside the analytic ShapeType: two row spans per grid row
+	void RasterizeAnalyticShape(FRoomShapeMask& OutMask) const;
+
+	// Masks per target grid size
+	mutable TMap<FIntPoint, FRoomShapeMask> CachedMasks;
 };
\ No newline at end of file
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/LineBatchComponent.h"
+#include "Data/Grid/GridData.h"
+#include "DungeonDebugGridComponent.generated.h"
+
+/**
+ * Dungeon Debug Grid - persistent, batched visualization of a room's cell grid
+ *
+ * Replaces the per-call DrawDebugLine/DrawDebugBox approach (thousands of timed world debug draws
+ * re-issued on every property edit and load). All lines live in this one component's line batch:
+ * - Grid lines (green), cell state boxes (red = occupied, blue = empty)
+ * - Designer forced-empty cells (cyan, individual cells get an extra orange border)
+ * - Optional wall outlines (yellow) - used by the editor preview, where no wall instances exist yet
+ *
+ * The lines are built once per layout in room local space, and only re-transformed when the room
+ * moves. SetGrid() with unchanged inputs is a hash compare and nothing else.
+ */
+UCLASS(ClassGroup = (Debug))
+class GEMINIDUNGEONGEN_API UDungeonDebugGridComponent : public ULineBatchComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDungeonDebugGridComponent();
+
+	// Rebuild the line batch if any input differs from the last call
+	// RegionCells: cells covered by forced-empty regions. ForcedCells: individually forced-empty cells.
+	// WallOutlines: local-space boxes drawn as yellow outlines (empty once real walls are built)
+	void SetGrid(const FIntPoint& GridSize, TConstArrayView<EGridCellType> CellStates,
+		TConstArrayView<FIntPoint> RegionCells, TConstArrayView<FIntPoint> ForcedCells,
+		TConstArrayView<FBox> WallOutlines = TConstArrayView<FBox>());
+
+	// Remove all lines (the next SetGrid rebuilds)
+	void ClearGrid();
+
+	// Local lines plus the transformed batch
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+protected:
+	// Line batches are world space - follow the owning room when it moves
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport) override;
+
+private:
+	void AddLocalBox(const FVector& Center, const FVector& Extent, const FLinearColor& Color, float Thickness);
+
+	// Push LocalLines through the component transform into the batch
+	void UploadLines();
+
+	// Lines in room local space (rebuilt by SetGrid only)
+	TArray<FBatchedLine> LocalLines;
+
+	// Hash of the last SetGrid inputs (0 = nothing built)
+	uint64 GridHash = 0;
+};
@@ -6,6 +6,25 @@
 #include "GameFramework/Actor.h"
 #include "Doorway.generated.h"
 
+// Door state bits packed into ADoorway::PackedDoorState (the only replicated door property)
+enum class EDoorwayStateFlags : uint8
+{
+	None	= 0,
+	Open	= 1 << 0,	// Door is open (or opening)
+	Locked	= 1 << 1,	// Door refuses to open until unlocked
+	Pooled	= 1 << 2	// Doorway is parked in the doorway pool (hidden, no collision)
+};
+ENUM_CLASS_FLAGS(EDoorwayStateFlags);
+
+/**
+ * Doorway - functional door actor placed by AMasterRoom in every door frame
+ *
+ * EVENT DRIVEN:
+ * - Never ticks while idle - the tick is only enabled while the open/close animation runs
+ * - Net dormant (DORM_DormantAll) - state changes flush dormancy for a single update, so
+ *   idle doors cost nothing on the server or in the replication graph
+ * - All replicated state (open / locked / pooled) is packed into one byte
+ */
 UCLASS()
 class GEMINIDUNGEONGEN_API ADoorway : public AActor
 {
@@ -15,11 +34,88 @@ public:
 	// Sets default values for this actor's properties
 	ADoorway();
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
 public:
-	// Called every frame
+	// Only runs while the door is animating (see SetDoorAnimating)
 	virtual void Tick(float DeltaTime) override;
+
+	// --- Door State ---
+
+	// Time in seconds for a full open or close animation (0 = snap)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Doorway", meta = (ClampMin = "0.0"))
+	float OpenDuration = 0.5f;
+
+	// Server: player interaction - toggles the door unless it is locked. Returns true if the state changed.
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Doorway")
+	bool Interact(AActor* InteractionInstigator);
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Doorway")
+	void SetDoorOpen(bool bOpen);
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Doorway")
+	void SetDoorLocked(bool bLocked);
+
+	UFUNCTION(BlueprintPure, Category = "Doorway")
+	bool IsDoorOpen() const { return HasStateFlag(EDoorwayStateFlags::Open); }
+
+	UFUNCTION(BlueprintPure, Category = "Doorway")
+	bool IsDoorLocked() const { return HasStateFlag(EDoorwayStateFlags::Locked); }
+
+	// Current animation position (0 = closed, 1 = open)
+	UFUNCTION(BlueprintPure, Category = "Doorway")
+	float GetOpenAlpha() const { return OpenAlpha; }
+
+	// Called every animation step with the current open alpha (drive the door leaf from Blueprint)
+	UFUNCTION(BlueprintImplementableEvent, Category = "Doorway")
+	void OnDoorAnimationUpdate(float Alpha);
+
+	// Called on server and clients whenever the replicated door state changes
+	UFUNCTION(BlueprintImplementableEvent, Category = "Doorway")
+	void OnDoorStateChanged(bool bOpen, bool bLocked);
+
+	// --- Pooling (UDoorwayPoolSubsystem) ---
+
+	// Called when the pool hands this doorway to a room (transform and owner are already set)
+	// Resets the door to closed/unlocked
+	virtual void ActivateFromPool();
+
+	// Called when the owning room regenerates or is released - hide and disable collision/tick until reused
+	virtual void ReturnToPool();
+
+	// True while the doorway sits inactive in the pool
+	bool IsInPool() const { return HasStateFlag(EDoorwayStateFlags::Pooled); }
+
+	// Blueprint hooks for resetting per-door state (open/locked, effects) on reuse
+	UFUNCTION(BlueprintImplementableEvent, Category = "Doorway|Pooling")
+	void OnActivatedFromPool();
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "Doorway|Pooling")
+	void OnReturnedToPool();
+
+protected:
+	UFUNCTION()
+	void OnRep_DoorState(uint8 PreviousState);
+
+	// Server: change the packed state, wake the actor for one replication update, and apply locally
+	void SetDoorState(EDoorwayStateFlags NewState);
+
+	// Apply a state change on this machine (visibility, collision, animation)
+	void ApplyDoorState(EDoorwayStateFlags PreviousState);
+
+	void SetDoorAnimating(bool bAnimating);
+
+	bool HasStateFlag(EDoorwayStateFlags Flag) const { return EnumHasAnyFlags((EDoorwayStateFlags)PackedDoorState, Flag); }
+
+private:
+	// EDoorwayStateFlags packed into a single byte
+	UPROPERTY(ReplicatedUsing = OnRep_DoorState)
+	uint8 PackedDoorState = 0;
+
+	// Local animation state (not replicated - every machine animates towards the replicated target)
+	float OpenAlpha = 0.0f;
 };
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DoorwayPool.generated.h"
+
+class ADoorway;
+
+// A doorway a room wants to exist after its build pass (queued, spawned in one batch)
+struct FDoorwaySpawnRequest
+{
+	UClass* DoorwayClass = nullptr;
+	FTransform Transform;
+};
+
+// Inactive doorways of one class, waiting to be reused
+USTRUCT()
+struct FDoorwayPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<ADoorway*> FreeDoorways;
+};
+
+/**
+ * Doorway Pool - per-class pool of ADoorway actors shared by every room in the world
+ *
+ * Rooms queue doorway requests during their build pass and acquire them in one batch at the
+ * end of generation. Pooled actors are reused first; only the shortfall is spawned, deferred,
+ * with FinishSpawning run for the whole batch afterwards. On regeneration or release a room
+ * returns its doorways here instead of destroying them, so a reroll costs no SpawnActor calls.
+ */
+UCLASS()
+class GEMINIDUNGEONGEN_API UDoorwayPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Doorways only exist in game worlds (editor previews show the frame meshes only)
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	virtual void Deinitialize() override;
+
+	// Acquire one doorway per request (reused from the pool where possible, otherwise spawned deferred)
+	// OutDoorways is appended to, in request order (nullptr for requests that failed to spawn)
+	void AcquireDoorways(const TArray<FDoorwaySpawnRequest>& Requests, AActor* Owner, TArray<ADoorway*>& OutDoorways);
+
+	// Deactivate doorways and return them to their class pool
+	void ReleaseDoorways(TArray<ADoorway*>& Doorways);
+
+	// Spawn inactive doorways up front so the first generation pass doesn't pay for them
+	void PrewarmPool(TSubclassOf<ADoorway> DoorwayClass, int32 Count);
+
+	// Number of inactive doorways of a class currently waiting in the pool
+	int32 GetNumFreeDoorways(TSubclassOf<ADoorway> DoorwayClass) const;
+
+private:
+	ADoorway* SpawnDeferredDoorway(UClass* DoorwayClass, const FTransform& Transform, AActor* Owner);
+
+	// Inactive doorways per class
+	UPROPERTY()
+	TMap<UClass*, FDoorwayPoolBucket> Buckets;
+};
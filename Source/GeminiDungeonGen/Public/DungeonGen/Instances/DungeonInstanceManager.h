@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "DungeonInstanceManager.generated.h"
+
+class UStaticMesh;
+class UHierarchicalInstancedStaticMeshComponent;
+
+// Stable reference to one shared instance (survives other instances being added or removed)
+struct FDungeonInstanceHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+};
+
+// Component settings of a submitted batch - instances only share a HISM with identical settings
+struct FDungeonInstanceSettings
+{
+	bool bCollision = true;
+	bool bAffectNavigation = true;
+	float CullDistance = 0.0f;	// 0 = no limit
+};
+
+/**
+ * Dungeon Instance Manager - dungeon-wide HISM pool shared by every room (owned by ADungeonManager)
+ *
+ * In per-room mode every room creates one HISM per unique mesh, so fifty rooms in the same style
+ * hold fifty components, render proxies and draw calls for each mesh. Rooms bound to this manager
+ * submit their world-space instances here instead. The manager keeps one HISM per
+ * (mesh, spatial chunk, custom data stride, settings), so the component count follows content
+ * variety and dungeon extent rather than room count, while chunking keeps each HISM's bounds local
+ * enough for frustum and distance culling.
+ *
+ * HANDLES:
+ * - AddInstances returns one handle per instance; rooms keep them and release them on regeneration
+ *   or streaming (RemoveInstances)
+ * - Removal fills the holes with instances from the end of the same HISM and then trims the tail,
+ *   so no other instance index shifts - the moved instances' handles are repointed, all others stay valid
+ *
+ * Shared instances are not hidden by per-room portal culling (a chunk HISM spans several rooms).
+ */
+UCLASS(ClassGroup = (Rendering))
+class GEMINIDUNGEONGEN_API UDungeonInstanceManager : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDungeonInstanceManager();
+
+	// Edge length (cm) of the square world chunks instances are grouped by
+	UPROPERTY(EditAnywhere, Category = "Instances", meta = (ClampMin = "100.0"))
+	float ChunkSize = 5000.0f;
+
+	// Add world-space instances of one mesh. CustomData holds NumCustomData floats per instance (may be empty if 0).
+	// One handle per instance is appended to OutHandles, in input order.
+	void AddInstances(UStaticMesh* Mesh, const FDungeonInstanceSettings& Settings, TConstArrayView<FTransform> WorldTransforms,
+		TConstArrayView<float> CustomData, int32 NumCustomData, TArray<FDungeonInstanceHandle>& OutHandles);
+
+	// Remove instances (stale or invalid handles are ignored)
+	void RemoveInstances(TConstArrayView<FDungeonInstanceHandle> Handles);
+
+	// Remove every instance (components are kept for reuse)
+	void ClearInstances();
+
+	int32 GetNumComponents() const { return Buckets.Num(); }
+	int32 GetNumInstances() const { return Slots.Num(); }
+
+	// Exclusive resource size of every shared HISM (instance data, cluster trees, bodies)
+	int64 GetInstanceBytes() const;
+
+private:
+	// One HISM and the handle of each of its instances (instance index -> slot index)
+	struct FBucket
+	{
+		UHierarchicalInstancedStaticMeshComponent* Component = nullptr;
+		TArray<int32> InstanceSlots;
+		int32 NumCustomData = 0;
+	};
+
+	struct FBucketKey
+	{
+		UStaticMesh* Mesh = nullptr;
+		FIntPoint Chunk = FIntPoint::ZeroValue;
+		int32 NumCustomData = 0;
+		uint8 Flags = 0;
+		float CullDistance = 0.0f;
+
+		bool operator==(const FBucketKey& Other) const
+		{
+			return Mesh == Other.Mesh && Chunk == Other.Chunk && NumCustomData == Other.NumCustomData
+				&& Flags == Other.Flags && CullDistance == Other.CullDistance;
+		}
+
+		friend uint32 GetTypeHash(const FBucketKey& Key)
+		{
+			uint32 Hash = HashCombine(::GetTypeHash(Key.Mesh), GetTypeHash(Key.Chunk));
+			Hash = HashCombine(Hash, ::GetTypeHash(Key.NumCustomData));
+			return HashCombine(Hash, HashCombine(::GetTypeHash(Key.Flags), ::GetTypeHash(Key.CullDistance)));
+		}
+	};
+
+	// Where a handle's instance currently lives
+	struct FSlot
+	{
+		int32 Bucket = INDEX_NONE;
+		int32 InstanceIndex = INDEX_NONE;
+		uint32 Serial = 0;
+	};
+
+	int32 FindOrAddBucket(const FBucketKey& Key, const FDungeonInstanceSettings& Settings);
+
+	bool IsHandleValid(const FDungeonInstanceHandle& Handle) const
+	{
+		return Handle.IsValid() && Slots.IsValidIndex(Handle.Index) && Slots[Handle.Index].Serial == Handle.Serial;
+	}
+
+	TArray<FBucket> Buckets;
+	TMap<FBucketKey, int32> BucketIndices;
+
+	TSparseArray<FSlot> Slots;
+	uint32 NextSerial = 1;
+
+	// Keeps the HISMs referenced (they are owned by the dungeon manager actor)
+	UPROPERTY(Transient)
+	TArray<UHierarchicalInstancedStaticMeshComponent*> Components;
+};
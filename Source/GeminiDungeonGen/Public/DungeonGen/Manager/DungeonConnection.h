@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/Grid/GridData.h"
+
+/**
+ * Dungeon Connection - the one rule deciding which doors of adjacent rooms connect
+ *
+ * Shared by the DungeonManager (door graph, sealing, pathfinding) and the visibility subsystem
+ * (portal links, which clients resolve without the server's door graph), so "connected" means
+ * the same thing everywhere.
+ *
+ * Points are hashed by quantized position and cardinal facing. Each door then probes outward
+ * along its facing in quantization steps, covering its connection box depth (and the buckets to
+ * either side, for doors just off the grid), and pairs with the first opposite-facing door of
+ * another owner whose connection box overlaps its own - rooms separated by a small gap (wall
+ * thickness) still connect.
+ */
+namespace DungeonConnection
+{
+	// A connection point and the room (or cell) that published it - points of one owner never pair
+	struct FCandidate
+	{
+		int32 Owner = INDEX_NONE;
+		const FDoorConnectionPoint* Point = nullptr;
+	};
+
+	// Pair facing doors. OutPairs holds candidate index pairs; OutDuplicates (optional) holds
+	// (kept, dropped) pairs of doors hashed into the same bucket - only the kept one (lowest owner, then
+	// lowest candidate index) can connect.
+	// The result does not depend on the candidate order.
+	GEMINIDUNGEONGEN_API void PairConnectionPoints(TConstArrayView<FCandidate> Candidates, float Quantization,
+		TArray<TPair<int32, int32>>& OutPairs, TArray<TPair<int32, int32>>* OutDuplicates = nullptr);
+}
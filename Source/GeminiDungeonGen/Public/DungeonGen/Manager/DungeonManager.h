@@ -4,8 +4,39 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Data/Grid/GridData.h"
+#include "DungeonGen/Stats/DungeonMemory.h"
 #include "DungeonManager.generated.h"
 
+class AMasterRoom;
+class UDungeonInstanceManager;
+
+// One side of a door connection: the room and the connection point it published
+USTRUCT(BlueprintType)
+struct FDoorConnectionRef
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Connection")
+	AMasterRoom* Room = nullptr;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Connection")
+	FDoorConnectionPoint Point;
+};
+
+// A matched pair of facing doors across two adjacent rooms
+USTRUCT(BlueprintType)
+struct FDoorConnection
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Connection")
+	FDoorConnectionRef A;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Connection")
+	FDoorConnectionRef B;
+};
+
 UCLASS()
 class GEMINIDUNGEONGEN_API ADungeonManager : public AActor
 {
@@ -15,10 +46,125 @@ public:
 	// Sets default values for this actor's properties
 	ADungeonManager();
 
+	// --- Rooms ---
+
+	// Rooms managed by this dungeon. Leave empty to manage every MasterRoom in the level.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon|Rooms")
+	TArray<AMasterRoom*> Rooms;
+
+	// Regenerate every managed room and connect their doors when play begins (authority only)
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Rooms")
+	bool bGenerateOnBeginPlay = true;
+
+	// --- Door Connections ---
+
+	// Size of the quantization bucket (cm) used to hash door connection points
+	// Must be smaller than the door spacing, CELL_SIZE / 2 matches the door span centers
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Door Connections", meta = (ClampMin = "1.0"))
+	float ConnectionQuantization = CELL_SIZE / 2.0f;
+
+	// Seal unmatched doors with walls (re-solves the affected rooms). If false, unmatched doors are only reported.
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Door Connections")
+	bool bSealUnmatchedDoors = false;
+
+	// Facing door pairs found by the last ConnectRoomDoors pass
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Transient, Category = "Dungeon|Door Connections")
+	TArray<FDoorConnection> DoorConnections;
+
+	// Doors that had no facing partner in the last ConnectRoomDoors pass
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Transient, Category = "Dungeon|Door Connections")
+	TArray<FDoorConnectionRef> UnmatchedDoors;
+
+	// --- Room Streaming ---
+
+	// Generate rooms near players and release far rooms, bounding the resident instance count
+	// Rooms regenerate deterministically from their GenerationSeed when they stream back in
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Streaming")
+	bool bEnableRoomStreaming = false;
+
+	// Rooms whose bounds come within this distance (cm) of a player, or of a player's predicted path, are generated
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Streaming", meta = (ClampMin = "0.0", EditCondition = "bEnableRoomStreaming"))
+	float ActivationRadius = 5000.0f;
+
+	// Generated rooms farther than this distance (cm) from every player are released
+	// Must be larger than ActivationRadius - the band between the two is the hysteresis that prevents thrashing
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Streaming", meta = (ClampMin = "0.0", EditCondition = "bEnableRoomStreaming"))
+	float ReleaseRadius = 7500.0f;
+
+	// How far ahead (seconds) player velocity is extrapolated to predict the path for activation
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Streaming", meta = (ClampMin = "0.0", EditCondition = "bEnableRoomStreaming"))
+	float PathPredictionTime = 1.5f;
+
+	// Maximum number of rooms generated per streaming update (nearest rooms first)
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Streaming", meta = (ClampMin = "1", EditCondition = "bEnableRoomStreaming"))
+	int32 MaxRoomGenerationsPerUpdate = 2;
+
+	// Seconds between streaming updates
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Streaming", meta = (ClampMin = "0.0", EditCondition = "bEnableRoomStreaming"))
+	float StreamingUpdateInterval = 0.25f;
+
+	// --- Shared Instances ---
+
+	// Rooms submit their instances to this dungeon's instance manager (one HISM per mesh per world chunk)
+	// instead of creating their own HISM per mesh - the component count follows content variety, not room count
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Instances")
+	bool bUseSharedInstances = false;
+
+	// Chunked HISMs shared by every managed room (used when bUseSharedInstances is set)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Dungeon|Instances")
+	UDungeonInstanceManager* InstanceManager;
+
+	// --- Visibility ---
+
+	// Hide rooms that can't be seen from the local players' cameras through any chain of door openings
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Visibility")
+	bool bEnablePortalCulling = false;
+
+	// Longest portal chain followed from the camera's room (rooms further along are always shown)
+	UPROPERTY(EditAnywhere, Category = "Dungeon|Visibility", meta = (ClampMin = "1", EditCondition = "bEnablePortalCulling"))
+	int32 MaxPortalDepth = 8;
+
+	// Run one streaming pass immediately (generation budget still applies)
+	UFUNCTION(BlueprintCallable, Category = "Dungeon|Streaming")
+	void UpdateRoomStreaming();
+
+	// Regenerate all managed rooms, then pair their doors
+	// With streaming enabled the rooms are only solved (door connection points, no instances) - streaming builds them
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Dungeon")
+	void GenerateDungeon();
+
+	// Pair facing doors across adjacent rooms using a hash of quantized positions and facing direction
+	// Unmatched doors are reported, and sealed if bSealUnmatchedDoors is set
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Dungeon|Door Connections")
+	void ConnectRoomDoors();
+
+	// Remove all seals placed by previous ConnectRoomDoors passes and re-solve the affected rooms
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Dungeon|Door Connections")
+	void ResetDoorSeals();
+
+	// Memory held by all managed rooms combined (per-room breakdown: AMasterRoom::GetMemoryStats, or Dungeon.MemoryReport)
+	UFUNCTION(BlueprintCallable, Category = "Dungeon|Memory")
+	FRoomMemoryStats GetDungeonMemoryStats() const;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Restores every room hidden by portal culling
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Returns Rooms, or every MasterRoom in the world if Rooms is empty
+	TArray<AMasterRoom*> GatherRooms() const;
+
+	// Point every managed room at the shared instance manager (or back to per-room HISMs)
+	void BindRoomInstances(bool bRegenerate);
+
+	// Collects the streaming sources: (current location, predicted location) for every player pawn
+	void GatherStreamingSources(TArray<TPair<FVector, FVector>>& OutSources) const;
+
+	// Seconds accumulated since the last streaming update
+	float TimeSinceStreamingUpdate = 0.0f;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
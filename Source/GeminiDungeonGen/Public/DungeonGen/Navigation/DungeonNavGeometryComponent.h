@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "DungeonNavGeometryComponent.generated.h"
+
+/**
+ * Dungeon Nav Geometry - the navigation footprint of one room, emitted straight from its layout
+ *
+ * Without it, Recast voxelizes every wall, floor and ceiling instance of a room (thousands of
+ * triangles, each with its mesh's collision) whenever the room is generated, released or moved.
+ * The room already knows exactly where its walkable floor and its walls are, so it hands this
+ * component a handful of boxes instead (merged floor rectangles, door openings and wall runs)
+ * and turns navigation relevance off on its HISMs. A regeneration then only dirties this one
+ * component's bounds, and the tiles it covers rebuild from a few dozen triangles.
+ *
+ * The component has no collision and no render proxy - it only exists for navigation export.
+ */
+UCLASS(ClassGroup = (Navigation))
+class GEMINIDUNGEONGEN_API UDungeonNavGeometryComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDungeonNavGeometryComponent();
+
+	// Replace the exported boxes (component space) and notify the navigation system
+	// Walkable: surfaces agents stand on (their top face is the navmesh)
+	// Obstacles: volumes that cut the navmesh (walls)
+	void SetGeometry(TArray<FBox>&& InWalkable, TArray<FBox>&& InObstacles);
+
+	// Drop all boxes (the room's tiles are rebuilt without it)
+	void ClearGeometry();
+
+	int32 GetNumBoxes() const { return Walkable.Num() + Obstacles.Num(); }
+
+	//~ Begin UPrimitiveComponent Interface
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	virtual bool IsNavigationRelevant() const override;
+	virtual bool DoCustomNavigableGeometryExport(FNavigableGeometryExport& GeomExport) const override;
+	//~ End UPrimitiveComponent Interface
+
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+private:
+	TArray<FBox> Walkable;
+	TArray<FBox> Obstacles;
+};
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Data/Grid/GridData.h"
+#include "DungeonPathfinding.generated.h"
+
+class AMasterRoom;
+struct FDoorConnection;
+
+// A single path request (world space)
+USTRUCT(BlueprintType)
+struct FDungeonPathQuery
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
+	FVector Start = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
+	FVector End = FVector::ZeroVector;
+};
+
+// Result of a path request: world-space points from Start to End (cell centres, smoothed)
+USTRUCT(BlueprintType)
+struct FDungeonPathResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pathfinding")
+	bool bSuccess = false;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pathfinding")
+	TArray<FVector> Points;
+
+	// Path length in cm (0 on failure)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pathfinding")
+	float Length = 0.0f;
+};
+
+// A door of a room as seen by the pathfinder: the walkable cell just inside the opening
+struct FDungeonPathPortal
+{
+	EWallEdge Edge = EWallEdge::North;
+	int32 StartCell = 0;
+	FIntPoint Cell = FIntPoint::ZeroValue;	// Interior cell in front of the door
+	FVector WorldLocation = FVector::ZeroVector;
+
+	// Portal on the other side of the door (set from the DungeonManager's door connections)
+	int32 LinkedRoom = INDEX_NONE;
+	int32 LinkedPortal = INDEX_NONE;
+};
+
+// Immutable snapshot of one room's walkability, taken when the room finishes generating
+struct FDungeonPathRoom
+{
+	TWeakObjectPtr<AMasterRoom> Room;
+	FTransform Transform;	// Room local space (cm, grid origin at 0,0) -> world
+	FIntPoint GridSize = FIntPoint::ZeroValue;
+	float Height = 0.0f;	// Room height (positions above it aren't inside this room)
+	TBitArray<> Walkable;	// GridSize.X * GridSize.Y, row-major by Y
+	TArray<FDungeonPathPortal> Portals;
+
+	// Grid path length (cm) between every pair of portals, NumPortals^2 (MAX_flt if unreachable)
+	TArray<float> PortalDistances;
+
+	bool IsWalkable(int32 X, int32 Y) const
+	{
+		return X >= 0 && Y >= 0 && X < GridSize.X && Y < GridSize.Y && Walkable[Y * GridSize.X + X];
+	}
+};
+
+namespace DungeonPathfinding
+{
+	// A* between two cells of one room, returned as smoothed world points (Start and Goal cell centres included)
+	GEMINIDUNGEONGEN_API bool FindRoomLeg(const FDungeonPathRoom& Room, FIntPoint Start, FIntPoint Goal, TArray<FVector>& OutPoints);
+}
+
+/**
+ * Dungeon Pathfinding - grid-native path queries over generated rooms (no navmesh / Recast)
+ *
+ * Each room hands over its final cell grid when it finishes generating (UpdateRoom), so paths
+ * reflect a regeneration immediately. Two levels of search:
+ * - Within a room: A* on the 8-connected cell grid (no corner cutting), then line-of-sight smoothing
+ * - Across rooms: A* over the door portal graph, using precomputed portal-to-portal grid distances
+ *
+ * Queries only read the room snapshots, so FindPaths runs a batch in parallel. Room updates and
+ * connection changes must happen on the game thread, outside of a batch.
+ */
+UCLASS()
+class GEMINIDUNGEONGEN_API UDungeonPathfindingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Snapshot a room's walkability and doors (called by AMasterRoom after every generation pass)
+	void UpdateRoom(AMasterRoom* Room);
+
+	// Forget a room (called when the room leaves play)
+	void RemoveRoom(AMasterRoom* Room);
+
+	// Replace the door connection graph (called by the DungeonManager after pairing doors)
+	void SetDoorConnections(const TArray<FDoorConnection>& Connections);
+
+	// Find a path between two world positions (same room or across any number of connected rooms)
+	UFUNCTION(BlueprintCallable, Category = "Dungeon|Pathfinding")
+	FDungeonPathResult FindPath(const FVector& Start, const FVector& End) const;
+
+	// Run a batch of queries in parallel (results are index-aligned with Queries)
+	void FindPaths(TConstArrayView<FDungeonPathQuery> Queries, TArray<FDungeonPathResult>& OutResults) const;
+
+	// Number of rooms with a walkability snapshot
+	UFUNCTION(BlueprintPure, Category = "Dungeon|Pathfinding")
+	int32 GetNumRooms() const { return Rooms.Num(); }
+
+private:
+	// Locate the room and cell under a world position. Returns false if it's not on a walkable cell.
+	bool FindRoomCell(const FVector& WorldLocation, int32& OutRoom, FIntPoint& OutCell) const;
+
+	// Re-resolve portal links after rooms or connections changed
+	void ResolvePortalLinks();
+
+	// Stored door connection: (room, edge, start cell) on both sides
+	struct FPortalLinkKey
+	{
+		TWeakObjectPtr<AMasterRoom> Room;
+		EWallEdge Edge = EWallEdge::North;
+		int32 StartCell = 0;
+	};
+
+	TArray<FDungeonPathRoom> Rooms;
+	TMap<TObjectKey<AMasterRoom>, int32> RoomIndices;
+
+	// Global portal node index of each room's first portal (room-graph search), plus the total count
+	TArray<int32> PortalOffsets;
+	int32 NumPortalNodes = 0;
+
+	TArray<TPair<FPortalLinkKey, FPortalLinkKey>> PortalLinks;
+};
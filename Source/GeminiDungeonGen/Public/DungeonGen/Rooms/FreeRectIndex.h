@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Free Rectangle Index - the maximal free rectangles of a room grid (MaxRects)
+ *
+ * Every free cell is covered by at least one rectangle and no rectangle is contained in another,
+ * so "where does a W x H footprint fit" is one scan over a short list instead of a retry loop
+ * over cells: any placement inside a rectangle at least W x H is free.
+ *
+ * Blocking a rectangle (an obstacle or a placed footprint) splits every rectangle it overlaps into
+ * its up to four free sides, then drops the ones contained in others. Rectangles are half-open
+ * (Min inclusive, Max exclusive) in cells.
+ */
+struct GEMINIDUNGEONGEN_API FFreeRectIndex
+{
+	TArray<FIntRect> FreeRects;
+
+	// Start with the whole grid free
+	void Init(FIntPoint GridSize);
+
+	// Remove a rectangle from the free space
+	void Block(const FIntRect& Rect);
+
+	// Block every set cell of a mask (row-major by Y, one Block per horizontal run)
+	void BlockMask(FIntPoint GridSize, const TBitArray<>& Mask);
+
+	// Indices of the free rectangles a Size footprint fits in
+	void FindFitting(FIntPoint Size, TArray<int32>& OutIndices) const;
+
+	int32 Num() const { return FreeRects.Num(); }
+
+	SIZE_T GetAllocatedSize() const { return FreeRects.GetAllocatedSize(); }
+
+private:
+	// Drop every rectangle contained in another, checking only the rectangles from FirstNew on against the rest
+	void Prune(int32 FirstNew);
+};
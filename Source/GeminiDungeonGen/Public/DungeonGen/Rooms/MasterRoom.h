@@ -7,24 +7,53 @@
 #include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "Data/Grid/GridData.h"
 #include "Data/Room/RoomData.h"
+#include "DungeonGen/Rooms/RoomLayout.h"
+#include "DungeonGen/Rooms/WallSegments.h"
+#include "DungeonGen/Doors/DoorwayPool.h"
+#include "DungeonGen/Stats/DungeonMemory.h"
+#include "DungeonGen/Instances/DungeonInstanceManager.h"
+#include "Containers/Ticker.h"
 #include "MasterRoom.generated.h"
 
-// Tracks placed base wall segments for Middle/Top layer spawning
-// Stores transform and mesh info for socket-based stacking
-USTRUCT()
-struct FWallSegmentInfo
+// How the generated room geometry collides
+UENUM(BlueprintType)
+enum class ERoomCollisionMode : uint8
 {
-	GENERATED_BODY()
+	PerInstance 		UMETA(DisplayName = "Per-Instance Mesh Collision"),	// Every HISM instance uses its mesh's collision
+	MergedPrimitives 	UMETA(DisplayName = "Merged Box Primitives")		// One box per wall run / floor rectangle, HISMs have no collision
+};
+
+// Instances of one mesh queued during a build: transforms plus a fixed-stride block of custom data
+// (NumCustomData floats per instance - variants with fewer floats are zero-padded)
+struct FQueuedInstanceBatch
+{
+	TArray<FTransform> Transforms;
+	TArray<float> CustomData;
+	int32 NumCustomData = 0;
 	
-	EWallEdge Edge = EWallEdge::North;
-	int32 StartCell = 0;
-	int32 SegmentLength = 0;
-	FTransform BaseTransform = FTransform::Identity;
-	UStaticMesh* BaseMesh = nullptr;
-	const FWallModule* WallModule = nullptr;  // Reference to module for Middle/Top meshes
+	// Append an instance (a variant with more floats than any before it widens the whole batch)
+	void Add(const FTransform& Transform, TConstArrayView<float> InCustomData);
+};
+
+// One accepted clutter sample: pool entry, its mesh, anchor cell (footprint min corner) and rotated footprint
+struct FClutterPlacement
+{
+	const FCompiledMeshEntry* Entry = nullptr;
+	UStaticMesh* Mesh = nullptr;
+	FIntPoint Cell = FIntPoint::ZeroValue;
+	FIntPoint Footprint = FIntPoint(1, 1);
+	uint8 Quadrant = 0;
 };
 
 class URoomShapePreset;
+class ADoorway;
+class UBoxComponent;
+class UMaterialInterface;
+class UDungeonNavGeometryComponent;
+class UDungeonDebugGridComponent;
+struct FDungeonPortalQuad;
+struct FRoomShapeMask;
+struct FRoomBoundary;
 UCLASS()
 class GEMINIDUNGEONGEN_API AMasterRoom : public AActor
 {
@@ -46,14 +75,96 @@ public:
 	URoomShapePreset* ShapePreset;
 
 	// The seed used for generation (set by DungeonManager, tweakable by designer)
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "Generation|Seed")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, ReplicatedUsing = OnRep_GenerationState, Category = "Generation|Seed")
 	int32 GenerationSeed = 1337;
 
+	// --- Replication (Client-Side Generation) ---
+
+	// Clients regenerate the room locally from GenerationSeed + the replicated override blob
+	// instead of relying on the overrides saved in the map. No instance data is replicated.
+	UPROPERTY(EditAnywhere, Category = "Generation|Replication")
+	bool bClientSideGeneration = true;
+
+	// --- Collision ---
+
+	// PerInstance: every wall/floor/ceiling instance carries its mesh collision (thousands of bodies per room)
+	// MergedPrimitives: simple boxes derived from the layout - one per contiguous wall run and merged floor rectangle.
+	// Interior meshes and door frames keep their own collision in both modes.
+	UPROPERTY(EditAnywhere, Category = "Generation|Collision")
+	ERoomCollisionMode CollisionMode = ERoomCollisionMode::PerInstance;
+
+	// Thickness of the merged wall run boxes (centred on the wall pivot line)
+	UPROPERTY(EditAnywhere, Category = "Generation|Collision", meta = (ClampMin = "1.0", EditCondition = "CollisionMode == ERoomCollisionMode::MergedPrimitives"))
+	float WallCollisionThickness = 20.0f;
+
+	// Thickness of the merged floor boxes (extending down from Z = 0)
+	UPROPERTY(EditAnywhere, Category = "Generation|Collision", meta = (ClampMin = "1.0", EditCondition = "CollisionMode == ERoomCollisionMode::MergedPrimitives"))
+	float FloorCollisionThickness = 10.0f;
+
+	// Also add merged boxes under the ceiling (off: the ceiling and top wall layers have no collision at all)
+	UPROPERTY(EditAnywhere, Category = "Generation|Collision", meta = (EditCondition = "CollisionMode == ERoomCollisionMode::MergedPrimitives"))
+	bool bCeilingCollision = false;
+
+	// --- Navigation ---
+
+	// Emit the room's navigation geometry directly from the layout (merged floor rectangles, door openings
+	// and wall runs) instead of letting Recast voxelize every wall/floor/ceiling instance.
+	// The HISMs and merged collision boxes stop affecting navigation while this is on.
+	UPROPERTY(EditAnywhere, Category = "Generation|Navigation")
+	bool bEmitNavigationGeometry = false;
+
+	// --- Distant Proxy ---
+
+	// Build a cheap stand-in for the room from the layout (one box per wall run, floor rectangle and ceiling
+	// rectangle, all in a single instanced component). Beyond ProxyDistance the renderer draws the proxy
+	// instead of the full HISM set.
+	UPROPERTY(EditAnywhere, Category = "Generation|Proxy")
+	bool bGenerateProxy = false;
+
+	// Camera distance (cm) at which the proxy replaces the full room
+	UPROPERTY(EditAnywhere, Category = "Generation|Proxy", meta = (ClampMin = "100.0", EditCondition = "bGenerateProxy"))
+	float ProxyDistance = 8000.0f;
+
+	// Mesh stretched over every proxy box (must be a 100cm cube centred on its pivot, like the engine cube)
+	UPROPERTY(EditAnywhere, Category = "Generation|Proxy", meta = (EditCondition = "bGenerateProxy"))
+	TSoftObjectPtr<UStaticMesh> ProxyMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cube.Cube")));
+
+	// Material for the proxy (leave empty to use the proxy mesh's own material)
+	UPROPERTY(EditAnywhere, Category = "Generation|Proxy", meta = (EditCondition = "bGenerateProxy"))
+	TSoftObjectPtr<UMaterialInterface> ProxyMaterial;
+
+	// --- Layout Cache ---
+
+	// Reuse layouts solved from identical inputs (stored in Saved/DungeonLayoutCache, keyed by an input hash)
+	// A cache hit skips the solver and goes straight to instance upload
+	UPROPERTY(EditAnywhere, Category = "Generation|Cache")
+	bool bUseLayoutCache = true;
+
+	// Delete every cached layout (all rooms share the cache)
+	UFUNCTION(CallInEditor, Category = "Generation|Cache")
+	void ClearLayoutCache();
+
 	// --- EDITOR ONLY: Generate Button ---
 	// Changing this boolean property triggers the RegenerateRoom function in the editor.
 	UPROPERTY(EditAnywhere, Category = "Generation|Debug")
 	bool bGenerateRoom = false; 
 
+	// Show the cell grid, cell states and forced-empty cells in the editor (one persistent line batch per room)
+	UPROPERTY(EditAnywhere, Category = "Generation|Debug")
+	bool bShowDebugGrid = true;
+
+	// --- Editor Regeneration ---
+
+	// Regenerate the room in the editor when a generation property changes
+	// While a value is being dragged only a preview is shown (solved occupancy + wall outlines, no instances);
+	// the full build runs once the edit is committed and no further edit arrived for RegenerateDebounceDelay
+	UPROPERTY(EditAnywhere, Category = "Generation|Debug")
+	bool bAutoRegenerateOnEdit = true;
+
+	// Seconds of quiet after a committed edit before the full regeneration runs
+	UPROPERTY(EditAnywhere, Category = "Generation|Debug", meta = (ClampMin = "0.0", EditCondition = "bAutoRegenerateOnEdit"))
+	float RegenerateDebounceDelay = 0.3f;
+
 	// --- Designer Override Control ---
 
 	// Array of rectangular regions the designer wants to force empty
@@ -106,6 +217,133 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generation|Procedural Doors", meta = (EditCondition = "bEnableProceduralDoors"))
 	TArray<EWallEdge> RequiredDoorEdges;
 
+	// --- Door Connections (DungeonManager) ---
+
+	// Door slots sealed by the DungeonManager because no facing door was found in a neighbouring room
+	// Sealed doors are skipped during generation and the gap is filled with walls instead
+	UPROPERTY(EditAnywhere, Category = "Generation|Door Connections")
+	TArray<FSealedDoorSlot> SealedDoors;
+
+	// UFUNCTION to be called by the DungeonManager (or designer in editor)
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Generation")
+	void RegenerateRoom();
+
+	// World-space connection points for every door placed by the last generation pass
+	UFUNCTION(BlueprintPure, Category = "Generation|Door Connections")
+	const TArray<FDoorConnectionPoint>& GetDoorConnectionPoints() const { return DoorConnectionPoints; }
+
+	// Mark a door slot as sealed (takes effect on the next RegenerateRoom)
+	// Returns false if the slot was already sealed
+	bool SealDoor(EWallEdge Edge, int32 StartCell);
+
+	// Remove all sealed door slots (takes effect on the next RegenerateRoom)
+	UFUNCTION(BlueprintCallable, Category = "Generation|Door Connections")
+	void ClearSealedDoors();
+
+	// Returns true if the given door has been sealed by the DungeonManager
+	bool IsDoorSealed(const FFixedDoorLocation& Door) const;
+
+	// --- Streaming (DungeonManager) ---
+
+	// Free all generated instances and HISM components (RegenerateRoom rebuilds them deterministically from GenerationSeed)
+	// Door connection points are kept so the DungeonManager's connection graph stays valid while the room is released
+	UFUNCTION(BlueprintCallable, Category = "Generation|Streaming")
+	void ReleaseRoom();
+
+	// Solve the layout and publish door connection points without building any instances - the DungeonManager
+	// connects doors from these and streaming builds the room later. A built room is regenerated instead.
+	void SolveRoom();
+
+	// Leave the build to the DungeonManager's streaming (clients no longer build as soon as the server's state arrives)
+	void SetDeferGenerationToStreaming(bool bDefer) { bDeferGenerationToStreaming = bDefer; }
+
+	// True when RegenerateRoom can run here: authority, or a client that has received the server's generation state
+	bool CanGenerate() const;
+
+	// True once RegenerateRoom has produced instances, false after ReleaseRoom
+	UFUNCTION(BlueprintPure, Category = "Generation|Streaming")
+	bool IsRoomGenerated() const { return bIsGenerated; }
+
+	// World-space bounds of the room grid, including the wall boundary ring and ceiling height
+	UFUNCTION(BlueprintPure, Category = "Generation")
+	FBox GetRoomBounds() const;
+
+	// Final cell states of the last generation pass (GridSize.X * GridSize.Y, row-major by Y; empty after ReleaseRoom)
+	const TArray<EGridCellType>& GetGridState() const { return InternalGridState; }
+
+	// --- Memory ---
+
+	// Memory held by this room right now: generation state, instance buffers, collision, proxy, nav and debug data
+	// (all zero apart from retained bookkeeping after ReleaseRoom). See DungeonMemory.h for what each field covers.
+	UFUNCTION(BlueprintCallable, Category = "Generation|Memory")
+	FRoomMemoryStats GetMemoryStats() const;
+
+	// --- Interior Furniture ---
+
+	// Reserve a walkable path between door approach cells: one BFS over the ECT_FloorMesh cells from the first
+	// approach cell that is floor, then the parent chain back from every other approach cell is set in OutReserved.
+	// Approach cells the BFS does not reach (not floor, or walled off) are returned in OutUnreached.
+	static void ReserveDoorPaths(FIntPoint GridSize, TConstArrayView<EGridCellType> CellStates, const TBitArray<>& ApproachCells,
+		TBitArray<>& OutReserved, TArray<int32>& OutUnreached);
+
+	// --- Floor Clutter ---
+
+	// Dart-throw Compiled's clutter pool over the Free cells (index Y * GridSize.X + X) in shuffled order: accepted
+	// footprints are cleared from Free and no two footprint centres end up closer than ClutterMinSpacing.
+	// Entries GetMesh returns null for are skipped.
+	static void ScatterClutter(const FCompiledRoomData& Compiled, FIntPoint GridSize, TBitArray<>& Free,
+		TFunctionRef<UStaticMesh*(int32 MeshIndex)> GetMesh, FRandomStream& RandomStream, TArray<FClutterPlacement>& OutPlacements);
+
+	// --- Visibility (portal culling) ---
+
+	// World-space opening quad of every placed, unsealed door: centred on its connection point on the
+	// boundary plane, Footprint cells wide and one wall high
+	void GetPortalQuads(TArray<FDungeonPortalQuad>& OutQuads) const;
+
+	// Hide/show every HISM of the room (set by the visibility subsystem; collision is unaffected)
+	// Instances in a shared instance manager stay visible - their HISMs span several rooms
+	void SetPortalCulled(bool bCulled);
+
+	// --- Shared Instances (DungeonManager) ---
+
+	// Submit instances to a dungeon-wide instance manager instead of creating this room's own HISMs
+	// (nullptr switches back to per-room HISMs). A generated room is regenerated into the new target unless
+	// bRegenerate is false (the caller regenerates it anyway).
+	void SetSharedInstanceManager(UDungeonInstanceManager* InManager, bool bRegenerate = true);
+
+	// --- Doorways ---
+
+	// Functional doorway actors of the last generation pass (server only, owned by the doorway pool)
+	UFUNCTION(BlueprintPure, Category = "Generation|Doorways")
+	const TArray<ADoorway*>& GetDoorways() const { return SpawnedDoorways; }
+
+	// --- Replication (Client-Side Generation) ---
+
+	// 64-bit hash of the generated layout (all instance transforms per mesh), computed after each generation
+	uint64 GetLayoutHash() const { return LocalLayoutHash; }
+
+	// Serialize all generation inputs that are not covered by GenerationSeed (designer overrides, door settings, seals)
+	// Symmetric: writes when Ar is saving, reads and overwrites the overrides when Ar is loading
+	void SerializeGenerationOverrides(FArchive& Ar);
+
+	// Serialize the replicated subset: sealed doors plus the override groups changed since the map was loaded
+	// (all of them for rooms spawned at runtime). Fixed doors are left out in procedural mode.
+	void SerializeReplicatedOverrides(FArchive& Ar);
+
+	// --- Room Layout (Save / Cache / Replication Format) ---
+
+	// The layout produced by the last generation pass (or applied via ApplyEncodedLayout)
+	const FRoomLayout& GetRoomLayout() const { return CurrentLayout; }
+
+	// Encode the current layout into the compact binary room layout format
+	UFUNCTION(BlueprintCallable, Category = "Generation|Layout")
+	void GetEncodedLayout(TArray<uint8>& OutBytes) const;
+
+	// Rebuild the room from an encoded layout without running the solver
+	// The layout must have been produced from the same data assets and overrides
+	UFUNCTION(BlueprintCallable, Category = "Generation|Layout")
+	bool ApplyEncodedLayout(const TArray<uint8>& Bytes);
+
 private:
 	// Internal grid array to track occupancy (used during runtime generation)
 	TArray<EGridCellType> InternalGridState;
@@ -114,87 +352,300 @@ private:
 	// Used during generation to prevent overlapping placement
 	TMap<FIntPoint, EGridCellType> OccupancyGrid;
 	
-	// Tracks placed base wall segments for Middle/Top layer spawning
-	// Stores transform and mesh info for socket-based stacking
-	TArray<FWallSegmentInfo> PlacedBaseWalls;
+	// Wall modules of the current build (meshes loaded, stacking chains resolved), indexed by placed walls
+	FCompiledWallStyle CompiledWallStyle;
+	
+	// Compiled tables of RoomData the solver passes select from (only set inside SolveLayout)
+	const FCompiledRoomData* SolverData = nullptr;
+	
+	// Placed base wall segments of the current build (parallel arrays), read by Middle/Top stacking
+	FPlacedWallSegments PlacedBaseWalls;
 	
 	// Map to hold and manage HISM components (one HISM per unique Static Mesh)
 	TMap<UStaticMesh*, UHierarchicalInstancedStaticMeshComponent*> MeshToHISMMap;
 	
+	// Floor clutter HISMs, separate from MeshToHISMMap so clutter gets its own cull distance and no collision
+	TMap<UStaticMesh*, UHierarchicalInstancedStaticMeshComponent*> ClutterHISMMap;
+	
+	// Dungeon-wide instance manager this room submits to (set by the DungeonManager, nullptr = own HISMs)
+	UPROPERTY(Transient)
+	UDungeonInstanceManager* SharedInstances = nullptr;
+	
+	// Handles of this room's instances in SharedInstances (released on regeneration/release)
+	TArray<FDungeonInstanceHandle> SharedInstanceHandles;
+	
+	// Layout recorded by the solver passes and decoded by BuildFromLayout
+	FRoomLayout CurrentLayout;
+	
+	// Per-mesh instances queued during BuildFromLayout, uploaded in one batch per HISM
+	// Variants of a mesh (different custom data) share its batch and its HISM
+	TMap<UStaticMesh*, FQueuedInstanceBatch> QueuedInstances;
+	
+	// Clutter instances queued during BuildFromLayout (uploaded to ClutterHISMMap / clutter shared settings)
+	TMap<UStaticMesh*, FQueuedInstanceBatch> QueuedClutterInstances;
+
+	// World-space connection points for all doors placed in the last generation pass
+	// Rebuilt at the end of GenerateWallsAndDoors and consumed by the DungeonManager
+	TArray<FDoorConnectionPoint> DoorConnectionPoints;
+	
+	// Set by RegenerateRoom, cleared by ReleaseRoom (used by DungeonManager streaming)
+	bool bIsGenerated = false;
+	
+	// Meshes that keep per-instance collision in MergedPrimitives mode (interior meshes, door frames)
+	TSet<UStaticMesh*> InstanceCollisionMeshes;
+	
+	// Merged collision boxes (reused across regenerations, surplus boxes are disabled)
+	UPROPERTY(Transient)
+	TArray<UBoxComponent*> CollisionBoxes;
+	
+	// Editor grid visualization (bShowDebugGrid), created on first use
+	UPROPERTY(Transient)
+	UDungeonDebugGridComponent* DebugGrid = nullptr;
+	
+	// Distant stand-in for the room (bGenerateProxy), created on first use
+	UPROPERTY(Transient)
+	UInstancedStaticMeshComponent* ProxyComponent = nullptr;
+	
+	// Layout-derived navigation geometry (bEmitNavigationGeometry), created on first use
+	UPROPERTY(Transient)
+	UDungeonNavGeometryComponent* NavGeometry = nullptr;
+	
+	// Doorways queued by PlaceDoorFrame during the build, acquired from the pool in one batch
+	TArray<FDoorwaySpawnRequest> PendingDoorways;
+	
+	// Doorways acquired for the current generation (returned to the pool on regeneration/release)
+	UPROPERTY(Transient)
+	TArray<ADoorway*> SpawnedDoorways;
+	
+	// Compact override blob written by the server before each generation (see SerializeReplicatedOverrides)
+	UPROPERTY(ReplicatedUsing = OnRep_GenerationState)
+	TArray<uint8> ReplicatedOverrides;
+	
+	// Layout hash computed by the server, verified by clients after local generation
+	UPROPERTY(ReplicatedUsing = OnRep_GenerationState)
+	uint64 ReplicatedLayoutHash = 0;
+	
+	// Layout hash of the last local generation pass
+	uint64 LocalLayoutHash = 0;
+	
+	// Client: true once the replicated overrides have been applied (client generation is blocked until then)
+	bool bHasReplicatedGenerationState = false;
+	
+	// Client: checksum of the seed and override blob last applied
+	uint32 AppliedGenerationStateCrc = 0;
+	
+	// Streaming owns the build: clients keep the replicated state and build when the room streams in
+	bool bDeferGenerationToStreaming = false;
+	
+	// Server: hash of every override group as loaded, and the groups that have differed from it since
+	TArray<uint32> OverrideBaselineHashes;
+	uint8 ChangedOverrideGroups = 0;
+	
+	// Client: a regeneration is already scheduled for next tick (coalesces several OnReps from one bunch)
+	bool bClientRegenerationPending = false;
+	
+	// Editor: CurrentLayout is a preview solve (no instances built) - the debug grid shows its wall outlines
+	bool bShowingLayoutPreview = false;
+	
+	// Editor: debounced full regeneration after a committed property edit
+	FTSTicker::FDelegateHandle PendingRegenerationHandle;
+	
 protected:
-	virtual void PostLoad() override;
+	virtual void PostInitializeComponents() override;
+	virtual void PostRegisterAllComponents() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
 	
-	// Override used to monitor changes in the Details Panel (for the bGenerateRoom button trick)
+	// Client: seed, override blob or layout hash arrived - schedule a local regeneration
+	UFUNCTION()
+	void OnRep_GenerationState();
+	
+	// Client: apply the replicated overrides, regenerate locally (unless streaming builds it later) and verify the layout hash
+	void ApplyReplicatedGenerationState();
+	
+	// Client: log when the local layout differs from the server's
+	void VerifyReplicatedLayoutHash() const;
+	
+	// Server: write the replicated override blob for the coming generation
+	void PublishReplicatedOverrides();
+	
+	// One group of the override blob (RoomOverrideSerialization::EOverrideGroup), and the DungeonManager seals
+	void SerializeOverrideGroup(FArchive& Ar, int32 Group);
+	void SerializeSealedDoors(FArchive& Ar);
+	
+	// Record the override groups as loaded, so only runtime changes are replicated
+	void CaptureOverrideBaseline();
+	uint32 HashOverrideGroup(int32 Group);
+	
+	// Override groups that differ (or have differed) from the baseline, or all of them for rooms not saved in the map
+	uint8 GetChangedOverrideGroups();
+	
+	// Hash every queued instance transform and custom data (quantized, meshes in stable path order)
+	// Taken from the queue rather than the HISMs so it's the same with per-room and shared instances
+	uint64 ComputeLayoutHash() const;
+	
+	// Hash of every solver input (generator version, seed, overrides, data asset content) - the layout cache key
+	uint64 ComputeLayoutCacheKey();
+	
+	// Override used to monitor changes in the Details Panel (bGenerateRoom button, preview + debounced regeneration)
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 	
-	// --- Core Generation Functions ---
-
-	// Selects one FMeshPlacementInfo struct based on placement weights
-	const FMeshPlacementInfo* SelectWeightedMesh(const TArray<FMeshPlacementInfo>& MeshPool, FRandomStream& Stream);
+	// Editor: solve the layout and show it on the debug grid without building any instances
+	void PreviewLayout();
 	
-	// Expands all ForcedEmptyRegions into individual cell coordinates
-	// Combines with ForcedEmptyFloorCells and returns a complete list
-	TArray<FIntPoint> ExpandForcedEmptyRegions() const;
+	// Editor: (re)start the debounce timer for a full RegenerateRoom
+	void ScheduleRegeneration();
 	
-	// UFUNCTION to be called by the DungeonManager (or designer in editor)
-	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Generation")
-	void RegenerateRoom();
+	// Editor: cancel a pending debounced regeneration
+	void CancelScheduledRegeneration();
+	
+	// --- Core Generation Functions ---
+
+	// Builds the forced-empty mask of the room: the ShapePreset's cached mask, OR'd with
+	// ForcedEmptyRegions and ForcedEmptyFloorCells
+	void BuildForcedEmptyMask(FRoomShapeMask& OutMask) const;
 	
 	// Logic for clearing and resetting all HISM components
 	void ClearAndResetComponents();
 	
 	// Logic for getting or creating the HISM component for a given mesh
-	UHierarchicalInstancedStaticMeshComponent* GetOrCreateHISM(UStaticMesh* Mesh);
+	UHierarchicalInstancedStaticMeshComponent* GetOrCreateHISM(UStaticMesh* Mesh, bool bClutter = false);
+	
+	// --- Layout Solve / Build ---
+	
+	// Load CurrentLayout from the layout cache or solve (and store) it - returns true on a cache hit
+	bool SolveOrLoadLayout();
+	
+	// Run all solver passes (floor, walls and doors, ceiling) and record the result into CurrentLayout
+	// Only grid state and layout records are produced - no components are touched
+	void SolveLayout();
+	
+	// Decode a layout straight into per-mesh instance arrays and upload them (walls stacks, corners and door frames are derived here)
+	bool BuildFromLayout(const FRoomLayout& Layout);
+	
+	// Resolve the layout's door records to door data and loaded frames (OutFrames is index-aligned with OutDoors).
+	// Procedural doors come from the compiled door tables; FixedDoorLocations is rebuilt from them in procedural mode.
+	void ResolveLayoutDoors(const FRoomLayout& Layout, TArray<FFixedDoorLocation>& OutDoors, TArray<FCompiledDoorFrame>& OutFrames);
+	
+	// Queue an instance for the batched upload at the end of BuildFromLayout
+	// CustomData: per-instance custom data of the mesh variant (empty for plain meshes)
+	void QueueInstance(UStaticMesh* Mesh, const FTransform& Transform, TConstArrayView<float> CustomData = TConstArrayView<float>());
+	
+	// Queue a floor clutter instance (own instance buffers: no collision, no navigation, ClutterCullDistance)
+	void QueueClutterInstance(UStaticMesh* Mesh, const FTransform& Transform, TConstArrayView<float> CustomData = TConstArrayView<float>());
+	
+	// Upload all queued instances (one AddInstances call per mesh, then the variants' custom data)
+	// Goes to the shared instance manager when one is set, otherwise to this room's HISMs
+	void FlushQueuedInstances();
+	
+	// Upload one instance queue (room geometry or clutter) and empty it
+	void FlushInstanceQueue(TMap<UStaticMesh*, FQueuedInstanceBatch>& Queue, bool bClutter);
+	
+	// Cull distance of the clutter instances (FloorData->ClutterCullDistance, never beyond the room's own)
+	float GetClutterCullDistance() const;
+	
+	// Return this room's instances to the shared instance manager
+	void ReleaseSharedInstances();
+	
+	// Local-space wall run boxes (one per contiguous base wall run) and greedy-merged floor rectangles
+	// Shared by the merged collision and the navigation geometry
+	void ComputeMergedPrimitives(TArray<FBox>& OutWallRuns, TArray<FBox>& OutFloorRects) const;
+	
+	// Build: derive merged box collision from PlacedBaseWalls and the floor cells (MergedPrimitives mode)
+	void BuildMergedCollision();
+	
+	// Build: fill the distant proxy from the wall runs and floor/ceiling rectangles (bGenerateProxy)
+	void BuildRoomProxy();
+	
+	// Build: hand the floor rectangles, door openings and wall runs to the nav geometry component (bEmitNavigationGeometry)
+	void BuildNavigationGeometry();
+	
+	// Enable collision box #Index at a local-space centre/extent, creating it if needed
+	void SetCollisionBox(int32 Index, const FVector& LocalCenter, const FVector& Extent);
+	
+	// Bounds/render state update, layout hash and debug draw after a build
+	void FinishGeneration();
+	
+	// Build: place a base wall module (index into CompiledWallStyle) on a boundary line and track it for Middle/Top stacking
+	void PlaceBaseWall(EWallEdge Edge, int32 Line, int32 StartCell, int32 ModuleIndex);
+	
+	// Build: place the frame mesh of a door and queue its doorway actor
+	void PlaceDoorFrame(const FFixedDoorLocation& DoorLoc, const FCompiledDoorFrame& Frame);
+	
+	// Acquire all queued doorways from the pool in one batch (server, game worlds only)
+	void SpawnPendingDoorways();
+	
+	// Return this room's doorways to the pool
+	void ReleaseDoorways();
 	
 	// Core grid packing logic (for floor and interior meshes)
 	void GenerateFloorAndInterior();
 	
-	// 1D wall placement logic using WallDataAsset
+	// 1D wall placement logic using WallDataAsset (solver: records walls and doors into the layout)
 	void GenerateWallsAndDoors();
 
 	void ExecuteForcedPlacements(FRandomStream& Stream);
 	
-	// Helper function for drawing the debug grid in the editor
+	// Refresh the debug grid component from the current grid state (rebuilds its lines only if something changed)
 	void DrawDebugGrid();
+	
+	// Footprint of the module referenced by a layout wall record (forced wall or compiled WallData module), 0 if it no longer exists
+	int32 GetLayoutWallFootprint(const FRoomLayoutWall& Wall, const FCompiledRoomData& Compiled) const;
 
 	// --- Wall Generation Helper Functions ---
 	
 	// Get all cell coordinates for a specific wall edge
 	TArray<FIntPoint> GetCellsForEdge(EWallEdge Edge) const;
 	
+	// Trace the wall runs and corners of the floor in InternalGridState (carved cells are void)
+	void TraceFloorBoundary(FRoomBoundary& OutBoundary) const;
+	
 	// Get the rotation for walls on a specific edge (all face inward)
 	FRotator GetWallRotationForEdge(EWallEdge Edge) const;
 	
-	// Calculate world position for a wall module on North/South edges
+	// Calculate the room-local position of a wall module on North/South edges
 	FVector CalculateNorthSouthWallPosition(int32 X, int32 StartY, float WallMeshLength, bool bIsNorthWall) const;
 	
-	// Calculate world position for a wall module on East/West edges
+	// Calculate the room-local position of a wall module on East/West edges
 	FVector CalculateEastWestWallPosition(int32 StartX, int32 Y, float WallMeshLength, bool bIsEastWall) const;
 	
-	// Calculate world position for a door (independent of wall positioning)
+	// Calculate the room-local position of a door (independent of wall positioning)
 	// Doors snap to floor edges using interior cells, not boundary cells
 	FVector CalculateDoorPosition(EWallEdge Edge, int32 StartCell, float DoorWidth) const;
 	
-	// Fill a wall segment with wall modules using bin packing
-	void FillWallSegment(EWallEdge Edge, int32 SegmentStart, int32 SegmentLength, FRandomStream& Stream);
+	// Rebuild DoorConnectionPoints from the placed doors and their frames (from ResolveLayoutDoors, skips sealed doors)
+	void BuildDoorConnectionPoints(TConstArrayView<FFixedDoorLocation> Doors, TConstArrayView<FCompiledDoorFrame> Frames);
+	
+	// Fill a wall segment on a boundary line (outer edge or carved edge) with wall modules using bin packing
+	void FillWallSegment(EWallEdge Edge, int32 Line, int32 SegmentStart, int32 SegmentLength, FRandomStream& Stream);
 	
 	// --- Middle & Top Wall Spawning ---
 	
-	// Spawn middle wall layers on top of base walls (socket-based stacking)
+	// Spawn middle wall layers on top of base walls (socket chains precompiled per module)
 	void SpawnMiddleWalls();
 	
-	// Spawn top wall layer on top of middle walls (socket-based stacking)
+	// Spawn top wall layer on top of middle walls (socket chains precompiled per module)
 	void SpawnTopWalls();
 	
-	// Helper: Get socket transform from a static mesh
-	bool GetSocketTransform(UStaticMesh* Mesh, FName SocketName, FVector& OutLocation, FRotator& OutRotation) const;
-	
 	// --- Corner Spawning ---
 	
-	// Spawn corner meshes at the 4 room corners (NW, NE, SW, SE)
+	// Spawn corner meshes at every traced boundary corner (the 4 room corners plus inner/outer corners of carved shapes)
 	void SpawnCorners();
 	
+	// --- Interior Furniture ---
+	
+	// Pack InteriorMeshPool furniture onto the free floor using a free-rectangle index, keeping the door
+	// approaches and a walkable path between the doors clear
+	void GenerateInteriorFurniture();
+	
+	// --- Floor Clutter ---
+	
+	// Scatter ClutterMeshPool over the free floor as blue noise (Poisson disk over a background grid, linear in the room area)
+	void GenerateClutter();
+	
+	// Set the interior cells in front of every placed door, Depth cells deep (index Y * GridSize.X + X)
+	void MarkDoorApproachCells(TBitArray<>& Mask, int32 Depth) const;
+	
 	// --- Ceiling Generation ---
 	
 	// Generate ceiling tiles covering the entire room grid
@@ -215,9 +666,10 @@ protected:
 	
 	// --- Door Variety Helper Functions (Hybrid System) ---
 	
-	// Select a random door from the RoomData's DoorStylePool using weighted selection
-	// Returns nullptr if pool is empty
-	UDoorData* SelectRandomDoorFromPool(FRandomStream& Stream) const;
+	// Select a random door from the RoomData's DoorStylePool using weighted selection,
+	// among the doors whose footprint fits in MaxFootprint cells
+	// Returns nullptr if no door fits (or the pool is empty)
+	UDoorData* SelectRandomDoorFromPool(FRandomStream& Stream, int32 MaxFootprint) const;
 	
 	// Check if a door of given footprint can fit at the specified location
 	// Returns true if there's enough space and no overlap with existing doors
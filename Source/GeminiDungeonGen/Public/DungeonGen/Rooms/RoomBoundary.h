@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/Grid/GridData.h"
+
+// Quadrant around a grid vertex (same order as the WallData corner offsets: SW, SE, NE, NW)
+enum class ERoomCornerQuadrant : uint8
+{
+	SouthWest = 0,	// -X, -Y of the vertex
+	SouthEast = 1,	// -X, +Y
+	NorthEast = 2,	// +X, +Y
+	NorthWest = 3	// +X, -Y
+};
+
+// Straight run of floor cell sides facing a void (outside the grid or a carved cell)
+struct FRoomBoundaryRun
+{
+	EWallEdge Edge = EWallEdge::North;	// Side of the floor the void is on (the wall faces back into the room)
+	int32 Line = 0;		// Void cell coordinate across the edge (X for North/South, Y for East/West)
+	int32 Start = 0;	// First cell along the edge (Y for North/South, X for East/West)
+	int32 Length = 0;
+};
+
+// Convex (outer) or concave (inner) corner of the boundary at a grid vertex
+struct FRoomBoundaryCorner
+{
+	FIntPoint Vertex = FIntPoint::ZeroValue;	// Grid vertex in cells (0..GridSize inclusive)
+	ERoomCornerQuadrant Quadrant = ERoomCornerQuadrant::SouthWest;	// Void quadrant the corner piece sits in
+	bool bInner = false;
+};
+
+/**
+ * Room Boundary - every wall run and corner of a room's floor mask
+ *
+ * The floor mask is the solved grid minus the carved (forced-empty) cells, so L/T/U shapes get
+ * walls along their carved edges as well as the four outer edges. Runs come from one row-major
+ * sweep that extends open runs per column/row; corners come from a marching squares pass over
+ * the grid vertices. Both are linear in the number of cells.
+ *
+ * Walls of a run live in the void cells along Line (the same "outside" cells GetCellsForEdge
+ * returns for the outer edges: X = GridSize.X / -1 for North/South, Y = GridSize.Y / -1 for East/West).
+ */
+struct GEMINIDUNGEONGEN_API FRoomBoundary
+{
+	// Grouped by edge (North, South, East, West), in sweep order within an edge
+	TArray<FRoomBoundaryRun> Runs;
+	TArray<FRoomBoundaryCorner> Corners;
+
+	// Trace a floor mask (one bit per cell, row-major by Y, set = floor). Cells outside the grid are void.
+	void Trace(FIntPoint GridSize, const TBitArray<>& FloorMask);
+
+	void Reset() { Runs.Reset(); Corners.Reset(); }
+
+	SIZE_T GetAllocatedSize() const { return Runs.GetAllocatedSize() + Corners.GetAllocatedSize(); }
+
+	// Void cell line of an outer edge
+	static int32 GetOuterLine(EWallEdge Edge, FIntPoint GridSize)
+	{
+		switch (Edge)
+		{
+			case EWallEdge::North: return GridSize.X;
+			case EWallEdge::East:  return GridSize.Y;
+			default:               return -1;
+		}
+	}
+
+	// Void cell holding the wall at Along on a line (GetCellsForEdge(Edge)[Along] for the outer line)
+	static FIntPoint GetWallCell(EWallEdge Edge, int32 Line, int32 Along)
+	{
+		return (Edge == EWallEdge::North || Edge == EWallEdge::South) ? FIntPoint(Line, Along) : FIntPoint(Along, Line);
+	}
+
+	// Number of cells along an edge (GridSize.Y for North/South, GridSize.X for East/West)
+	static int32 GetEdgeLength(EWallEdge Edge, FIntPoint GridSize)
+	{
+		return (Edge == EWallEdge::North || Edge == EWallEdge::South) ? GridSize.Y : GridSize.X;
+	}
+};
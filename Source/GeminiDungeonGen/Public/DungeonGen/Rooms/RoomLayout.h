@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/Grid/GridData.h"
+
+class UStaticMesh;
+
+// Layer of a grid-aligned placement (decides height and base rotation when the layout is decoded)
+enum class ERoomLayoutLayer : uint8
+{
+	Floor = 0,		// Floor tiles and gap fillers (Z = 0, yaw from the rotation quadrant)
+	Interior = 1,	// Forced and packed interior furniture (Z = 0, yaw from the rotation quadrant, may sit on floor tiles)
+	Ceiling = 2,	// Ceiling tiles (Z = CeilingHeight, CeilingData->CeilingRotation)
+	Clutter = 3		// Floor clutter (Z = 0, yaw from the rotation quadrant, own instance components)
+};
+
+// Each layer covers a cell at most once, so a layout never holds more than NumCells * RoomLayoutNumLayers placements
+static constexpr int32 RoomLayoutNumLayers = 4;
+
+// Where the DoorData of a door record comes from
+enum class ERoomLayoutDoorSource : uint8
+{
+	FixedLocation = 0,	// Index into AMasterRoom::FixedDoorLocations (designer-placed door)
+	DoorStyle = 1,		// RoomData->DoorStyleData itself (procedural, single door mode)
+	DoorStylePool = 2	// Index into RoomData->DoorStyleData->DoorStylePool (procedural)
+};
+
+// Grid-aligned mesh placement: (mesh index, cell, footprint, rotation quadrant) - 9 bytes encoded
+struct FRoomLayoutPlacement
+{
+	uint16 MeshIndex = 0;
+	uint16 CellX = 0;
+	uint16 CellY = 0;
+	uint8 FootprintX = 1;	// Rotated footprint in cells
+	uint8 FootprintY = 1;
+	uint8 Quadrant = 0;		// Yaw / 90 (0-3)
+	ERoomLayoutLayer Layer = ERoomLayoutLayer::Floor;
+};
+
+// Base wall module on a boundary line - the Middle/Top stack and all transforms are derived on decode (7 bytes encoded)
+struct FRoomLayoutWall
+{
+	EWallEdge Edge = EWallEdge::North;
+	bool bForced = false;	// ModuleIndex indexes AMasterRoom::ForcedWalls instead of WallData->AvailableWallModules
+	int16 Line = 0;			// Void cell line across the edge (FRoomBoundary: GridSize / -1 for the outer edges)
+	uint16 StartCell = 0;
+	uint16 ModuleIndex = 0;
+};
+
+// Door on an edge: (edge, cell, pool index) (5 bytes encoded)
+struct FRoomLayoutDoor
+{
+	EWallEdge Edge = EWallEdge::North;
+	ERoomLayoutDoorSource Source = ERoomLayoutDoorSource::FixedLocation;
+	uint16 StartCell = 0;
+	uint16 Index = 0;
+};
+
+/**
+ * Room Layout - compact, versioned description of a generated room
+ * 
+ * Produced by the MasterRoom layout solver and decoded straight into per-mesh instance arrays.
+ * This is the common format for disk caching, save games and replication.
+ * 
+ * ENCODING (little endian, see Serialize):
+ * - Header: magic, version, grid size, seed
+ * - Mesh table: soft object path + custom data floats per entry (placements reference entries by index)
+ * - Placements: 9 bytes each (mesh, cell, footprint, quadrant | layer)
+ * - Walls: 7 bytes each (edge | forced, line, start cell, module index)
+ * - Doors: 5 bytes each (edge | source, start cell, index)
+ * - Cell states: 4 bits per cell
+ * 
+ * Wall module and door indices refer to the room's data assets and designer overrides,
+ * so a layout must be decoded against the same inputs it was solved from.
+ */
+struct GEMINIDUNGEONGEN_API FRoomLayout
+{
+	// 'RLYT'
+	static constexpr uint32 Magic = 0x54594C52;
+
+	// Bumped whenever the encoding changes (old data is rejected, never misread)
+	static constexpr uint16 Version = 4;
+
+	// Largest grid side accepted on decode (bounds every count derived from the grid size)
+	static constexpr int32 MaxGridSize = 1024;
+
+	FIntPoint GridSize = FIntPoint::ZeroValue;
+	int32 Seed = 0;
+
+	TArray<FSoftObjectPath> Meshes;
+
+	// Per-instance custom data of each mesh table entry (index-aligned with Meshes, usually empty)
+	// A mesh appears once per distinct custom data set - its variants still build into one HISM
+	TArray<TArray<float>> MeshCustomData;
+	TArray<FRoomLayoutPlacement> Placements;
+	TArray<FRoomLayoutWall> Walls;
+	TArray<FRoomLayoutDoor> Doors;
+
+	// Final InternalGridState of the solver (GridSize.X * GridSize.Y, row-major by Y)
+	TArray<EGridCellType> CellStates;
+
+	// Clear all records and start a new layout
+	void Reset(FIntPoint InGridSize, int32 InSeed);
+
+	// Returns the mesh table index for a mesh variant (mesh + custom data), adding it if needed
+	uint16 AddMesh(UStaticMesh* Mesh, TConstArrayView<float> CustomData = TConstArrayView<float>());
+
+	// Record a grid-aligned placement (Yaw is snapped to the nearest 90 degree quadrant)
+	void AddPlacement(UStaticMesh* Mesh, FIntPoint Cell, FIntPoint RotatedFootprint, float Yaw, ERoomLayoutLayer Layer,
+		TConstArrayView<float> CustomData = TConstArrayView<float>());
+
+	// Line is the void cell line the wall stands on (see FRoomBoundary::GetOuterLine for the outer edges)
+	void AddWall(EWallEdge Edge, int32 Line, int32 StartCell, int32 ModuleIndex, bool bForced);
+
+	void AddDoor(EWallEdge Edge, int32 StartCell, ERoomLayoutDoorSource Source, int32 Index);
+
+	// Symmetric binary serialization. Returns false (and sets the archive error) on bad magic/version or corrupt data.
+	// Loading validates every count against the bytes left and every record against the grid, so untrusted
+	// data (cache files, ApplyEncodedLayout) can't allocate unbounded memory or index past the grid.
+	bool Serialize(FArchive& Ar);
+
+	// Convenience wrappers around Serialize for byte buffers
+	void Encode(TArray<uint8>& OutBytes) const;
+	bool Decode(const TArray<uint8>& Bytes);
+
+	// Load every mesh in the table (index-aligned with Meshes, nullptr for meshes that failed to load)
+	void ResolveMeshes(TArray<UStaticMesh*>& OutMeshes) const;
+
+	// Number of placement, wall and door records (used for logging)
+	int32 GetNumRecords() const { return Placements.Num() + Walls.Num() + Doors.Num(); }
+
+	// Heap memory held by the record arrays and the mesh table (used for memory accounting)
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T Size = Meshes.GetAllocatedSize() + MeshCustomData.GetAllocatedSize() + Placements.GetAllocatedSize()
+			+ Walls.GetAllocatedSize() + Doors.GetAllocatedSize() + CellStates.GetAllocatedSize() + MeshLookup.GetAllocatedSize();
+		for (const TArray<float>& CustomData : MeshCustomData)
+		{
+			Size += CustomData.GetAllocatedSize();
+		}
+		return Size;
+	}
+
+private:
+	// Transient lookup used while recording (not serialized)
+	TMultiMap<UStaticMesh*, uint16> MeshLookup;
+};
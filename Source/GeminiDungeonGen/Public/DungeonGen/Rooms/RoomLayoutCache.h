@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FRoomLayout;
+
+/**
+ * Room Layout Cache - on-disk cache of solved room layouts
+ *
+ * A layout is fully determined by the room's inputs (data asset content, shape preset, seed and
+ * designer overrides), so it is stored under a 64-bit hash of those inputs. A cache hit skips the
+ * solver entirely and goes straight to BuildFromLayout (instance upload).
+ *
+ * STORAGE:
+ * - <Project>/Saved/DungeonLayoutCache/<Key>.rlyt (one encoded FRoomLayout per file)
+ * - Files are written to a temp file and moved into place, so a crash never leaves a torn entry
+ * - Corrupt or outdated entries fail to decode and are treated as a miss (and overwritten)
+ * - Bounded: the first store of a session deletes entries older than MaxEntryAgeDays, then the
+ *   least recently used ones past MaxEntries (a hit refreshes the entry's timestamp)
+ *
+ * KEY:
+ * - GeneratorVersion + FRoomLayout::Version
+ * - Content hash of every data asset the solver reads (all UPROPERTY values, exported as text)
+ * - Seed + override blob (AMasterRoom::SerializeGenerationOverrides), without the solved doors in procedural mode
+ */
+class GEMINIDUNGEONGEN_API FRoomLayoutCache
+{
+public:
+	// Bump whenever the solver output changes for the same inputs (invalidates every cached layout)
+	static constexpr uint32 GeneratorVersion = 7;
+
+	// Entries kept on disk (least recently used ones past this are deleted)
+	static constexpr int32 MaxEntries = 4096;
+
+	// Entries not used for this many days are deleted
+	static constexpr int32 MaxEntryAgeDays = 30;
+
+	// Directory holding the cache entries
+	static FString GetCacheDirectory();
+
+	// Hash every (non-transient) UPROPERTY of an object into Hash
+	// Object references are exported as paths, so the hash is stable across sessions and machines
+	static uint64 HashObjectProperties(const UObject* Object, uint64 Hash);
+
+	// Load the layout stored under Key. Returns false on a miss or an unreadable entry.
+	static bool Load(uint64 Key, FRoomLayout& OutLayout);
+
+	// Store a layout under Key (overwrites any existing entry)
+	static bool Store(uint64 Key, const FRoomLayout& Layout);
+
+	// Delete every cache entry
+	static void Clear();
+
+	// Delete stale entries and the least recently used ones past MaxEntries
+	static void Trim();
+
+private:
+	static FString GetEntryPath(uint64 Key);
+};
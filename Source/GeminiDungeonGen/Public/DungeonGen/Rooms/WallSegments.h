@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/Grid/GridData.h"
+
+class UStaticMesh;
+class URoomData;
+
+// A wall module with its meshes loaded and its stacking chain resolved (socket lookups done once per build)
+struct FCompiledWallModule
+{
+	UStaticMesh* BaseMesh = nullptr;
+	UStaticMesh* Middle1Mesh = nullptr;
+	UStaticMesh* Middle2Mesh = nullptr;	// Only stacked when Middle1Mesh exists
+	UStaticMesh* TopMesh = nullptr;
+	int32 Footprint = 1;
+
+	// Per-instance custom data of the module's variant (written to every layer)
+	TArray<float> CustomData;
+
+	// Layer transforms relative to the base wall instance (Layer = Relative * BaseTransform)
+	FTransform Middle1Relative = FTransform::Identity;
+	FTransform Middle2Relative = FTransform::Identity;
+	FTransform TopRelative = FTransform::Identity;
+};
+
+/**
+ * Compiled Wall Style - every wall module a room can place, flattened into one indexable array
+ *
+ * Indices [0, NumDataModules) are the compiled WallData->AvailableWallModules (FCompiledRoomData::WallModules),
+ * followed by the room's forced wall modules. Placed walls refer to modules by this index instead of
+ * pointing into the data asset's array (which dangles as soon as the asset is edited).
+ */
+struct FCompiledWallStyle
+{
+	TArray<FCompiledWallModule> Modules;
+	int32 NumDataModules = 0;
+
+	// Resolve every module's TopBackCenter socket chain. Data modules come from the room's compiled tables (meshes
+	// already loaded by GetCompiledData); forced walls are actor overrides and load their own meshes.
+	void Compile(URoomData& RoomData, const TArray<FForcedWallPlacement>& ForcedWalls);
+
+	void Reset() { Modules.Reset(); NumDataModules = 0; }
+
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T Size = Modules.GetAllocatedSize();
+		for (const FCompiledWallModule& Module : Modules)
+		{
+			Size += Module.CustomData.GetAllocatedSize();
+		}
+		return Size;
+	}
+
+	// Compiled index of a layout wall record (INDEX_NONE if the module no longer exists)
+	int32 GetModuleIndex(bool bForced, int32 ModuleIndex) const
+	{
+		const int32 Index = bForced ? NumDataModules + ModuleIndex : (ModuleIndex < NumDataModules ? ModuleIndex : INDEX_NONE);
+		return Modules.IsValidIndex(Index) ? Index : INDEX_NONE;
+	}
+};
+
+/**
+ * Placed Wall Segments - base wall segments of the current build as parallel arrays
+ *
+ * One entry per placed base wall; index i is the same segment in every array. The stacking
+ * passes (middle/top layers) and the merged primitive builder stream through these linearly.
+ */
+struct FPlacedWallSegments
+{
+	TArray<EWallEdge> Edges;
+	TArray<int32> Lines;			// Void cell line the segment stands on (see FRoomBoundaryRun::Line)
+	TArray<int32> StartCells;
+	TArray<int32> Lengths;			// Segment length in cells (module footprint)
+	TArray<int32> ModuleIndices;	// Into FCompiledWallStyle::Modules
+	TArray<FTransform> BaseTransforms;
+
+	int32 Num() const { return Edges.Num(); }
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Edges.GetAllocatedSize() + Lines.GetAllocatedSize() + StartCells.GetAllocatedSize() + Lengths.GetAllocatedSize()
+			+ ModuleIndices.GetAllocatedSize() + BaseTransforms.GetAllocatedSize();
+	}
+
+	void Add(EWallEdge Edge, int32 Line, int32 StartCell, int32 Length, int32 ModuleIndex, const FTransform& BaseTransform)
+	{
+		Edges.Add(Edge);
+		Lines.Add(Line);
+		StartCells.Add(StartCell);
+		Lengths.Add(Length);
+		ModuleIndices.Add(ModuleIndex);
+		BaseTransforms.Add(BaseTransform);
+	}
+
+	void Reset()
+	{
+		Edges.Reset();
+		Lines.Reset();
+		StartCells.Reset();
+		Lengths.Reset();
+		ModuleIndices.Reset();
+		BaseTransforms.Reset();
+	}
+
+	void Empty()
+	{
+		Edges.Empty();
+		Lines.Empty();
+		StartCells.Empty();
+		Lengths.Empty();
+		ModuleIndices.Empty();
+		BaseTransforms.Empty();
+	}
+};
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "DungeonMemory.generated.h"
+
+class UActorComponent;
+
+/**
+ * Dungeon Memory - Low Level Memory tracker tags and per-room memory accounting
+ *
+ * LLM TAGS (visible with -llm / stat LLMFULL / LLM csv captures, all under "DungeonGen"):
+ * - DungeonGen_Layout: solver passes, grid state, occupancy, layout records, placed wall segments
+ * - DungeonGen_Instances: HISM components and instance uploads (per-instance data, cluster trees), distant proxy
+ * - DungeonGen_Collision: merged collision boxes and their physics bodies
+ * - DungeonGen_Navigation: nav geometry component, pathfinding snapshots
+ * - DungeonGen_Debug: editor debug grid line batches
+ * - DungeonGen: everything else the generator allocates (doorways, visibility cells, ...)
+ * Render proxies are created later on the render thread and are tracked by the engine's own tags.
+ *
+ * ROOM SUMMARY:
+ * AMasterRoom::GetMemoryStats() measures one generated room (containers by allocated size, components
+ * by their exclusive resource size, which includes instance buffers, cluster trees and physics bodies
+ * but not the shared meshes). "Dungeon.MemoryReport" logs every room in the world plus the total.
+ */
+LLM_DECLARE_TAG_API(DungeonGen, GEMINIDUNGEONGEN_API);
+LLM_DECLARE_TAG_API(DungeonGen_Layout, GEMINIDUNGEONGEN_API);
+LLM_DECLARE_TAG_API(DungeonGen_Instances, GEMINIDUNGEONGEN_API);
+LLM_DECLARE_TAG_API(DungeonGen_Collision, GEMINIDUNGEONGEN_API);
+LLM_DECLARE_TAG_API(DungeonGen_Navigation, GEMINIDUNGEONGEN_API);
+LLM_DECLARE_TAG_API(DungeonGen_Debug, GEMINIDUNGEONGEN_API);
+
+// Memory held by one generated room (bytes), broken down by subsystem
+USTRUCT(BlueprintType)
+struct GEMINIDUNGEONGEN_API FRoomMemoryStats
+{
+	GENERATED_BODY()
+
+	// InternalGridState
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Memory")
+	int64 GridStateBytes = 0;
+
+	// OccupancyGrid (walls, doors and doorway ring cells)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Memory")
+	int64 OccupancyGridBytes = 0;
+
+	// PlacedBaseWalls + the compiled wall style
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Memory")
+	int64 WallSegmentBytes = 0;
+
+	// Layout records, door connection points and other per-room bookkeeping
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Memory")
+	int64 LayoutBytes = 0;
+
+	// HISM components: per-instance data, cluster trees, instance bodies
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Memory")
+	int64 InstanceBytes = 0;
+
+	// Merged collision boxes
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Memory")
+	int64 CollisionBytes = 0;
+
+	// Distant proxy component
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Memory")
+	int64 ProxyBytes = 0;
+
+	// Nav geometry component
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Memory")
+	int64 NavigationBytes = 0;
+
+	// Editor debug grid
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Memory")
+	int64 DebugBytes = 0;
+
+	// Number of HISM components and the instances they hold
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Memory")
+	int32 NumInstanceComponents = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Memory")
+	int32 NumInstances = 0;
+
+	// Sum of every byte count above
+	int64 GetTotalBytes() const
+	{
+		return GridStateBytes + OccupancyGridBytes + WallSegmentBytes + LayoutBytes + InstanceBytes
+			+ CollisionBytes + ProxyBytes + NavigationBytes + DebugBytes;
+	}
+
+	FRoomMemoryStats& operator+=(const FRoomMemoryStats& Other);
+
+	// One-line summary (KB per category), used by the memory report
+	FString ToString() const;
+};
+
+namespace DungeonMemory
+{
+	// Exclusive resource size of a component (its own buffers and bodies, not the assets it references)
+	GEMINIDUNGEONGEN_API int64 GetComponentBytes(UActorComponent* Component);
+}
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Data/Grid/GridData.h"
+#include "DungeonVisibility.generated.h"
+
+class AMasterRoom;
+
+// A door opening as a world-space quad (built by AMasterRoom from its placed doors)
+struct GEMINIDUNGEONGEN_API FDungeonPortalQuad
+{
+	FVector Corners[4];	// Wound around the opening (bottom left, bottom right, top right, top left)
+	FVector Center = FVector::ZeroVector;
+	FVector Normal = FVector::ForwardVector;	// Pointing out of the owning room
+
+	// Connection point of the door (portals link exactly where the DungeonManager connects doors)
+	FDoorConnectionPoint Connection;
+
+	// The opening of a connection point: Footprint cells wide, centred on the point (on the room boundary plane),
+	// OpeningHeight tall along WorldUp
+	static FDungeonPortalQuad FromConnectionPoint(const FDoorConnectionPoint& Point, const FVector& WorldUp, float OpeningHeight);
+};
+
+// A portal of a visibility cell, linked to the facing portal of the neighbouring room
+struct FDungeonVisibilityPortal
+{
+	FDungeonPortalQuad Quad;
+	int32 LinkedRoom = INDEX_NONE;
+	int32 LinkedPortal = INDEX_NONE;
+};
+
+// One room as a visibility cell
+struct FDungeonVisibilityCell
+{
+	TWeakObjectPtr<AMasterRoom> Room;
+	FTransform Transform;
+	FBox LocalBounds = FBox(ForceInit);	// Grid plus the wall boundary ring (room local space)
+	TArray<FDungeonVisibilityPortal> Portals;
+
+	// State last applied to the room's HISMs
+	bool bVisible = true;
+};
+
+/**
+ * Dungeon Visibility - portal graph culling for generated rooms
+ *
+ * Rooms are enclosed cells joined through door openings, so a room can only be seen through a
+ * chain of portals from the camera's room. Each frame (driven by the DungeonManager):
+ * 1. Find the room(s) containing each local player's camera - these are always visible
+ * 2. Walk the portal graph: a portal is entered if its quad is inside the current frustum, and the
+ *    frustum is narrowed to the planes through the eye and the portal edges before recursing
+ * 3. Hide the HISMs of every room no chain reached, show the rest (only rooms whose state changed are touched)
+ *
+ * Portals are linked with DungeonConnection::PairConnectionPoints, the rule the DungeonManager connects
+ * doors with, so clients cull without the server's door connection graph and still agree with it.
+ * With no camera inside a room, everything is shown.
+ */
+UCLASS()
+class GEMINIDUNGEONGEN_API UDungeonVisibilitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Rendering decisions only make sense in game worlds (the editor viewport is never culled)
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// Rebuild a room's cell and portals (called by AMasterRoom after every generation pass)
+	void UpdateRoom(AMasterRoom* Room);
+
+	// Forget a room (called when the room leaves play)
+	void RemoveRoom(AMasterRoom* Room);
+
+	// Run one visibility pass from the local players' cameras
+	// MaxPortalDepth bounds the portal chain length - rooms past it are conservatively shown
+	void UpdateVisibility(int32 MaxPortalDepth);
+
+	// Show every room (culling disabled)
+	void ShowAllRooms();
+
+	// Bucket size (cm) used to pair portals - set by the DungeonManager to its ConnectionQuantization
+	void SetConnectionQuantization(float InQuantization);
+
+	// Number of rooms hidden by the last pass
+	UFUNCTION(BlueprintPure, Category = "Dungeon|Visibility")
+	int32 GetNumCulledRooms() const { return NumCulledRooms; }
+
+private:
+	// Pair portals whose doors the DungeonManager would connect
+	void ResolvePortalLinks();
+
+	// Depth-first portal walk from RoomIndex (EntryPortal is the portal we came in through, skipped)
+	void TraversePortals(int32 RoomIndex, int32 EntryPortal, const FVector& Eye, const TArray<FPlane>& Frustum,
+		int32 Depth, int32 MaxDepth, TBitArray<>& OnPath, TBitArray<>& OutVisible, int32& Budget) const;
+
+	// Apply the visible set to the rooms whose state changed
+	void ApplyVisibility(const TBitArray<>& Visible);
+
+	TArray<FDungeonVisibilityCell> Cells;
+	TMap<TObjectKey<AMasterRoom>, int32> CellIndices;
+
+	int32 NumCulledRooms = 0;
+
+	float ConnectionQuantization = CELL_SIZE / 2.0f;
+};